@@ -339,10 +339,22 @@ mpc_data dolfinx_mpc::create_contact_slip_condition(
     std::shared_ptr<dolfinx::fem::FunctionSpace> V,
     dolfinx::mesh::MeshTags<std::int32_t> meshtags, std::int32_t slave_marker,
     std::int32_t master_marker,
-    std::shared_ptr<dolfinx::fem::Function<PetscScalar>> nh, const double eps2)
+    std::shared_ptr<dolfinx::fem::Function<PetscScalar>> nh, const double eps2,
+    const bool shared_memory, const bool vertex_masters)
 {
   dolfinx::common::Timer timer("~MPC: Create slip constraint");
 
+  // Evaluate basis functions of V (or only its vertex basis functions) at
+  // a set of points
+  auto evaluate_basis
+      = [&V, vertex_masters](const xt::xtensor<double, 2>& x,
+                             std::span<const std::int32_t> cells)
+  {
+    return vertex_masters
+               ? dolfinx_mpc::evaluate_vertex_basis_functions(*V, x, cells)
+               : dolfinx_mpc::evaluate_basis_functions(*V, x, cells);
+  };
+
   MPI_Comm comm = meshtags.mesh()->comm();
   int rank = -1;
   MPI_Comm_rank(comm, &rank);
@@ -445,8 +457,7 @@ mpc_data dolfinx_mpc::create_contact_slip_condition(
         = dolfinx_mpc::find_local_collisions(*mesh, bb_tree, slave_coordinates,
                                              eps2);
     xt::xtensor<double, 3> tabulated_basis_values
-        = dolfinx_mpc::evaluate_basis_functions(*V, slave_coordinates,
-                                                local_cell_collisions);
+        = evaluate_basis(slave_coordinates, local_cell_collisions);
 
     mpc_master_local = compute_master_contributions(
         local_rems, local_cell_collisions, normals, V, tabulated_basis_values);
@@ -519,51 +530,102 @@ mpc_data dolfinx_mpc::create_contact_slip_condition(
   std::partial_sum(num_slaves_recv.begin(), num_slaves_recv.end(),
                    disp.begin() + 1);
 
-  // Send data to neighbors and receive data
-  std::vector<std::int32_t> recv_rems(disp.back());
-  MPI_Neighbor_allgatherv(send_rems.data(), (int)send_rems.size(),
-                          dolfinx::MPI::mpi_type<std::int32_t>(),
-                          recv_rems.data(), num_slaves_recv.data(), disp.data(),
-                          dolfinx::MPI::mpi_type<std::int32_t>(),
-                          neighborhood_comms[0]);
-
-  // Multiply recv size by three to accommodate vector coordinates and
-  // function data
-  std::vector<std::int32_t> num_slaves_recv3;
-  num_slaves_recv3.reserve(indegree);
-  std::transform(num_slaves_recv.begin(), num_slaves_recv.end(),
-                 std::back_inserter(num_slaves_recv3),
-                 [](std::int32_t num_slaves) { return 3 * num_slaves; });
-  std::vector<int> disp3(indegree + 1, 0);
-  std::partial_sum(num_slaves_recv3.begin(), num_slaves_recv3.end(),
-                   disp3.begin() + 1);
-
-  // Send slave normal and coordinate to neighbors
-  xt::xtensor<double, 2> recv_coords({std::size_t(disp.back()), 3});
-  MPI_Neighbor_allgatherv(coordinates_send.data(), (int)coordinates_send.size(),
-                          dolfinx::MPI::mpi_type<double>(), recv_coords.data(),
-                          num_slaves_recv3.data(), disp3.data(),
-                          dolfinx::MPI::mpi_type<double>(),
-                          neighborhood_comms[0]);
-  xt::xtensor<PetscScalar, 2> slave_normals({std::size_t(disp.back()), 3});
-  MPI_Neighbor_allgatherv(normals_send.data(), (int)normals_send.size(),
-                          dolfinx::MPI::mpi_type<PetscScalar>(),
-                          slave_normals.data(), num_slaves_recv3.data(),
-                          disp3.data(), dolfinx::MPI::mpi_type<PetscScalar>(),
-                          neighborhood_comms[0]);
-
-  // Compute off-process contributions
   mpc_data remote_data;
+  if (shared_memory)
+  {
+    // Store the remote slave data once per shared-memory node, and compute
+    // the contributions for one source process at a time
+    const std::vector<int> src_ranks
+        = dolfinx_mpc::compute_neighborhood(neighborhood_comms[0]).first;
+    dolfinx_mpc::NodeSharedArray<std::int32_t> shared_rems(comm, src_ranks,
+                                                           send_rems);
+    dolfinx_mpc::NodeSharedArray<double> shared_coords(
+        comm, src_ranks,
+        std::span<const double>(coordinates_send.data(),
+                                coordinates_send.size()));
+    dolfinx_mpc::NodeSharedArray<PetscScalar> shared_normals(
+        comm, src_ranks,
+        std::span<const PetscScalar>(normals_send.data(),
+                                     normals_send.size()));
+    remote_data.offsets.push_back(0);
+    for (int src : src_ranks)
+    {
+      std::span<const std::int32_t> src_rems = shared_rems.links(src);
+      std::span<const double> coords = shared_coords.links(src);
+      xt::xtensor<double, 2> src_coords({src_rems.size(), 3});
+      std::copy(coords.begin(), coords.end(), src_coords.begin());
+      std::span<const PetscScalar> normals_src = shared_normals.links(src);
+      xt::xtensor<PetscScalar, 2> src_normals({src_rems.size(), 3});
+      std::copy(normals_src.begin(), normals_src.end(), src_normals.begin());
+
+      std::vector<std::int32_t> src_cell_collisions
+          = dolfinx_mpc::find_local_collisions(*mesh, bb_tree, src_coords,
+                                               eps2);
+      xt::xtensor<double, 3> src_tabulated_basis_values
+          = evaluate_basis(src_coords, src_cell_collisions);
+      mpc_data src_data = compute_master_contributions(
+          src_rems, src_cell_collisions, src_normals, V,
+          src_tabulated_basis_values);
+
+      // Append contributions
+      const auto offset = (std::int32_t)remote_data.masters.size();
+      std::transform(std::next(src_data.offsets.begin()),
+                     src_data.offsets.end(),
+                     std::back_inserter(remote_data.offsets),
+                     [offset](auto o) { return o + offset; });
+      remote_data.masters.insert(remote_data.masters.end(),
+                                 src_data.masters.begin(),
+                                 src_data.masters.end());
+      remote_data.coeffs.insert(remote_data.coeffs.end(),
+                                src_data.coeffs.begin(), src_data.coeffs.end());
+      remote_data.owners.insert(remote_data.owners.end(),
+                                src_data.owners.begin(), src_data.owners.end());
+    }
+  }
+  else
   {
+    // Send data to neighbors and receive data
+    std::vector<std::int32_t> recv_rems(disp.back());
+    MPI_Neighbor_allgatherv(send_rems.data(), (int)send_rems.size(),
+                            dolfinx::MPI::mpi_type<std::int32_t>(),
+                            recv_rems.data(), num_slaves_recv.data(),
+                            disp.data(), dolfinx::MPI::mpi_type<std::int32_t>(),
+                            neighborhood_comms[0]);
+
+    // Multiply recv size by three to accommodate vector coordinates and
+    // function data
+    std::vector<std::int32_t> num_slaves_recv3;
+    num_slaves_recv3.reserve(indegree);
+    std::transform(num_slaves_recv.begin(), num_slaves_recv.end(),
+                   std::back_inserter(num_slaves_recv3),
+                   [](std::int32_t num_slaves) { return 3 * num_slaves; });
+    std::vector<int> disp3(indegree + 1, 0);
+    std::partial_sum(num_slaves_recv3.begin(), num_slaves_recv3.end(),
+                     disp3.begin() + 1);
+
+    // Send slave normal and coordinate to neighbors
+    xt::xtensor<double, 2> recv_coords({std::size_t(disp.back()), 3});
+    MPI_Neighbor_allgatherv(
+        coordinates_send.data(), (int)coordinates_send.size(),
+        dolfinx::MPI::mpi_type<double>(), recv_coords.data(),
+        num_slaves_recv3.data(), disp3.data(),
+        dolfinx::MPI::mpi_type<double>(), neighborhood_comms[0]);
+    xt::xtensor<PetscScalar, 2> slave_normals({std::size_t(disp.back()), 3});
+    MPI_Neighbor_allgatherv(normals_send.data(), (int)normals_send.size(),
+                            dolfinx::MPI::mpi_type<PetscScalar>(),
+                            slave_normals.data(), num_slaves_recv3.data(),
+                            disp3.data(), dolfinx::MPI::mpi_type<PetscScalar>(),
+                            neighborhood_comms[0]);
+
+    // Compute off-process contributions
     std::vector<std::int32_t> remote_cell_collisions
         = dolfinx_mpc::find_local_collisions(*mesh, bb_tree, recv_coords, eps2);
     xt::xtensor<double, 3> recv_tabulated_basis_values
-        = dolfinx_mpc::evaluate_basis_functions(*V, recv_coords,
-                                                remote_cell_collisions);
-
-    remote_data = compute_master_contributions(
-        recv_rems, remote_cell_collisions, slave_normals, V,
-        recv_tabulated_basis_values);
+        = evaluate_basis(recv_coords, remote_cell_collisions);
+    remote_data = compute_master_contributions(recv_rems,
+                                               remote_cell_collisions,
+                                               slave_normals, V,
+                                               recv_tabulated_basis_values);
   }
 
   // Get info about reverse communicator
@@ -851,10 +913,22 @@ mpc_data dolfinx_mpc::create_contact_slip_condition(
 mpc_data dolfinx_mpc::create_contact_inelastic_condition(
     std::shared_ptr<dolfinx::fem::FunctionSpace> V,
     dolfinx::mesh::MeshTags<std::int32_t> meshtags, std::int32_t slave_marker,
-    std::int32_t master_marker, const double eps2)
+    std::int32_t master_marker, const double eps2, const bool shared_memory,
+    const bool vertex_masters)
 {
   dolfinx::common::Timer timer("~MPC: Inelastic condition");
 
+  // Evaluate basis functions of V (or only its vertex basis functions) at
+  // a set of points
+  auto evaluate_basis
+      = [&V, vertex_masters](const xt::xtensor<double, 2>& x,
+                             std::span<const std::int32_t> cells)
+  {
+    return vertex_masters
+               ? dolfinx_mpc::evaluate_vertex_basis_functions(*V, x, cells)
+               : dolfinx_mpc::evaluate_basis_functions(*V, x, cells);
+  };
+
   MPI_Comm comm = meshtags.mesh()->comm();
   int rank = -1;
   MPI_Comm_rank(comm, &rank);
@@ -950,8 +1024,7 @@ mpc_data dolfinx_mpc::create_contact_inelastic_condition(
         = dolfinx_mpc::find_local_collisions(*V->mesh(), bb_tree,
                                              slave_coordinates, eps2);
     xt::xtensor<double, 3> tabulated_basis_values
-        = dolfinx_mpc::evaluate_basis_functions(*V, slave_coordinates,
-                                                colliding_cells);
+        = evaluate_basis(slave_coordinates, colliding_cells);
 
     // Work arrays for loop
     std::vector<std::int64_t> master_block_global;
@@ -1096,30 +1169,6 @@ mpc_data dolfinx_mpc::create_contact_inelastic_condition(
   std::partial_sum(num_slave_blocks.begin(), num_slave_blocks.end(),
                    disp.begin() + 1);
 
-  // Send data to neighbors and receive data
-  std::vector<std::int64_t> remote_slave_blocks(disp.back());
-  MPI_Neighbor_allgatherv(
-      blocks_wo_local_collision.data(), num_colliding_blocks,
-      dolfinx::MPI::mpi_type<std::int64_t>(), remote_slave_blocks.data(),
-      num_slave_blocks.data(), disp.data(),
-      dolfinx::MPI::mpi_type<std::int64_t>(), neighborhood_comms[0]);
-
-  // Multiply recv size by three to accommodate block coordinates
-  std::vector<std::int32_t> num_block_coordinates(indegree);
-  for (std::size_t i = 0; i < num_slave_blocks.size(); ++i)
-    num_block_coordinates[i] = num_slave_blocks[i] * 3;
-  std::vector<int> coordinate_disp(indegree + 1, 0);
-  std::partial_sum(num_block_coordinates.begin(), num_block_coordinates.end(),
-                   coordinate_disp.begin() + 1);
-
-  // Send slave coordinates to neighbors
-  xt::xtensor<double, 2> recv_coords({std::size_t(disp.back()), 3});
-  MPI_Neighbor_allgatherv(
-      distribute_coordinates.data(), (int)distribute_coordinates.size(),
-      dolfinx::MPI::mpi_type<double>(), recv_coords.data(),
-      num_block_coordinates.data(), coordinate_disp.data(),
-      dolfinx::MPI::mpi_type<double>(), neighborhood_comms[0]);
-
   // Vector for processes with slaves, mapping slaves with
   // collision on this process
   std::vector<std::vector<std::int64_t>> collision_slaves(indegree);
@@ -1132,72 +1181,139 @@ mpc_data dolfinx_mpc::create_contact_inelastic_condition(
   std::vector<std::map<std::int64_t, std::vector<std::int32_t>>>
       collision_block_offsets(indegree);
   {
-    std::vector<std::int32_t> remote_cell_collisions
-        = dolfinx_mpc::find_local_collisions(*V->mesh(), bb_tree, recv_coords,
-                                             eps2);
-    xt::xtensor<double, 3> remote_tabulated_basis_values
-        = dolfinx_mpc::evaluate_basis_functions(*V, recv_coords,
-                                                remote_cell_collisions);
-
     // TODO: Rework this so it is the same as the code on owning process.
     // Preferably get rid of all the std::map's
     // Work arrays for loop
     std::vector<std::int32_t> r_master;
     std::vector<PetscScalar> r_coeff;
     std::vector<std::int64_t> remote_master_global;
-    for (std::int32_t i = 0; i < indegree; ++i)
+
+    // Add the master contributions of a slave block from the ith neighbor
+    // colliding with a cell on this process
+    auto add_remote_block
+        = [&](std::int32_t i, std::int64_t slave_loc, std::int32_t cell,
+              const auto& basis_values)
     {
-      for (std::int32_t j = disp[i]; j < disp[i + 1]; ++j)
+      // Initialize number of masters for each incoming slave to 0
+      collision_block_offsets[i][slave_loc]
+          = std::vector<std::int32_t>(tdim, 0);
+      if (cell == -1)
+        return;
+      auto cell_blocks = V->dofmap()->cell_dofs(cell);
+      r_master.reserve(cell_blocks.size());
+      r_coeff.reserve(cell_blocks.size());
+      assert(r_master.empty());
+      assert(r_coeff.empty());
+      // Store block and non-zero basis values
+      for (std::size_t k = 0; k < cell_blocks.size(); ++k)
       {
-        const std::int64_t slave_loc = remote_slave_blocks[j];
-        // Initialize number of masters for each incoming slave to 0
-        collision_block_offsets[i][remote_slave_blocks[j]]
-            = std::vector<std::int32_t>(tdim, 0);
-        if (const auto& cell = remote_cell_collisions[j]; cell != -1)
+        if (const PetscScalar c = basis_values(k, 0); std::abs(c) > 1e-6)
         {
-          auto basis_values = xt::view(remote_tabulated_basis_values, j,
-                                       xt::all(), xt::all());
-          auto cell_blocks = V->dofmap()->cell_dofs(cell);
-          r_master.reserve(cell_blocks.size());
-          r_coeff.reserve(cell_blocks.size());
-          assert(r_master.empty());
-          assert(r_coeff.empty());
-          // Store block and non-zero basis values
-          for (std::size_t k = 0; k < cell_blocks.size(); ++k)
-          {
-            if (const PetscScalar c = basis_values(k, 0); std::abs(c) > 1e-6)
-            {
-              r_coeff.push_back(c);
-              r_master.push_back(cell_blocks[k]);
-            }
-          }
-          // If no local contributions do nothing
-          if (!r_master.empty())
+          r_coeff.push_back(c);
+          r_master.push_back(cell_blocks[k]);
+        }
+      }
+      // If no local contributions do nothing
+      if (!r_master.empty())
+      {
+        const std::size_t num_masters = r_master.size();
+        remote_master_global.resize(num_masters);
+        imap->local_to_global(r_master, remote_master_global);
+        // Insert local contributions in each block
+        assert(block_size == tdim);
+        for (int l = 0; l < tdim; ++l)
+        {
+          for (std::size_t k = 0; k < num_masters; k++)
           {
-            const std::size_t num_masters = r_master.size();
-            remote_master_global.resize(num_masters);
-            imap->local_to_global(r_master, remote_master_global);
-            // Insert local contributions in each block
-            assert(block_size == tdim);
-            for (int l = 0; l < tdim; ++l)
-            {
-              for (std::size_t k = 0; k < num_masters; k++)
-              {
-                collision_masters[i][slave_loc].push_back(
-                    remote_master_global[k] * block_size + l);
-                collision_coeffs[i][slave_loc].push_back(r_coeff[k]);
-                collision_owners[i][slave_loc].push_back(
-                    r_master[k] < size_local
-                        ? rank
-                        : ghost_owners[r_master[k] - size_local]);
-                collision_block_offsets[i][slave_loc][l]++;
-              }
-            }
-            r_master.clear();
-            r_coeff.clear();
-            collision_slaves[i].push_back(slave_loc);
+            collision_masters[i][slave_loc].push_back(
+                remote_master_global[k] * block_size + l);
+            collision_coeffs[i][slave_loc].push_back(r_coeff[k]);
+            collision_owners[i][slave_loc].push_back(
+                r_master[k] < size_local
+                    ? rank
+                    : ghost_owners[r_master[k] - size_local]);
+            collision_block_offsets[i][slave_loc][l]++;
           }
         }
+        r_master.clear();
+        r_coeff.clear();
+        collision_slaves[i].push_back(slave_loc);
+      }
+    };
+
+    if (shared_memory)
+    {
+      // Store the remote slave data once per shared-memory node, and search
+      // for the slaves of one source process at a time
+      const std::vector<int> src_ranks
+          = dolfinx_mpc::compute_neighborhood(neighborhood_comms[0]).first;
+      dolfinx_mpc::NodeSharedArray<std::int64_t> shared_blocks(
+          comm, src_ranks, blocks_wo_local_collision);
+      dolfinx_mpc::NodeSharedArray<double> shared_coords(
+          comm, src_ranks,
+          std::span<const double>(distribute_coordinates.data(),
+                                  distribute_coordinates.size()));
+      for (std::int32_t i = 0; i < indegree; ++i)
+      {
+        std::span<const std::int64_t> src_blocks
+            = shared_blocks.links(src_ranks[i]);
+        std::span<const double> coords = shared_coords.links(src_ranks[i]);
+        xt::xtensor<double, 2> src_coords({src_blocks.size(), 3});
+        std::copy(coords.begin(), coords.end(), src_coords.begin());
+        std::vector<std::int32_t> src_cell_collisions
+            = dolfinx_mpc::find_local_collisions(*V->mesh(), bb_tree,
+                                                 src_coords, eps2);
+        xt::xtensor<double, 3> src_tabulated_basis_values
+            = evaluate_basis(src_coords, src_cell_collisions);
+        for (std::size_t j = 0; j < src_blocks.size(); ++j)
+        {
+          add_remote_block(i, src_blocks[j], src_cell_collisions[j],
+                           xt::view(src_tabulated_basis_values, j, xt::all(),
+                                    xt::all()));
+        }
+      }
+    }
+    else
+    {
+      // Send data to neighbors and receive data
+      std::vector<std::int64_t> remote_slave_blocks(disp.back());
+      MPI_Neighbor_allgatherv(
+          blocks_wo_local_collision.data(), num_colliding_blocks,
+          dolfinx::MPI::mpi_type<std::int64_t>(), remote_slave_blocks.data(),
+          num_slave_blocks.data(), disp.data(),
+          dolfinx::MPI::mpi_type<std::int64_t>(), neighborhood_comms[0]);
+
+      // Multiply recv size by three to accommodate block coordinates
+      std::vector<std::int32_t> num_block_coordinates(indegree);
+      for (std::size_t i = 0; i < num_slave_blocks.size(); ++i)
+        num_block_coordinates[i] = num_slave_blocks[i] * 3;
+      std::vector<int> coordinate_disp(indegree + 1, 0);
+      std::partial_sum(num_block_coordinates.begin(),
+                       num_block_coordinates.end(),
+                       coordinate_disp.begin() + 1);
+
+      // Send slave coordinates to neighbors
+      xt::xtensor<double, 2> recv_coords({std::size_t(disp.back()), 3});
+      MPI_Neighbor_allgatherv(
+          distribute_coordinates.data(), (int)distribute_coordinates.size(),
+          dolfinx::MPI::mpi_type<double>(), recv_coords.data(),
+          num_block_coordinates.data(), coordinate_disp.data(),
+          dolfinx::MPI::mpi_type<double>(), neighborhood_comms[0]);
+
+      std::vector<std::int32_t> remote_cell_collisions
+          = dolfinx_mpc::find_local_collisions(*V->mesh(), bb_tree,
+                                               recv_coords, eps2);
+      xt::xtensor<double, 3> remote_tabulated_basis_values
+          = evaluate_basis(recv_coords, remote_cell_collisions);
+      for (std::int32_t i = 0; i < indegree; ++i)
+      {
+        for (std::int32_t j = disp[i]; j < disp[i + 1]; ++j)
+        {
+          add_remote_block(i, remote_slave_blocks[j],
+                           remote_cell_collisions[j],
+                           xt::view(remote_tabulated_basis_values, j,
+                                    xt::all(), xt::all()));
+        }
       }
     }
   }
@@ -22,12 +22,17 @@ namespace dolfinx_mpc
 /// @param[in] nh Function containing the normal at the slave marker interface
 /// @param[in] eps2 The tolerance for the squared distance to be considered a
 /// collision
+/// @param[in] shared_memory If true, the slave data sent to other processes
+/// is stored once per shared-memory node instead of once per process
+/// @param[in] vertex_masters If true, only the vertex dofs of the master cell
+/// are used as masters, see `dolfinx_mpc::evaluate_vertex_basis_functions`
 mpc_data create_contact_slip_condition(
     std::shared_ptr<dolfinx::fem::FunctionSpace> V,
     dolfinx::mesh::MeshTags<std::int32_t> meshtags, std::int32_t slave_marker,
     std::int32_t master_marker,
     std::shared_ptr<dolfinx::fem::Function<PetscScalar>> nh,
-    const double eps2 = 1e-20);
+    const double eps2 = 1e-20, const bool shared_memory = false,
+    const bool vertex_masters = false);
 
 /// Create a contact condition between two sets of facets
 /// @param[in] The mpc function space
@@ -36,9 +41,14 @@ mpc_data create_contact_slip_condition(
 /// @param[in] master_marker Tag for the other interface
 /// @param[in] eps2 The tolerance for the squared distance to be considered a
 /// collision
+/// @param[in] shared_memory If true, the slave data sent to other processes
+/// is stored once per shared-memory node instead of once per process
+/// @param[in] vertex_masters If true, only the vertex dofs of the master cell
+/// are used as masters, see `dolfinx_mpc::evaluate_vertex_basis_functions`
 mpc_data create_contact_inelastic_condition(
     std::shared_ptr<dolfinx::fem::FunctionSpace> V,
     dolfinx::mesh::MeshTags<std::int32_t> meshtags, std::int32_t slave_marker,
-    std::int32_t master_marker, const double eps2 = 1e-20);
+    std::int32_t master_marker, const double eps2 = 1e-20,
+    const bool shared_memory = false, const bool vertex_masters = false);
 
 } // namespace dolfinx_mpc
@@ -0,0 +1,168 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#pragma once
+
+#include "MultiPointConstraint.h"
+#include <algorithm>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/fem/DirichletBC.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace dolfinx_mpc
+{
+
+/// Classification of the degrees of freedom of a function space with respect
+/// to a set of Dirichlet conditions and a multi-point constraint.
+///
+/// The Dirichlet dofs are stored as a sorted list of unrolled dofs (local to
+/// process), and every cell is flagged by whether it contains Dirichlet dofs,
+/// slave dofs or both. The assembly loops only classify the dofs of flagged
+/// cells. As the classification only depends on the conditions and the
+/// constraint, it can be created once and reused in every assembly, e.g. in
+/// each step of a transient problem.
+template <typename T>
+class DofClassification
+{
+public:
+  /// Flag for cells containing a dof with a Dirichlet condition
+  static constexpr std::int8_t bc_flag = 1;
+
+  /// Flag for cells containing a slave dof
+  static constexpr std::int8_t slave_flag = 2;
+
+  /// Create the classification
+  /// @param[in] V The function space
+  /// @param[in] bcs The Dirichlet conditions. Conditions on other spaces than
+  /// V (or its subspaces) are ignored
+  /// @param[in] mpc The multi-point constraint
+  DofClassification(
+      std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+      const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<T>>>&
+          bcs,
+      std::shared_ptr<const MultiPointConstraint<T>> mpc)
+      : _V(V), _mpc(mpc), _bc_dofs(), _num_owned_bc_dofs(0), _cell_flags()
+  {
+    std::shared_ptr<const dolfinx::fem::DofMap> dofmap = V->dofmap();
+    std::shared_ptr<const dolfinx::common::IndexMap> map = dofmap->index_map;
+    const int bs = dofmap->index_map_bs();
+    const std::int32_t num_owned = bs * map->size_local();
+    const std::int32_t num_dofs
+        = bs * (map->size_local() + map->num_ghosts());
+
+    // Mark the Dirichlet dofs, and compress the markers to a sorted list
+    std::vector<std::int8_t> bc_marker;
+    for (const std::shared_ptr<const dolfinx::fem::DirichletBC<T>>& bc : bcs)
+    {
+      assert(bc);
+      assert(bc->function_space());
+      if (V->contains(*bc->function_space()))
+      {
+        bc_marker.resize(num_dofs, false);
+        bc->mark_dofs(bc_marker);
+      }
+    }
+    for (std::size_t i = 0; i < bc_marker.size(); ++i)
+      if (bc_marker[i])
+        _bc_dofs.push_back(i);
+    _num_owned_bc_dofs = std::distance(
+        _bc_dofs.begin(),
+        std::lower_bound(_bc_dofs.begin(), _bc_dofs.end(), num_owned));
+
+    // Flag the cells containing Dirichlet or slave dofs
+    std::shared_ptr<const dolfinx::mesh::Mesh> mesh = V->mesh();
+    const int tdim = mesh->topology().dim();
+    std::shared_ptr<const dolfinx::common::IndexMap> cell_map
+        = mesh->topology().index_map(tdim);
+    const std::int32_t num_cells
+        = cell_map->size_local() + cell_map->num_ghosts();
+    _cell_flags.assign(num_cells, 0);
+
+    const dolfinx::graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
+    const int dofmap_bs = dofmap->bs();
+    if (!bc_marker.empty())
+    {
+      for (std::int32_t c = 0; c < num_cells; ++c)
+      {
+        for (auto dof : dofs.links(c))
+        {
+          for (int k = 0; k < dofmap_bs; ++k)
+          {
+            if (bc_marker[dofmap_bs * dof + k])
+              _cell_flags[c] |= bc_flag;
+          }
+        }
+      }
+    }
+    std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
+        cell_to_slaves = mpc->cell_to_slaves();
+    for (std::int32_t c = 0; c < cell_to_slaves->num_nodes(); ++c)
+      if (cell_to_slaves->num_links(c) > 0)
+        _cell_flags[c] |= slave_flag;
+  }
+
+  /// Return the function space
+  std::shared_ptr<const dolfinx::fem::FunctionSpace> function_space() const
+  {
+    return _V;
+  }
+
+  /// Return the multi-point constraint
+  std::shared_ptr<const MultiPointConstraint<T>> constraint() const
+  {
+    return _mpc;
+  }
+
+  /// Return the sorted list of dofs (unrolled, local to process) with a
+  /// Dirichlet condition. The first num_owned_bc_dofs() dofs are owned by
+  /// the process
+  const std::vector<std::int32_t>& bc_dofs() const { return _bc_dofs; }
+
+  /// Return the number of dofs with a Dirichlet condition owned by the
+  /// process
+  std::int32_t num_owned_bc_dofs() const { return _num_owned_bc_dofs; }
+
+  /// Return the flags (bc_flag and/or slave_flag) of each cell (local to
+  /// process)
+  const std::vector<std::int8_t>& cell_flags() const { return _cell_flags; }
+
+  /// Check if a cell contains any dof with a Dirichlet condition
+  /// @param[in] cell The cell (local to process)
+  bool has_bc(std::int32_t cell) const { return _cell_flags[cell] & bc_flag; }
+
+  /// Check if a cell contains any slave dof
+  /// @param[in] cell The cell (local to process)
+  bool has_slave(std::int32_t cell) const
+  {
+    return _cell_flags[cell] & slave_flag;
+  }
+
+  /// Check if a dof has a Dirichlet condition
+  /// @param[in] dof The dof (unrolled, local to process)
+  bool is_bc(std::int32_t dof) const
+  {
+    return std::binary_search(_bc_dofs.begin(), _bc_dofs.end(), dof);
+  }
+
+private:
+  // The function space
+  std::shared_ptr<const dolfinx::fem::FunctionSpace> _V;
+
+  // The multi-point constraint
+  std::shared_ptr<const MultiPointConstraint<T>> _mpc;
+
+  // Sorted Dirichlet dofs, where the owned dofs come first
+  std::vector<std::int32_t> _bc_dofs;
+  std::int32_t _num_owned_bc_dofs;
+
+  // Flags for each cell
+  std::vector<std::int8_t> _cell_flags;
+};
+} // namespace dolfinx_mpc
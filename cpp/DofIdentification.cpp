@@ -0,0 +1,346 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#include "DofIdentification.h"
+#include "mpi_utils.h"
+#include <algorithm>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+namespace
+{
+
+/// Throw an error on all processes if any process has flagged an error
+/// @param[in] comm The MPI communicator
+/// @param[in] local_error Flag indicating if an error occured on the process
+/// @param[in] msg The error message
+void throw_on_error(MPI_Comm comm, std::int8_t local_error,
+                    const std::string& msg)
+{
+  std::int8_t error = 0;
+  MPI_Allreduce(&local_error, &error, 1, MPI_INT8_T, MPI_MAX, comm);
+  if (error)
+    throw std::runtime_error(msg);
+}
+
+/// Send data to all outgoing edges of a neighborhood communicator
+/// @param[in] comm The neighborhood communicator
+/// @param[in] send_data The data to send, ordered by destination
+/// @param[in] num_out Number of values sent to each destination
+/// @returns The received data and its offsets per source
+std::pair<std::vector<std::int64_t>, std::vector<std::int32_t>>
+neighbor_exchange(MPI_Comm comm, const std::vector<std::int64_t>& send_data,
+                  std::vector<std::int32_t> num_out)
+{
+  auto [src_ranks, dest_ranks] = dolfinx_mpc::compute_neighborhood(comm);
+  assert(num_out.size() == dest_ranks.size());
+
+  // Push back to avoid null_ptr
+  num_out.push_back(0);
+  std::vector<std::int32_t> num_in(src_ranks.size() + 1);
+  MPI_Neighbor_alltoall(num_out.data(), 1,
+                        dolfinx::MPI::mpi_type<std::int32_t>(), num_in.data(),
+                        1, dolfinx::MPI::mpi_type<std::int32_t>(), comm);
+  num_out.pop_back();
+  num_in.pop_back();
+
+  std::vector<std::int32_t> disp_out(num_out.size() + 1, 0);
+  std::partial_sum(num_out.begin(), num_out.end(), disp_out.begin() + 1);
+  std::vector<std::int32_t> disp_in(num_in.size() + 1, 0);
+  std::partial_sum(num_in.begin(), num_in.end(), disp_in.begin() + 1);
+
+  std::vector<std::int64_t> recv_data(disp_in.back());
+  MPI_Neighbor_alltoallv(
+      send_data.data(), num_out.data(), disp_out.data(),
+      dolfinx::MPI::mpi_type<std::int64_t>(), recv_data.data(), num_in.data(),
+      disp_in.data(), dolfinx::MPI::mpi_type<std::int64_t>(), comm);
+  return {std::move(recv_data), std::move(disp_in)};
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+std::pair<dolfinx::fem::FunctionSpace, std::vector<std::int32_t>>
+dolfinx_mpc::create_identified_functionspace(
+    std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    std::span<const std::int32_t> slaves,
+    std::span<const std::int64_t> masters,
+    std::span<const std::int32_t> owners)
+{
+  dolfinx::common::Timer timer("~MPC: Create identified function space");
+  MPI_Comm comm = V->mesh()->comm();
+  const int rank = dolfinx::MPI::rank(comm);
+  const int num_procs = dolfinx::MPI::size(comm);
+
+  const dolfinx::fem::DofMap& dofmap = *(V->dofmap());
+  std::shared_ptr<const dolfinx::common::IndexMap> imap = dofmap.index_map;
+  const int bs = dofmap.index_map_bs();
+  const std::int32_t size_local = imap->size_local();
+  const std::int32_t num_ghosts = imap->num_ghosts();
+  const std::int64_t local_range0 = imap->local_range()[0];
+
+  if ((slaves.size() != masters.size()) or (masters.size() != owners.size()))
+    throw std::runtime_error("Each slave has to have exactly one master.");
+
+  // Map each owned slave block to its master block and check that all
+  // components of the block are identified with the same master block.
+  // Ghosted slaves are resolved through their owner
+  std::vector<std::int64_t> master_blocks(size_local, -1);
+  std::vector<std::int32_t> master_owners(size_local, -1);
+  std::vector<std::int32_t> num_components(size_local, 0);
+  std::int8_t block_error = 0;
+  for (std::size_t i = 0; i < slaves.size(); ++i)
+  {
+    const std::int32_t block = slaves[i] / bs;
+    if (block >= size_local)
+      continue;
+    const std::int64_t master_block = masters[i] / bs;
+    if ((masters[i] % bs != slaves[i] % bs)
+        or ((master_blocks[block] != -1)
+            and (master_blocks[block] != master_block)))
+    {
+      block_error = 1;
+    }
+    master_blocks[block] = master_block;
+    master_owners[block] = owners[i];
+    num_components[block]++;
+  }
+  for (auto num_comps : num_components)
+    if ((num_comps != 0) and (num_comps != bs))
+      block_error = 1;
+  throw_on_error(comm, block_error,
+                 "Dof identification requires all components of a slave "
+                 "block to be identified with the same master block.");
+
+  // Number the owned blocks that are not slaves contiguously
+  std::vector<std::int32_t> old_to_new(size_local + num_ghosts, -1);
+  std::int32_t new_size_local = 0;
+  for (std::int32_t i = 0; i < size_local; ++i)
+    if (master_blocks[i] == -1)
+      old_to_new[i] = new_size_local++;
+  std::int64_t new_offset = 0;
+  const std::int64_t _new_size_local = new_size_local;
+  MPI_Exscan(&_new_size_local, &new_offset, 1,
+             dolfinx::MPI::mpi_type<std::int64_t>(), MPI_SUM, comm);
+  if (rank == 0)
+    new_offset = 0;
+
+  // Compute new global index and owner of all owned blocks. Slaves are
+  // given the index of their master, which might have to be fetched
+  // from another process
+  std::vector<std::int64_t> new_global(size_local, -1);
+  std::vector<std::int32_t> new_owner(size_local, rank);
+  std::vector<std::int32_t> num_requests(num_procs, 0);
+  std::int8_t chain_error = 0;
+  for (std::int32_t i = 0; i < size_local; ++i)
+  {
+    if (master_blocks[i] == -1)
+      new_global[i] = new_offset + old_to_new[i];
+    else if (master_owners[i] == rank)
+    {
+      const std::int64_t master = master_blocks[i] - local_range0;
+      if (master_blocks[master] != -1)
+        chain_error = 1;
+      new_global[i] = new_offset + old_to_new[master];
+    }
+    else
+      num_requests[master_owners[i]]++;
+  }
+
+  // Create neighborhood communicator from slave owners to master owners
+  std::vector<std::int32_t> dest_ranks;
+  std::vector<std::int32_t> num_out;
+  std::vector<std::int8_t> dest_indicator(num_procs, 0);
+  std::vector<std::int32_t> rank_to_neighbor(num_procs, -1);
+  for (int i = 0; i < num_procs; ++i)
+  {
+    if (num_requests[i] > 0)
+    {
+      dest_indicator[i] = 1;
+      rank_to_neighbor[i] = (std::int32_t)dest_ranks.size();
+      dest_ranks.push_back(i);
+      num_out.push_back(num_requests[i]);
+    }
+  }
+  std::vector<std::int8_t> src_indicator(num_procs);
+  MPI_Alltoall(dest_indicator.data(), 1, MPI_INT8_T, src_indicator.data(), 1,
+               MPI_INT8_T, comm);
+  std::vector<std::int32_t> src_ranks;
+  for (int i = 0; i < num_procs; ++i)
+    if (src_indicator[i])
+      src_ranks.push_back(i);
+
+  MPI_Comm slave_to_master = MPI_COMM_NULL;
+  MPI_Dist_graph_create_adjacent(
+      comm, (int)src_ranks.size(), src_ranks.data(), MPI_UNWEIGHTED,
+      (int)dest_ranks.size(), dest_ranks.data(), MPI_UNWEIGHTED, MPI_INFO_NULL,
+      false, &slave_to_master);
+  MPI_Comm master_to_slave = MPI_COMM_NULL;
+  MPI_Dist_graph_create_adjacent(
+      comm, (int)dest_ranks.size(), dest_ranks.data(), MPI_UNWEIGHTED,
+      (int)src_ranks.size(), src_ranks.data(), MPI_UNWEIGHTED, MPI_INFO_NULL,
+      false, &master_to_slave);
+
+  // Pack master blocks, keeping track of the position of each request
+  std::vector<std::int32_t> disp_out(num_out.size() + 1, 0);
+  std::partial_sum(num_out.begin(), num_out.end(), disp_out.begin() + 1);
+  std::vector<std::int32_t> insert_position(num_out.size(), 0);
+  std::vector<std::int64_t> requests(disp_out.back());
+  std::vector<std::int32_t> request_blocks(disp_out.back());
+  for (std::int32_t i = 0; i < size_local; ++i)
+  {
+    if ((master_blocks[i] != -1) and (master_owners[i] != rank))
+    {
+      const std::int32_t neighbor = rank_to_neighbor[master_owners[i]];
+      const std::int32_t pos
+          = disp_out[neighbor] + insert_position[neighbor]++;
+      requests[pos] = master_blocks[i];
+      request_blocks[pos] = i;
+    }
+  }
+
+  // Map requested masters to their new global index
+  auto [recv_requests, disp_in]
+      = neighbor_exchange(slave_to_master, requests, num_out);
+  std::vector<std::int64_t> replies(recv_requests.size());
+  for (std::size_t i = 0; i < recv_requests.size(); ++i)
+  {
+    const std::int64_t master = recv_requests[i] - local_range0;
+    assert(master >= 0 and master < size_local);
+    if (master_blocks[master] != -1)
+      chain_error = 1;
+    replies[i] = new_offset + old_to_new[master];
+  }
+  std::vector<std::int32_t> num_replies(src_ranks.size());
+  for (std::size_t i = 0; i < src_ranks.size(); ++i)
+    num_replies[i] = disp_in[i + 1] - disp_in[i];
+  auto [recv_replies, _disp]
+      = neighbor_exchange(master_to_slave, replies, num_replies);
+  assert(recv_replies.size() == request_blocks.size());
+  for (std::size_t i = 0; i < recv_replies.size(); ++i)
+  {
+    new_global[request_blocks[i]] = recv_replies[i];
+    new_owner[request_blocks[i]] = master_owners[request_blocks[i]];
+  }
+  MPI_Comm_free(&slave_to_master);
+  MPI_Comm_free(&master_to_slave);
+  throw_on_error(comm, chain_error,
+                 "Dof identification does not support masters that are "
+                 "slaves.");
+
+  // Fetch the new global index and owner of all ghost blocks from their
+  // owner
+  const std::vector<int>& imap_src = imap->src();
+  const std::vector<int>& imap_dest = imap->dest();
+  const std::vector<std::int64_t>& ghosts = imap->ghosts();
+  const std::vector<int> ghost_owners = imap->owners();
+  std::fill(rank_to_neighbor.begin(), rank_to_neighbor.end(), -1);
+  for (std::size_t i = 0; i < imap_src.size(); ++i)
+    rank_to_neighbor[imap_src[i]] = (std::int32_t)i;
+
+  std::vector<std::int32_t> num_ghosts_out(imap_src.size(), 0);
+  for (auto owner : ghost_owners)
+    num_ghosts_out[rank_to_neighbor[owner]]++;
+  std::vector<std::int32_t> ghost_disp(imap_src.size() + 1, 0);
+  std::partial_sum(num_ghosts_out.begin(), num_ghosts_out.end(),
+                   ghost_disp.begin() + 1);
+  insert_position.assign(imap_src.size(), 0);
+  std::vector<std::int64_t> ghost_requests(num_ghosts);
+  std::vector<std::int32_t> ghost_positions(num_ghosts);
+  for (std::int32_t i = 0; i < num_ghosts; ++i)
+  {
+    const std::int32_t neighbor = rank_to_neighbor[ghost_owners[i]];
+    const std::int32_t pos
+        = ghost_disp[neighbor] + insert_position[neighbor]++;
+    ghost_requests[pos] = ghosts[i];
+    ghost_positions[i] = pos;
+  }
+
+  MPI_Comm ghost_to_owner = MPI_COMM_NULL;
+  MPI_Dist_graph_create_adjacent(
+      comm, (int)imap_dest.size(), imap_dest.data(), MPI_UNWEIGHTED,
+      (int)imap_src.size(), imap_src.data(), MPI_UNWEIGHTED, MPI_INFO_NULL,
+      false, &ghost_to_owner);
+  MPI_Comm owner_to_ghost = dolfinx_mpc::create_owner_to_ghost_comm(*imap);
+
+  auto [recv_ghosts, ghost_disp_in]
+      = neighbor_exchange(ghost_to_owner, ghost_requests, num_ghosts_out);
+  std::vector<std::int64_t> ghost_replies(2 * recv_ghosts.size());
+  for (std::size_t i = 0; i < recv_ghosts.size(); ++i)
+  {
+    const std::int64_t block = recv_ghosts[i] - local_range0;
+    assert(block >= 0 and block < size_local);
+    ghost_replies[2 * i] = new_global[block];
+    ghost_replies[2 * i + 1] = new_owner[block];
+  }
+  std::vector<std::int32_t> num_ghost_replies(imap_dest.size());
+  for (std::size_t i = 0; i < imap_dest.size(); ++i)
+    num_ghost_replies[i] = 2 * (ghost_disp_in[i + 1] - ghost_disp_in[i]);
+  auto [recv_ghost_replies, _ghost_disp]
+      = neighbor_exchange(owner_to_ghost, ghost_replies, num_ghost_replies);
+  MPI_Comm_free(&ghost_to_owner);
+  MPI_Comm_free(&owner_to_ghost);
+
+  // Map blocks that are not owned in the new index map to ghosts, where
+  // multiple blocks can be identified with the same ghost
+  std::vector<std::tuple<std::int64_t, std::int32_t, std::int32_t>>
+      off_process;
+  auto add_block = [&](std::int32_t block, std::int64_t global, int owner)
+  {
+    if (owner == rank)
+      old_to_new[block] = (std::int32_t)(global - new_offset);
+    else
+      off_process.push_back({global, owner, block});
+  };
+  for (std::int32_t i = 0; i < size_local; ++i)
+    if (master_blocks[i] != -1)
+      add_block(i, new_global[i], new_owner[i]);
+  for (std::int32_t i = 0; i < num_ghosts; ++i)
+  {
+    const std::int32_t pos = ghost_positions[i];
+    add_block(size_local + i, recv_ghost_replies[2 * pos],
+              (int)recv_ghost_replies[2 * pos + 1]);
+  }
+  std::sort(off_process.begin(), off_process.end());
+  std::vector<std::int64_t> new_ghosts;
+  new_ghosts.reserve(off_process.size());
+  std::vector<int> new_ghost_owners;
+  new_ghost_owners.reserve(off_process.size());
+  for (auto [global, owner, block] : off_process)
+  {
+    if (new_ghosts.empty() or (new_ghosts.back() != global))
+    {
+      new_ghosts.push_back(global);
+      new_ghost_owners.push_back(owner);
+    }
+    old_to_new[block] = new_size_local + (std::int32_t)new_ghosts.size() - 1;
+  }
+
+  auto new_index_map = std::make_shared<dolfinx::common::IndexMap>(
+      comm, new_size_local, new_ghosts, new_ghost_owners);
+
+  // Create the new dofmap, replacing each slave block with its master
+  const dolfinx::graph::AdjacencyList<std::int32_t>& dofmap_adj
+      = dofmap.list();
+  std::vector<std::int32_t> new_cell_dofs(dofmap_adj.array().size());
+  std::transform(dofmap_adj.array().cbegin(), dofmap_adj.array().cend(),
+                 new_cell_dofs.begin(),
+                 [&old_to_new](auto block) { return old_to_new[block]; });
+  auto new_dofmap = std::make_shared<const dolfinx::fem::DofMap>(
+      dofmap.element_dof_layout(), new_index_map, dofmap.bs(),
+      dolfinx::graph::AdjacencyList<std::int32_t>(std::move(new_cell_dofs),
+                                                  dofmap_adj.offsets()),
+      dofmap.bs());
+
+  return {dolfinx::fem::FunctionSpace(V->mesh(), V->element(), new_dofmap),
+          std::move(old_to_new)};
+}
+//-----------------------------------------------------------------------------
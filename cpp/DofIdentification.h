@@ -0,0 +1,72 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#pragma once
+
+#include <complex>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <span>
+#include <vector>
+
+namespace dolfinx_mpc
+{
+
+/// Check if a multi-point constraint is a pure identification of degrees of
+/// freedom, i.e. every slave has exactly one master with coefficient one.
+/// Such constraints (for instance topological periodic conditions on
+/// matching meshes) can be imposed by merging the dofs in the dofmap, see
+/// `create_identified_functionspace`.
+/// @param[in] comm The MPI communicator of the function space
+/// @param[in] coeffs The coefficients of the constraint
+/// @param[in] offsets Offsets of the masters for each slave
+/// @param[in] tol Tolerance for the comparison of the coefficients with one
+/// @returns True if the constraint is an identification on all processes
+template <typename T>
+bool is_dof_identification(MPI_Comm comm, std::span<const T> coeffs,
+                           std::span<const std::int32_t> offsets,
+                           double tol = 1e-13)
+{
+  std::int8_t local_identification = 1;
+  for (std::size_t i = 0; i + 1 < offsets.size(); ++i)
+  {
+    if ((offsets[i + 1] - offsets[i] != 1)
+        or (std::abs(coeffs[offsets[i]] - T(1)) > tol))
+    {
+      local_identification = 0;
+      break;
+    }
+  }
+  std::int8_t identification = 0;
+  MPI_Allreduce(&local_identification, &identification, 1, MPI_INT8_T, MPI_MIN,
+                comm);
+  return identification == 1;
+}
+
+/// Create a function space where slave degrees of freedom are identified
+/// with their master, i.e. each slave block is replaced by its master block
+/// in the cell-to-dof map and removed from the index map. The resulting space
+/// can be used with the standard DOLFINx assemblers and solvers, without any
+/// multi-point constraint.
+///
+/// @note Identification is done per block. All components of a slave block
+/// has to be constrained to the same component of a single master block.
+/// @note A master cannot itself be a slave.
+///
+/// @param[in] V The function space
+/// @param[in] slaves List of local slave dofs (owned and ghosted)
+/// @param[in] masters The master dof (global index) of each slave
+/// @param[in] owners The owner of each master
+/// @returns The identified function space and a map from each block (local
+/// to process) in `V` to its block (local to process) in the new space
+std::pair<dolfinx::fem::FunctionSpace, std::vector<std::int32_t>>
+create_identified_functionspace(
+    std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    std::span<const std::int32_t> slaves,
+    std::span<const std::int64_t> masters,
+    std::span<const std::int32_t> owners);
+
+} // namespace dolfinx_mpc
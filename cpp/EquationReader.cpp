@@ -0,0 +1,454 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#include "EquationReader.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+namespace
+{
+
+/// Constraint equations read by a process, where the masters of the ith
+/// equation are in [offsets[i], offsets[i+1])
+struct equation_data
+{
+  std::vector<std::int64_t> slave_nodes;
+  std::vector<std::int32_t> slave_components;
+  std::vector<std::int64_t> offsets = {0};
+  std::vector<std::int64_t> master_nodes;
+  std::vector<std::int32_t> master_components;
+  std::vector<double> coeffs;
+};
+
+/// Read the equations of a CSV file whose line starts in the chunk of the
+/// process
+/// @param[in] comm The MPI communicator
+/// @param[in] filename The file name
+/// @returns The equations read by the process
+equation_data read_csv(MPI_Comm comm, const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (!file)
+    throw std::runtime_error("Could not open file " + filename);
+  file.seekg(0, std::ios::end);
+  const std::int64_t size = file.tellg();
+  const int rank = dolfinx::MPI::rank(comm);
+  const int num_procs = dolfinx::MPI::size(comm);
+  const std::int64_t begin = size * rank / num_procs;
+  const std::int64_t end = size * (rank + 1) / num_procs;
+
+  // A line is read by the process whose chunk contains its first character
+  std::string line;
+  file.seekg(begin);
+  if (begin > 0)
+  {
+    file.seekg(begin - 1);
+    if (file.get() != '\n')
+      std::getline(file, line);
+  }
+
+  equation_data data;
+  std::vector<std::string> entries;
+  std::string entry;
+  while (true)
+  {
+    if (const std::int64_t pos = file.tellg(); pos < 0 or pos >= end)
+      break;
+    if (!std::getline(file, line))
+      break;
+
+    // Skip empty lines, comments and keywords
+    if (const std::size_t first = line.find_first_not_of(" \t\r");
+        first == std::string::npos or line[first] == '#'
+        or line[first] == '*')
+    {
+      continue;
+    }
+
+    entries.clear();
+    std::stringstream stream(line);
+    while (std::getline(stream, entry, ','))
+      entries.push_back(entry);
+    if (entries.size() < 5 or (entries.size() - 2) % 3 != 0)
+      throw std::runtime_error("Invalid constraint equation: " + line);
+    data.slave_nodes.push_back(std::stoll(entries[0]));
+    data.slave_components.push_back(std::stoi(entries[1]));
+    for (std::size_t i = 2; i < entries.size(); i += 3)
+    {
+      data.master_nodes.push_back(std::stoll(entries[i]));
+      data.master_components.push_back(std::stoi(entries[i + 1]));
+      data.coeffs.push_back(std::stod(entries[i + 2]));
+    }
+    data.offsets.push_back(data.master_nodes.size());
+  }
+  return data;
+}
+
+/// Read a contiguous chunk of the equations of a binary file
+/// @param[in] comm The MPI communicator
+/// @param[in] filename The file name
+/// @returns The equations read by the process
+equation_data read_binary(MPI_Comm comm, const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (!file)
+    throw std::runtime_error("Could not open file " + filename);
+  auto read = [&file](std::int64_t pos, auto* data, std::size_t n)
+  {
+    if (n == 0)
+      return;
+    file.seekg(pos);
+    file.read(reinterpret_cast<char*>(data), n * sizeof(*data));
+    if (!file)
+      throw std::runtime_error("Could not read constraint equations.");
+  };
+
+  std::array<std::int64_t, 2> header;
+  read(0, header.data(), header.size());
+  const auto [num_equations, num_terms] = header;
+  const int rank = dolfinx::MPI::rank(comm);
+  const int num_procs = dolfinx::MPI::size(comm);
+  const std::int64_t e0 = num_equations * rank / num_procs;
+  const std::int64_t e1 = num_equations * (rank + 1) / num_procs;
+
+  // Position of each section of the file
+  const std::int64_t offsets_pos = sizeof(header);
+  const std::int64_t slaves_pos
+      = offsets_pos + (num_equations + 1) * sizeof(std::int64_t);
+  const std::int64_t components_pos
+      = slaves_pos + num_equations * sizeof(std::int64_t);
+  const std::int64_t masters_pos
+      = components_pos + num_equations * sizeof(std::int32_t);
+  const std::int64_t master_components_pos
+      = masters_pos + num_terms * sizeof(std::int64_t);
+  const std::int64_t coeffs_pos
+      = master_components_pos + num_terms * sizeof(std::int32_t);
+
+  equation_data data;
+  data.offsets.resize(e1 - e0 + 1);
+  read(offsets_pos + e0 * sizeof(std::int64_t), data.offsets.data(),
+       data.offsets.size());
+  data.slave_nodes.resize(e1 - e0);
+  read(slaves_pos + e0 * sizeof(std::int64_t), data.slave_nodes.data(),
+       data.slave_nodes.size());
+  data.slave_components.resize(e1 - e0);
+  read(components_pos + e0 * sizeof(std::int32_t),
+       data.slave_components.data(), data.slave_components.size());
+
+  const std::int64_t t0 = data.offsets.front();
+  const std::int64_t t1 = data.offsets.back();
+  data.master_nodes.resize(t1 - t0);
+  read(masters_pos + t0 * sizeof(std::int64_t), data.master_nodes.data(),
+       data.master_nodes.size());
+  data.master_components.resize(t1 - t0);
+  read(master_components_pos + t0 * sizeof(std::int32_t),
+       data.master_components.data(), data.master_components.size());
+  data.coeffs.resize(t1 - t0);
+  read(coeffs_pos + t0 * sizeof(double), data.coeffs.data(),
+       data.coeffs.size());
+  std::for_each(data.offsets.begin(), data.offsets.end(),
+                [t0](auto& offset) { offset -= t0; });
+  return data;
+}
+
+/// Send data to all processes
+/// @param[in] comm The MPI communicator
+/// @param[in] send_data The data to send, ordered by destination rank
+/// @param[in] send_sizes The number of entries sent to each process
+/// @returns The received data, ordered by source rank, and the number of
+/// entries received from each process
+template <typename U>
+std::pair<std::vector<U>, std::vector<int>>
+all_to_all(MPI_Comm comm, const std::vector<U>& send_data,
+           const std::vector<int>& send_sizes)
+{
+  const int num_procs = dolfinx::MPI::size(comm);
+  std::vector<int> recv_sizes(num_procs);
+  MPI_Alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(), 1, MPI_INT,
+               comm);
+  std::vector<int> send_disp(num_procs + 1, 0);
+  std::partial_sum(send_sizes.begin(), send_sizes.end(),
+                   std::next(send_disp.begin()));
+  std::vector<int> recv_disp(num_procs + 1, 0);
+  std::partial_sum(recv_sizes.begin(), recv_sizes.end(),
+                   std::next(recv_disp.begin()));
+  std::vector<U> recv_data(recv_disp.back());
+  MPI_Alltoallv(send_data.data(), send_sizes.data(), send_disp.data(),
+                dolfinx::MPI::mpi_type<U>(), recv_data.data(),
+                recv_sizes.data(), recv_disp.data(),
+                dolfinx::MPI::mpi_type<U>(), comm);
+  return {std::move(recv_data), std::move(recv_sizes)};
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+dolfinx_mpc::mpc_data dolfinx_mpc::read_constraint_equations(
+    std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    const std::string& filename, EquationFormat format)
+{
+  dolfinx::common::Timer timer("~MPC: Read constraint equations");
+  std::shared_ptr<const dolfinx::mesh::Mesh> mesh = V->mesh();
+  MPI_Comm comm = mesh->comm();
+  const int rank = dolfinx::MPI::rank(comm);
+  const int num_procs = dolfinx::MPI::size(comm);
+
+  const equation_data equations = format == EquationFormat::csv
+                                      ? read_csv(comm, filename)
+                                      : read_binary(comm, filename);
+  const std::size_t num_equations = equations.slave_nodes.size();
+
+  std::shared_ptr<const dolfinx::fem::DofMap> dofmap = V->dofmap();
+  std::shared_ptr<const dolfinx::common::IndexMap> imap = dofmap->index_map;
+  const int bs = dofmap->index_map_bs();
+  const std::int32_t size_local = imap->size_local();
+  auto invalid_component = [bs](std::int32_t c) { return c < 0 or c >= bs; };
+  if (std::any_of(equations.slave_components.begin(),
+                  equations.slave_components.end(), invalid_component)
+      or std::any_of(equations.master_components.begin(),
+                     equations.master_components.end(), invalid_component))
+  {
+    throw std::runtime_error("Component of constraint equation is not in the "
+                             "block of the function space.");
+  }
+
+  // Find the geometry node of each owned block
+  const dolfinx::graph::AdjacencyList<std::int32_t>& x_dofmap
+      = mesh->geometry().dofmap();
+  const std::vector<std::int64_t>& input_indices
+      = mesh->geometry().input_global_indices();
+  const int tdim = mesh->topology().dim();
+  std::shared_ptr<const dolfinx::common::IndexMap> cell_map
+      = mesh->topology().index_map(tdim);
+  const std::int32_t num_cells = cell_map->size_local() + cell_map->num_ghosts();
+  std::vector<std::int64_t> block_nodes(size_local, -1);
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    auto x_dofs = x_dofmap.links(c);
+    auto blocks = dofmap->cell_dofs(c);
+    if (x_dofs.size() != blocks.size())
+    {
+      throw std::runtime_error("The number of dofs in each cell has to equal "
+                               "the number of geometry nodes.");
+    }
+    for (std::size_t i = 0; i < blocks.size(); ++i)
+      if (blocks[i] < size_local)
+        block_nodes[blocks[i]] = input_indices[x_dofs[i]];
+  }
+
+  // Register (node, global block) of each owned block in a directory
+  // distributed by node index modulo the number of processes
+  std::vector<std::int32_t> owned_blocks(size_local);
+  std::iota(owned_blocks.begin(), owned_blocks.end(), 0);
+  std::vector<std::int64_t> global_blocks(size_local);
+  imap->local_to_global(owned_blocks, global_blocks);
+  std::vector<std::int64_t> directory;
+  std::vector<int> directory_sizes;
+  {
+    std::vector<int> send_sizes(num_procs, 0);
+    for (auto node : block_nodes)
+      send_sizes[node % num_procs] += 2;
+    std::vector<int> insert_pos(num_procs, 0);
+    std::partial_sum(send_sizes.begin(), std::prev(send_sizes.end()),
+                     std::next(insert_pos.begin()));
+    std::vector<std::int64_t> send_data(2 * size_local);
+    for (std::int32_t b = 0; b < size_local; ++b)
+    {
+      int& pos = insert_pos[block_nodes[b] % num_procs];
+      send_data[pos++] = block_nodes[b];
+      send_data[pos++] = global_blocks[b];
+    }
+    std::tie(directory, directory_sizes)
+        = all_to_all(comm, send_data, send_sizes);
+  }
+
+  // Sort directory entries (node, global block, owner) by node
+  std::vector<std::array<std::int64_t, 3>> sorted_directory;
+  sorted_directory.reserve(directory.size() / 2);
+  {
+    std::size_t pos = 0;
+    for (int p = 0; p < num_procs; ++p)
+    {
+      for (int j = 0; j < directory_sizes[p]; j += 2, pos += 2)
+        sorted_directory.push_back(
+            {directory[pos], directory[pos + 1], std::int64_t(p)});
+    }
+  }
+  std::sort(sorted_directory.begin(), sorted_directory.end());
+
+  // Query the directory for all nodes in the equations
+  std::vector<std::int64_t> nodes(equations.slave_nodes);
+  nodes.insert(nodes.end(), equations.master_nodes.begin(),
+               equations.master_nodes.end());
+  dolfinx::radix_sort(std::span<std::int64_t>(nodes));
+  nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+  if (!nodes.empty() and nodes.front() < 0)
+    throw std::runtime_error("Negative node index in constraint equation.");
+  std::vector<std::size_t> query_pos(nodes.size());
+  std::vector<std::int64_t> node_data;
+  {
+    std::vector<int> send_sizes(num_procs, 0);
+    for (auto node : nodes)
+      send_sizes[node % num_procs]++;
+    std::vector<int> insert_pos(num_procs, 0);
+    std::partial_sum(send_sizes.begin(), std::prev(send_sizes.end()),
+                     std::next(insert_pos.begin()));
+    std::vector<std::int64_t> queries(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+      query_pos[i] = insert_pos[nodes[i] % num_procs]++;
+      queries[query_pos[i]] = nodes[i];
+    }
+    auto [recv_queries, recv_sizes] = all_to_all(comm, queries, send_sizes);
+
+    // Answer with (global block, owner), or -1 if the node is not in the
+    // mesh
+    std::vector<std::int64_t> answers(2 * recv_queries.size(), -1);
+    for (std::size_t i = 0; i < recv_queries.size(); ++i)
+    {
+      auto it = std::lower_bound(
+          sorted_directory.begin(), sorted_directory.end(), recv_queries[i],
+          [](const auto& entry, std::int64_t node) { return entry[0] < node; });
+      if (it != sorted_directory.end() and (*it)[0] == recv_queries[i])
+      {
+        answers[2 * i] = (*it)[1];
+        answers[2 * i + 1] = (*it)[2];
+      }
+    }
+    std::transform(recv_sizes.begin(), recv_sizes.end(), recv_sizes.begin(),
+                   [](int size) { return 2 * size; });
+    node_data = all_to_all(comm, answers, recv_sizes).first;
+  }
+
+  // Map a (node, component) pair to its global dof and owner
+  auto node_to_dof = [&nodes, &query_pos, &node_data,
+                      bs](std::int64_t node, std::int32_t component)
+  {
+    auto it = std::lower_bound(nodes.begin(), nodes.end(), node);
+    const std::size_t pos = query_pos[std::distance(nodes.begin(), it)];
+    if (node_data[2 * pos] < 0)
+    {
+      throw std::runtime_error("Node " + std::to_string(node)
+                               + " of constraint equation is not in the mesh.");
+    }
+    return std::pair(node_data[2 * pos] * bs + component,
+                     std::int32_t(node_data[2 * pos + 1]));
+  };
+
+  // Send each equation (slave dof, number of masters, (master dof, owner,
+  // coefficient)*) to the owner of its slave
+  std::vector<std::int64_t> recv_equations;
+  {
+    std::vector<std::int32_t> slave_owners(num_equations);
+    std::vector<int> send_sizes(num_procs, 0);
+    for (std::size_t e = 0; e < num_equations; ++e)
+    {
+      slave_owners[e] = node_to_dof(equations.slave_nodes[e],
+                                    equations.slave_components[e])
+                            .second;
+      send_sizes[slave_owners[e]]
+          += 2 + 3 * (equations.offsets[e + 1] - equations.offsets[e]);
+    }
+    std::vector<int> insert_pos(num_procs, 0);
+    std::partial_sum(send_sizes.begin(), std::prev(send_sizes.end()),
+                     std::next(insert_pos.begin()));
+    std::vector<std::int64_t> send_data(
+        std::accumulate(send_sizes.begin(), send_sizes.end(), std::size_t(0)));
+    for (std::size_t e = 0; e < num_equations; ++e)
+    {
+      int& pos = insert_pos[slave_owners[e]];
+      send_data[pos++] = node_to_dof(equations.slave_nodes[e],
+                                     equations.slave_components[e])
+                             .first;
+      send_data[pos++] = equations.offsets[e + 1] - equations.offsets[e];
+      for (std::int64_t j = equations.offsets[e]; j < equations.offsets[e + 1];
+           ++j)
+      {
+        auto [dof, owner] = node_to_dof(equations.master_nodes[j],
+                                        equations.master_components[j]);
+        send_data[pos++] = dof;
+        send_data[pos++] = owner;
+        send_data[pos++] = std::bit_cast<std::int64_t>(equations.coeffs[j]);
+      }
+    }
+    recv_equations = all_to_all(comm, send_data, send_sizes).first;
+  }
+
+  // Unpack the equations of the owned slaves
+  const std::int64_t dof_offset = bs * imap->local_range()[0];
+  std::vector<std::int8_t> is_slave(bs * size_local, 0);
+  std::vector<std::int32_t> slaves;
+  std::vector<std::int64_t> masters;
+  std::vector<PetscScalar> coeffs;
+  std::vector<std::int32_t> owners;
+  std::vector<std::int32_t> num_masters_per_slave;
+  for (std::size_t i = 0; i < recv_equations.size();)
+  {
+    const std::int32_t slave = recv_equations[i] - dof_offset;
+    const std::int32_t num_masters = recv_equations[i + 1];
+    assert(slave >= 0 and slave < bs * size_local);
+    if (is_slave[slave])
+    {
+      throw std::runtime_error("Degree of freedom is the slave of more than "
+                               "one constraint equation.");
+    }
+    is_slave[slave] = 1;
+    slaves.push_back(slave);
+    num_masters_per_slave.push_back(num_masters);
+    for (std::int32_t j = 0; j < num_masters; ++j)
+    {
+      const std::size_t pos = i + 2 + 3 * j;
+      masters.push_back(recv_equations[pos]);
+      owners.push_back(recv_equations[pos + 1]);
+      coeffs.push_back(std::bit_cast<double>(recv_equations[pos + 2]));
+    }
+    i += 2 + 3 * num_masters;
+  }
+  LOG(INFO) << "Read " << num_equations << " constraint equations on rank "
+            << rank << ", " << slaves.size() << " owned slaves";
+
+  // Distribute ghost data
+  dolfinx_mpc::mpc_data ghost_data
+      = dolfinx_mpc::distribute_ghost_data<PetscScalar>(
+          slaves, masters, coeffs, owners, num_masters_per_slave, imap, bs);
+
+  // Add ghost data to existing arrays
+  slaves.insert(slaves.end(), ghost_data.slaves.begin(),
+                ghost_data.slaves.end());
+  masters.insert(masters.end(), ghost_data.masters.begin(),
+                 ghost_data.masters.end());
+  num_masters_per_slave.insert(num_masters_per_slave.end(),
+                               ghost_data.offsets.begin(),
+                               ghost_data.offsets.end());
+  coeffs.insert(coeffs.end(), ghost_data.coeffs.begin(),
+                ghost_data.coeffs.end());
+  owners.insert(owners.end(), ghost_data.owners.begin(),
+                ghost_data.owners.end());
+
+  // Compute offsets
+  std::vector<std::int32_t> offsets(num_masters_per_slave.size() + 1, 0);
+  std::partial_sum(num_masters_per_slave.begin(), num_masters_per_slave.end(),
+                   offsets.begin() + 1);
+
+  dolfinx_mpc::mpc_data output;
+  output.slaves = slaves;
+  output.masters = masters;
+  output.coeffs = coeffs;
+  output.offsets = offsets;
+  output.owners = owners;
+  return output;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,54 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#pragma once
+
+#include "utils.h"
+#include <dolfinx/fem/FunctionSpace.h>
+#include <memory>
+#include <string>
+
+namespace dolfinx_mpc
+{
+
+/// File formats for linear constraint equations
+enum class EquationFormat
+{
+  /// One equation per line, with comma separated entries
+  /// `slave_node, slave_component, master_node_0, master_component_0,
+  /// coefficient_0, master_node_1, ...`. Empty lines and lines starting with
+  /// `#` or `*` are ignored.
+  csv,
+  /// Native endian binary file with the sections
+  /// `int64 num_equations, int64 num_terms,
+  /// int64 offsets[num_equations + 1], int64 slave_nodes[num_equations],
+  /// int32 slave_components[num_equations], int64 master_nodes[num_terms],
+  /// int32 master_components[num_terms], double coefficients[num_terms]`,
+  /// where the masters of equation i are in [offsets[i], offsets[i+1]).
+  binary
+};
+
+/// Read linear constraint equations u_s = sum_i c_i u_{m_i} from a file and
+/// create the corresponding multi-point constraint data. The slave and
+/// masters are given as (node, component) pairs, where the node is the
+/// global input index of a geometry node of the mesh (as in the mesh file)
+/// and the component the index in the block of the function space.
+///
+/// The file is read in parallel, with each process reading a contiguous
+/// chunk. The node to dof map is resolved in bulk through a distributed
+/// directory of the nodes, and each equation is sent to the process owning
+/// its slave with a single all-to-all.
+/// @param[in] V The function space. The number of dofs (blocks) in each cell
+/// has to equal the number of geometry nodes in the cell, i.e. the degree of
+/// the space and the mesh geometry has to be the same
+/// @param[in] filename The name of the file
+/// @param[in] format The format of the file
+/// @returns The multi-point constraint data
+mpc_data
+read_constraint_equations(std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+                          const std::string& filename, EquationFormat format);
+
+} // namespace dolfinx_mpc
@@ -0,0 +1,196 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#include "HangingNodeConstraint.h"
+#include <algorithm>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <numeric>
+#include <xtensor/xview.hpp>
+
+//-----------------------------------------------------------------------------
+dolfinx_mpc::mpc_data dolfinx_mpc::create_hanging_node_constraint(
+    std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    std::span<const std::int32_t> parent_facets,
+    std::span<const std::int32_t> child_facets,
+    const std::vector<
+        std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs)
+{
+  dolfinx::common::Timer timer("~MPC: Hanging node constraint");
+  if (parent_facets.size() != child_facets.size())
+  {
+    throw std::runtime_error(
+        "Number of parent facets and child facets must be equal.");
+  }
+
+  std::shared_ptr<const dolfinx::mesh::Mesh> mesh = V->mesh();
+  const int tdim = mesh->topology().dim();
+  const int fdim = tdim - 1;
+  mesh->topology_mutable().create_connectivity(fdim, tdim);
+  mesh->topology_mutable().create_connectivity(tdim, fdim);
+  auto f_to_c = mesh->topology().connectivity(fdim, tdim);
+  auto c_to_f = mesh->topology().connectivity(tdim, fdim);
+
+  std::shared_ptr<const dolfinx::fem::DofMap> dofmap = V->dofmap();
+  const dolfinx::fem::ElementDofLayout& layout = dofmap->element_dof_layout();
+  std::shared_ptr<const dolfinx::common::IndexMap> imap = dofmap->index_map;
+  const int bs = dofmap->index_map_bs();
+  const std::int32_t size_local = imap->size_local();
+
+  // Get a cell containing a facet and the local index of the facet in it
+  auto facet_in_cell = [&f_to_c, &c_to_f](std::int32_t facet)
+  {
+    const std::int32_t cell = f_to_c->links(facet).front();
+    auto cell_facets = c_to_f->links(cell);
+    const auto local_facet = std::distance(
+        cell_facets.begin(),
+        std::find(cell_facets.begin(), cell_facets.end(), facet));
+    return std::pair<std::int32_t, int>(cell, (int)local_facet);
+  };
+
+  // Find the owned blocks on the closure of each child facet that are not on
+  // the closure of its parent facet, with a child cell containing the block
+  // and the parent cell and facet
+  std::vector<std::int8_t> is_slave_block(size_local, 0);
+  std::vector<std::int32_t> slave_blocks;
+  std::vector<std::int32_t> child_cells;
+  std::vector<std::int32_t> parent_cells;
+  std::vector<int> parent_local_facets;
+  for (std::size_t i = 0; i < parent_facets.size(); ++i)
+  {
+    auto [parent_cell, parent_facet] = facet_in_cell(parent_facets[i]);
+    auto [child_cell, child_facet] = facet_in_cell(child_facets[i]);
+    auto parent_blocks = dofmap->cell_dofs(parent_cell);
+    auto child_blocks = dofmap->cell_dofs(child_cell);
+    const std::vector<int>& parent_closure
+        = layout.entity_closure_dofs(fdim, parent_facet);
+    for (auto j : layout.entity_closure_dofs(fdim, child_facet))
+    {
+      const std::int32_t block = child_blocks[j];
+      if (block >= size_local or is_slave_block[block]
+          or std::any_of(parent_closure.begin(), parent_closure.end(),
+                         [&parent_blocks, block](auto k)
+                         { return parent_blocks[k] == block; }))
+      {
+        continue;
+      }
+      is_slave_block[block] = 1;
+      slave_blocks.push_back(block);
+      child_cells.push_back(child_cell);
+      parent_cells.push_back(parent_cell);
+      parent_local_facets.push_back(parent_facet);
+    }
+  }
+
+  // Remove blocks in Dirichlet bcs
+  {
+    const std::vector<std::int8_t> bc_marker
+        = dolfinx_mpc::is_bc<PetscScalar>(*V, slave_blocks, bcs);
+    std::size_t num_slave_blocks = 0;
+    for (std::size_t i = 0; i < slave_blocks.size(); ++i)
+    {
+      if (bc_marker[i])
+        continue;
+      slave_blocks[num_slave_blocks] = slave_blocks[i];
+      child_cells[num_slave_blocks] = child_cells[i];
+      parent_cells[num_slave_blocks] = parent_cells[i];
+      parent_local_facets[num_slave_blocks] = parent_local_facets[i];
+      num_slave_blocks++;
+    }
+    slave_blocks.resize(num_slave_blocks);
+    child_cells.resize(num_slave_blocks);
+    parent_cells.resize(num_slave_blocks);
+    parent_local_facets.resize(num_slave_blocks);
+  }
+
+  // Evaluate the basis functions of the parent cells at the slave
+  // coordinates
+  const xt::xtensor<double, 2> x = xt::transpose(
+      dolfinx_mpc::tabulate_dof_coordinates(*V, slave_blocks, child_cells));
+  const xt::xtensor<double, 3> basis_values
+      = dolfinx_mpc::evaluate_basis_functions(*V, x, parent_cells);
+
+  // The masters of a slave are the blocks on the closure of the parent
+  // facet, as the other basis functions of the parent cell vanish on it
+  std::vector<std::int32_t> slaves;
+  std::vector<std::int32_t> master_blocks;
+  std::vector<std::int32_t> master_components;
+  std::vector<PetscScalar> coeffs;
+  std::vector<std::int32_t> num_masters_per_slave;
+  slaves.reserve(bs * slave_blocks.size());
+  num_masters_per_slave.reserve(bs * slave_blocks.size());
+  for (std::size_t i = 0; i < slave_blocks.size(); ++i)
+  {
+    auto parent_blocks = dofmap->cell_dofs(parent_cells[i]);
+    const std::vector<int>& parent_closure
+        = layout.entity_closure_dofs(fdim, parent_local_facets[i]);
+    for (int k = 0; k < bs; ++k)
+    {
+      slaves.push_back(bs * slave_blocks[i] + k);
+      std::int32_t num_masters = 0;
+      for (auto j : parent_closure)
+      {
+        const double coeff = basis_values(i, j, 0);
+        if (std::abs(coeff) < 1e-14)
+          continue;
+        master_blocks.push_back(parent_blocks[j]);
+        master_components.push_back(k);
+        coeffs.push_back(coeff);
+        num_masters++;
+      }
+      num_masters_per_slave.push_back(num_masters);
+    }
+  }
+
+  // Map masters to global indices and find their owners
+  std::vector<std::int64_t> masters(master_blocks.size());
+  imap->local_to_global(master_blocks, masters);
+  std::vector<std::int32_t> owners(master_blocks.size());
+  const int rank = dolfinx::MPI::rank(mesh->comm());
+  const std::vector<int>& ghost_owners = imap->owners();
+  for (std::size_t i = 0; i < master_blocks.size(); ++i)
+  {
+    masters[i] = bs * masters[i] + master_components[i];
+    owners[i] = master_blocks[i] < size_local
+                    ? rank
+                    : ghost_owners[master_blocks[i] - size_local];
+  }
+
+  // Distribute ghost data
+  dolfinx_mpc::mpc_data ghost_data
+      = dolfinx_mpc::distribute_ghost_data<PetscScalar>(
+          slaves, masters, coeffs, owners, num_masters_per_slave, imap, bs);
+
+  // Add ghost data to existing arrays
+  slaves.insert(slaves.end(), ghost_data.slaves.begin(),
+                ghost_data.slaves.end());
+  masters.insert(masters.end(), ghost_data.masters.begin(),
+                 ghost_data.masters.end());
+  num_masters_per_slave.insert(num_masters_per_slave.end(),
+                               ghost_data.offsets.begin(),
+                               ghost_data.offsets.end());
+  coeffs.insert(coeffs.end(), ghost_data.coeffs.begin(),
+                ghost_data.coeffs.end());
+  owners.insert(owners.end(), ghost_data.owners.begin(),
+                ghost_data.owners.end());
+
+  // Compute offsets
+  std::vector<std::int32_t> offsets(num_masters_per_slave.size() + 1, 0);
+  std::partial_sum(num_masters_per_slave.begin(), num_masters_per_slave.end(),
+                   offsets.begin() + 1);
+
+  dolfinx_mpc::mpc_data output;
+  output.slaves = slaves;
+  output.masters = masters;
+  output.coeffs = coeffs;
+  output.offsets = offsets;
+  output.owners = owners;
+  return output;
+}
+//-----------------------------------------------------------------------------
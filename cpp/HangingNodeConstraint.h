@@ -0,0 +1,50 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#pragma once
+
+#include "utils.h"
+#include <dolfinx/fem/DirichletBC.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <memory>
+#include <petscsys.h>
+#include <span>
+#include <vector>
+
+namespace dolfinx_mpc
+{
+
+/// Create the constraints for the hanging nodes of a non-conforming mesh,
+/// where a coarse (parent) facet is geometrically split into finer (child)
+/// facets that are not topologically connected to it, except through the
+/// vertices they share. The degrees of freedom on the closure of a child
+/// facet that are not on the closure of its parent facet are slaves, with
+/// the degrees of freedom on the closure of the parent facet as masters and
+/// the parent basis functions evaluated at the slave as coefficients.
+///
+/// The parent cell of each slave is given by the facet topology, so no
+/// point location is required, and the constraint is created with a single
+/// pass over the facet pairs.
+/// @note Hanging nodes whose masters are hanging nodes of another pair
+/// (unbalanced refinement) are not resolved
+/// @param[in] V The function space (Lagrange of any degree, possibly
+/// blocked)
+/// @param[in] parent_facets The parent facets (local to process)
+/// @param[in] child_facets The child facets (local to process), where
+/// `child_facets[i]` is geometrically contained in `parent_facets[i]`. The
+/// pairs have to be given on the processes owning the slave degrees of
+/// freedom, with the parent cell on the process
+/// @param[in] bcs List of Dirichlet BCs (slaves in these are not
+/// constrained)
+/// @returns The multi-point constraint data
+mpc_data create_hanging_node_constraint(
+    std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    std::span<const std::int32_t> parent_facets,
+    std::span<const std::int32_t> child_facets,
+    const std::vector<
+        std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs);
+
+} // namespace dolfinx_mpc
@@ -0,0 +1,216 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#include "LinearProblem.h"
+#include "assemble_matrix.h"
+#include "assemble_vector.h"
+#include "lifting.h"
+#include "utils.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/mesh/Mesh.h>
+
+namespace
+{
+// Number of linear problems created on this process, used for the default
+// options prefix
+std::size_t num_linear_problems = 0;
+
+/// Copy the current values of the constants of a form into packed storage
+/// (see dolfinx::fem::pack_constants) without reallocating it
+/// @param[in,out] values The packed constants
+/// @param[in] form The form
+void update_constants(std::vector<PetscScalar>& values,
+                      const dolfinx::fem::Form<PetscScalar>& form)
+{
+  auto it = values.begin();
+  for (const auto& constant : form.constants())
+    it = std::copy(constant->value.begin(), constant->value.end(), it);
+  assert(it == values.end());
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+dolfinx_mpc::LinearProblem::LinearProblem(
+    std::shared_ptr<const dolfinx::fem::Form<PetscScalar>> a,
+    std::shared_ptr<const dolfinx::fem::Form<PetscScalar>> L,
+    std::shared_ptr<MultiPointConstraint<PetscScalar>> mpc,
+    const std::vector<
+        std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
+    std::shared_ptr<dolfinx::fem::Function<PetscScalar>> u,
+    const std::map<std::string, std::string>& petsc_options,
+    const std::string& prefix)
+    : _a(a), _L(L), _mpc(mpc), _bcs(bcs),
+      _constants_a(dolfinx::fem::pack_constants(*a)),
+      _constants_L(dolfinx::fem::pack_constants(*L)),
+      _coefficients_a(dolfinx::fem::allocate_coefficient_storage(*a)),
+      _coefficients_L(dolfinx::fem::allocate_coefficient_storage(*L)),
+      _coefficient_spans_a(
+          dolfinx::fem::make_coefficients_span(_coefficients_a)),
+      _coefficient_spans_L(
+          dolfinx::fem::make_coefficients_span(_coefficients_L)),
+      _classification(std::make_shared<DofClassification<PetscScalar>>(
+          a->function_spaces().at(0), bcs, mpc)),
+      _u(u ? u
+           : std::make_shared<dolfinx::fem::Function<PetscScalar>>(
+               mpc->function_space())),
+      _x(dolfinx::la::petsc::create_vector_wrap(*_u->x()), false),
+      _A(dolfinx_mpc::create_matrix(*a, mpc)),
+      _b(*mpc->function_space()->dofmap()->index_map,
+         mpc->function_space()->dofmap()->index_map_bs()),
+      _solver(mpc->function_space()->mesh()->comm()), _prefix(prefix),
+      _mat_add_block(
+          dolfinx::la::petsc::Matrix::set_block_fn(_A.mat(), ADD_VALUES)),
+      _mat_add(dolfinx::la::petsc::Matrix::set_fn(_A.mat(), ADD_VALUES)),
+      _mat_set(dolfinx::la::petsc::Matrix::set_fn(_A.mat(), INSERT_VALUES))
+{
+  if (_u->function_space() != _mpc->function_space())
+  {
+    throw std::runtime_error("The solution function has to be in the function "
+                             "space of the multi-point constraint.");
+  }
+
+  // Give the solver a unique prefix and set the options
+  if (_prefix.empty())
+  {
+    _prefix = "dolfinx_mpc_linear_problem_"
+              + std::to_string(num_linear_problems++) + "_";
+  }
+  for (const auto& [option, value] : petsc_options)
+  {
+    const std::string& name = _options.emplace_back("-" + _prefix + option);
+    PetscOptionsSetValue(nullptr, name.c_str(),
+                         value.empty() ? nullptr : value.c_str());
+  }
+  _solver.set_options_prefix(_prefix);
+  _solver.set_operator(_A.mat());
+  _solver.set_from_options();
+}
+//-----------------------------------------------------------------------------
+dolfinx_mpc::LinearProblem::~LinearProblem()
+{
+  for (const std::string& name : _options)
+    PetscOptionsClearValue(nullptr, name.c_str());
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::LinearProblem::pack(bool bilinear, bool linear)
+{
+  if (bilinear)
+  {
+    update_constants(_constants_a, *_a);
+    if (!_a->coefficients().empty())
+      dolfinx::fem::pack_coefficients(*_a, _coefficients_a);
+  }
+  if (linear)
+  {
+    update_constants(_constants_L, *_L);
+    if (!_L->coefficients().empty())
+      dolfinx::fem::pack_coefficients(*_L, _coefficients_L);
+  }
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::LinearProblem::assemble_matrix()
+{
+  pack(true, false);
+  assemble_matrix_packed();
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::LinearProblem::assemble_vector()
+{
+  // The lifting uses the packed data of the bilinear form
+  pack(true, true);
+  assemble_vector_packed();
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::LinearProblem::assemble()
+{
+  pack(true, true);
+  assemble_matrix_packed();
+  assemble_vector_packed();
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::LinearProblem::assemble_matrix_packed()
+{
+  dolfinx::common::Timer timer("~MPC: LinearProblem assemble matrix");
+  Mat A = _A.mat();
+  MatZeroEntries(A);
+  dolfinx_mpc::assemble_matrix(_mat_add_block, _mat_add, *_a,
+                               std::span<const PetscScalar>(_constants_a),
+                               _coefficient_spans_a, *_classification,
+                               *_classification, _workspace, 1.0);
+  MatAssemblyBegin(A, MAT_FLUSH_ASSEMBLY);
+  MatAssemblyEnd(A, MAT_FLUSH_ASSEMBLY);
+
+  // Insert identity on the diagonal of the owned Dirichlet rows
+  const std::vector<std::int32_t>& bc_dofs = _classification->bc_dofs();
+  dolfinx::fem::set_diagonal<PetscScalar>(
+      _mat_set, std::span(bc_dofs.data(), _classification->num_owned_bc_dofs()),
+      1.0);
+  MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
+  MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::LinearProblem::assemble_vector_packed()
+{
+  dolfinx::common::Timer timer("~MPC: LinearProblem assemble vector");
+  Vec b = _b.vec();
+
+  // Assemble into the local (owned and ghost) part of the vector
+  {
+    Vec b_local;
+    VecGhostGetLocalForm(b, &b_local);
+    PetscInt n = 0;
+    VecGetSize(b_local, &n);
+    PetscScalar* array = nullptr;
+    VecGetArray(b_local, &array);
+    std::span<PetscScalar> _b_local(array, n);
+    std::fill(_b_local.begin(), _b_local.end(), PetscScalar(0));
+    dolfinx_mpc::assemble_vector(
+        _b_local, *_L, std::span<const PetscScalar>(_constants_L),
+        _coefficient_spans_L, _mpc, _workspace);
+    dolfinx_mpc::apply_lifting(
+        _b_local, _a, std::span<const PetscScalar>(_constants_a),
+        _coefficient_spans_a, _bcs, *_classification,
+        std::span<const PetscScalar>(), 1.0, _mpc, _workspace);
+    VecRestoreArray(b_local, &array);
+    VecGhostRestoreLocalForm(b, &b_local);
+  }
+
+  // Accumulate ghost contributions
+  VecGhostUpdateBegin(b, ADD_VALUES, SCATTER_REVERSE);
+  VecGhostUpdateEnd(b, ADD_VALUES, SCATTER_REVERSE);
+
+  // Set boundary values on the owned dofs
+  PetscInt n = 0;
+  VecGetLocalSize(b, &n);
+  PetscScalar* array = nullptr;
+  VecGetArray(b, &array);
+  dolfinx::fem::set_bc<PetscScalar>(std::span<PetscScalar>(array, n), _bcs,
+                                    1.0);
+  VecRestoreArray(b, &array);
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<dolfinx::fem::Function<PetscScalar>>
+dolfinx_mpc::LinearProblem::solve()
+{
+  dolfinx::common::Timer timer("~MPC: LinearProblem solve");
+  assemble();
+
+  // Solve and update ghost values of the solution
+  _solver.solve(_x.vec(), _b.vec());
+  _u->x()->scatter_fwd();
+
+  // Compute the slave values
+  _mpc->backsubstitution(_u->x()->mutable_array());
+  _u->x()->scatter_fwd();
+  return _u;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,181 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#pragma once
+
+#include "DofClassification.h"
+#include "MultiPointConstraint.h"
+#include "assemble_utils.h"
+#include <dolfinx/fem/DirichletBC.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/la/petsc.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <petscksp.h>
+#include <string>
+#include <vector>
+
+namespace dolfinx_mpc
+{
+
+/// A linear variational problem a(u, v) = L(v) for all v, with a multi-point
+/// constraint, solved with a PETSc Krylov solver. The matrix, the right hand
+/// side vector, the PETSc wrapper of the solution vector and the solver are
+/// created once, and reused in every call to `assemble` and `solve`. The
+/// storage of the packed constants and coefficients of the forms and the
+/// work arrays of the assembly loops are also kept, such that the constants
+/// and coefficients are repacked in place and the element tensors are not
+/// reallocated by repeated assemblies.
+class LinearProblem
+{
+public:
+  /// Create a linear problem
+  /// @param[in] a The bilinear form
+  /// @param[in] L The linear form
+  /// @param[in] mpc The (finalized) multi-point constraint
+  /// @param[in] bcs The Dirichlet boundary conditions
+  /// @param[in] u The solution function. It is created in the function space
+  /// of the constraint if not supplied
+  /// @param[in] petsc_options Options for the Krylov solver, given as
+  /// (option, value) pairs without leading dash and prefix
+  /// @param[in] prefix The options prefix of the Krylov solver. If empty, the
+  /// prefix "dolfinx_mpc_linear_problem_<n>_" is used, where n counts the
+  /// problems created on this process
+  /// @note The `petsc_options` are set in the global PETSc options database,
+  /// and are removed when the problem is destroyed
+  LinearProblem(
+      std::shared_ptr<const dolfinx::fem::Form<PetscScalar>> a,
+      std::shared_ptr<const dolfinx::fem::Form<PetscScalar>> L,
+      std::shared_ptr<MultiPointConstraint<PetscScalar>> mpc,
+      const std::vector<
+          std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
+      std::shared_ptr<dolfinx::fem::Function<PetscScalar>> u = nullptr,
+      const std::map<std::string, std::string>& petsc_options = {},
+      const std::string& prefix = std::string());
+
+  /// Destructor. Removes the options set by the problem from the PETSc
+  /// options database
+  ~LinearProblem();
+
+  // Copy constructor (deleted)
+  LinearProblem(const LinearProblem& problem) = delete;
+
+  // Assignment operator (deleted)
+  LinearProblem& operator=(const LinearProblem& problem) = delete;
+
+  /// Assemble the matrix, with identity rows for Dirichlet and slave dofs
+  void assemble_matrix();
+
+  /// Assemble the right hand side vector, with lifting of the Dirichlet
+  /// conditions, ghost accumulation and boundary values inserted
+  void assemble_vector();
+
+  /// Assemble the matrix and the right hand side vector
+  void assemble();
+
+  /// Assemble and solve the problem, and compute the values at the slave
+  /// dofs by backsubstitution
+  /// @returns The solution function
+  std::shared_ptr<dolfinx::fem::Function<PetscScalar>> solve();
+
+  /// Return the matrix
+  Mat A() const { return _A.mat(); }
+
+  /// Return the right hand side vector
+  Vec b() const { return _b.vec(); }
+
+  /// Return the Krylov solver
+  KSP ksp() const { return _solver.ksp(); }
+
+  /// Return the options prefix of the Krylov solver
+  const std::string& options_prefix() const { return _prefix; }
+
+  /// Return the solution function
+  std::shared_ptr<dolfinx::fem::Function<PetscScalar>> u() const
+  {
+    return _u;
+  }
+
+private:
+  /// Repack the constants and coefficients of the forms into the existing
+  /// storage
+  /// @param[in] bilinear Pack the data of the bilinear form
+  /// @param[in] linear Pack the data of the linear form
+  void pack(bool bilinear, bool linear);
+
+  /// Assemble the matrix with the packed data of the bilinear form
+  void assemble_matrix_packed();
+
+  /// Assemble the right hand side vector with the packed data of the forms
+  void assemble_vector_packed();
+
+  // Forms
+  std::shared_ptr<const dolfinx::fem::Form<PetscScalar>> _a;
+  std::shared_ptr<const dolfinx::fem::Form<PetscScalar>> _L;
+
+  // The multi-point constraint
+  std::shared_ptr<MultiPointConstraint<PetscScalar>> _mpc;
+
+  // Dirichlet conditions
+  std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>
+      _bcs;
+
+  // Packed constants and coefficients of the forms, and views of the
+  // coefficients passed to the assemblers
+  std::vector<PetscScalar> _constants_a;
+  std::vector<PetscScalar> _constants_L;
+  std::map<std::pair<dolfinx::fem::IntegralType, int>,
+           std::pair<std::vector<PetscScalar>, int>>
+      _coefficients_a;
+  std::map<std::pair<dolfinx::fem::IntegralType, int>,
+           std::pair<std::vector<PetscScalar>, int>>
+      _coefficients_L;
+  std::map<std::pair<dolfinx::fem::IntegralType, int>,
+           std::pair<std::span<const PetscScalar>, int>>
+      _coefficient_spans_a;
+  std::map<std::pair<dolfinx::fem::IntegralType, int>,
+           std::pair<std::span<const PetscScalar>, int>>
+      _coefficient_spans_L;
+
+  // Work arrays of the assembly loops
+  AssemblyWorkspace<PetscScalar> _workspace;
+
+  // Classification of the dofs with respect to the Dirichlet conditions and
+  // the constraint, shared by all assemblies
+  std::shared_ptr<const DofClassification<PetscScalar>> _classification;
+
+  // The solution function and a PETSc vector sharing its data
+  std::shared_ptr<dolfinx::fem::Function<PetscScalar>> _u;
+  dolfinx::la::petsc::Vector _x;
+
+  // Linear algebra objects
+  dolfinx::la::petsc::Matrix _A;
+  dolfinx::la::petsc::Vector _b;
+  dolfinx::la::petsc::KrylovSolver _solver;
+
+  // Functions adding (blocked and unblocked) and inserting values into the
+  // matrix. They are created once, such that their index caches are reused
+  std::function<int(const std::span<const std::int32_t>&,
+                    const std::span<const std::int32_t>&,
+                    const std::span<const PetscScalar>&)>
+      _mat_add_block;
+  std::function<int(const std::span<const std::int32_t>&,
+                    const std::span<const std::int32_t>&,
+                    const std::span<const PetscScalar>&)>
+      _mat_add;
+  std::function<int(const std::span<const std::int32_t>&,
+                    const std::span<const std::int32_t>&,
+                    const std::span<const PetscScalar>&)>
+      _mat_set;
+
+  // Options prefix of the solver and the options (with prefix) set in the
+  // PETSc options database
+  std::string _prefix;
+  std::vector<std::string> _options;
+};
+} // namespace dolfinx_mpc
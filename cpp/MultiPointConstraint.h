@@ -7,6 +7,7 @@
 #pragma once
 
 #include "mpc_helpers.h"
+#include <algorithm>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
@@ -15,6 +16,10 @@
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <iostream>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
 
 namespace dolfinx_mpc
 {
@@ -38,91 +43,141 @@ public:
                        const std::vector<T>& coeffs,
                        const std::vector<std::int32_t>& owners,
                        const std::vector<std::int32_t>& offsets)
-      : _slaves(), _is_slave(), _cell_to_slaves_map(), _num_local_slaves(),
-        _master_map(), _coeff_map(), _owner_map(), _mpc_constants(), _V()
+      : MultiPointConstraint(V, std::vector<std::int32_t>(slaves),
+                             std::vector<std::int64_t>(masters),
+                             std::vector<T>(coeffs),
+                             std::vector<std::int32_t>(owners),
+                             std::vector<std::int32_t>(offsets))
+  {
+  }
+
+  /// Create contact constraint, taking ownership of the input data. If the
+  /// slaves are sorted, the masters, coefficients and owners are used as the
+  /// data of the constraint without copies. Otherwise, the slaves and their
+  /// masters are sorted first.
+  ///
+  /// @note The slave markers (`is_slave`), the constant values and the
+  /// offsets of the master, coefficient and owner adjacency lists are
+  /// indexed by all dofs on the process (owned and ghosts), so the
+  /// constructor still allocates and fills three arrays of that size and
+  /// computes a prefix sum over the offsets.
+  ///
+  /// @param[in] V The function space
+  /// @param[in] slaves List of local slave dofs (unique)
+  /// @param[in] masters Array of all masters
+  /// @param[in] coeffs Coefficients corresponding to each master
+  /// @param[in] owners Owners for each master
+  /// @param[in] offsets Offsets for masters
+  MultiPointConstraint(std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+                       std::vector<std::int32_t>&& slaves,
+                       std::vector<std::int64_t>&& masters,
+                       std::vector<T>&& coeffs,
+                       std::vector<std::int32_t>&& owners,
+                       std::vector<std::int32_t>&& offsets)
+      : _slaves(), _is_slave(), _cell_to_slaves_map(), _ghost_cell_marker(),
+        _num_local_slaves(), _master_map(), _coeff_map(), _owner_map(),
+        _mpc_constants(), _V()
   {
     assert(slaves.size() == offsets.size() - 1);
     assert(masters.size() == coeffs.size());
     assert(coeffs.size() == owners.size());
-    assert(offsets.back() == owners.size());
+    assert(static_cast<std::size_t>(offsets.back()) == owners.size());
+
+    // Sort slaves with their masters
+    if (!std::is_sorted(slaves.begin(), slaves.end()))
+    {
+      std::vector<std::int32_t> perm(slaves.size());
+      std::iota(perm.begin(), perm.end(), 0);
+      std::sort(perm.begin(), perm.end(), [&slaves](auto a, auto b)
+                { return slaves[a] < slaves[b]; });
+      std::vector<std::int32_t> sorted_slaves(slaves.size());
+      std::vector<std::int32_t> sorted_offsets(offsets.size(), 0);
+      std::vector<std::int64_t> sorted_masters(masters.size());
+      std::vector<T> sorted_coeffs(coeffs.size());
+      std::vector<std::int32_t> sorted_owners(owners.size());
+      for (std::size_t i = 0; i < perm.size(); ++i)
+      {
+        const std::int32_t j = perm[i];
+        sorted_slaves[i] = slaves[j];
+        sorted_offsets[i + 1]
+            = sorted_offsets[i] + offsets[j + 1] - offsets[j];
+        std::copy(std::next(masters.begin(), offsets[j]),
+                  std::next(masters.begin(), offsets[j + 1]),
+                  std::next(sorted_masters.begin(), sorted_offsets[i]));
+        std::copy(std::next(coeffs.begin(), offsets[j]),
+                  std::next(coeffs.begin(), offsets[j + 1]),
+                  std::next(sorted_coeffs.begin(), sorted_offsets[i]));
+        std::copy(std::next(owners.begin(), offsets[j]),
+                  std::next(owners.begin(), offsets[j + 1]),
+                  std::next(sorted_owners.begin(), sorted_offsets[i]));
+      }
+      slaves = std::move(sorted_slaves);
+      offsets = std::move(sorted_offsets);
+      masters = std::move(sorted_masters);
+      coeffs = std::move(sorted_coeffs);
+      owners = std::move(sorted_owners);
+    }
+    else if (offsets.front() != 0)
+    {
+      // Shift masters to start at the first offset
+      const std::int32_t first = offsets.front();
+      masters.erase(masters.begin(), std::next(masters.begin(), first));
+      coeffs.erase(coeffs.begin(), std::next(coeffs.begin(), first));
+      owners.erase(owners.begin(), std::next(owners.begin(), first));
+      std::for_each(offsets.begin(), offsets.end(),
+                    [first](auto& offset) { offset -= first; });
+    }
+    assert(std::adjacent_find(slaves.begin(), slaves.end()) == slaves.end());
 
-    // Create list indicating which dofs on the process are slaves
+    // Create list indicating which dofs on the process are slaves, and
+    // count the masters of each dof. As the slaves are sorted, the masters
+    // are already ordered as the adjacency lists over all local dofs
     const dolfinx::fem::DofMap& dofmap = *(V->dofmap());
     const std::int32_t num_dofs_local
         = dofmap.index_map_bs()
           * (dofmap.index_map->size_local() + dofmap.index_map->num_ghosts());
-    std::vector<std::int8_t> _slave_data(num_dofs_local, 0);
+    std::vector<std::int8_t> slave_data(num_dofs_local, 0);
     _mpc_constants = std::vector<T>(num_dofs_local, 0);
+    std::vector<std::int32_t> masters_offsets(num_dofs_local + 1, 0);
     for (std::size_t i = 0; i < slaves.size(); i++)
     {
       const std::int32_t dof = slaves[i];
-      _slave_data[dof] = 1;
+      slave_data[dof] = 1;
       // FIXME: Add input vector for this data
       _mpc_constants[dof] = 1;
+      masters_offsets[dof + 1] = offsets[i + 1] - offsets[i];
     }
-    _is_slave = std::move(_slave_data);
+    _is_slave = std::move(slave_data);
+    std::partial_sum(masters_offsets.begin(), masters_offsets.end(),
+                     masters_offsets.begin());
 
     // Create a map for cells owned by the process to the slaves
     _cell_to_slaves_map = create_cell_to_dofs_map(V, slaves);
 
-    // Create adjacency list with all local dofs, where the slave dofs maps to
-    // its masters
-    std::vector<std::int32_t> _num_masters(num_dofs_local);
-    std::fill(_num_masters.begin(), _num_masters.end(), 0);
-    for (std::int32_t i = 0; i < slaves.size(); i++)
-      _num_masters[slaves[i]] = offsets[i + 1] - offsets[i];
-    std::vector<std::int32_t> masters_offsets(num_dofs_local + 1);
-    masters_offsets[0] = 0;
-    std::inclusive_scan(_num_masters.begin(), _num_masters.end(),
-                        masters_offsets.begin() + 1);
-
-    // Reuse num masters as fill position array
-    std::fill(_num_masters.begin(), _num_masters.end(), 0);
-    std::vector<std::int64_t> _master_data(masters.size());
-    std::vector<T> _coeff_data(masters.size());
-    std::vector<std::int32_t> _owner_data(masters.size());
-    /// Create adjacency lists spanning all local dofs mapping to master dofs,
-    /// its owner and the corresponding coefficient
-    for (std::size_t i = 0; i < slaves.size(); i++)
-    {
-      for (std::int32_t j = 0; j < offsets[i + 1] - offsets[i]; j++)
-      {
-        _master_data[masters_offsets[slaves[i]] + _num_masters[slaves[i]]]
-            = masters[offsets[i] + j];
-        _coeff_data[masters_offsets[slaves[i]] + _num_masters[slaves[i]]]
-            = coeffs[offsets[i] + j];
-        _owner_data[masters_offsets[slaves[i]] + _num_masters[slaves[i]]]
-            = owners[offsets[i] + j];
-        _num_masters[slaves[i]]++;
-      }
-    }
-    _coeff_map = std::make_shared<dolfinx::graph::AdjacencyList<T>>(
-        _coeff_data, masters_offsets);
-    _owner_map = std::make_shared<dolfinx::graph::AdjacencyList<std::int32_t>>(
-        _owner_data, masters_offsets);
-
-    // Create a vector containing all the slave dofs (sorted)
-    std::vector<std::int32_t> sorted_slaves(slaves.size());
-    std::int32_t c = 0;
-    for (std::size_t i = 0; i < _is_slave.size(); i++)
-      if (_is_slave[i])
-        sorted_slaves[c++] = i;
-    _slaves = std::move(sorted_slaves);
-
     const std::int32_t num_local
         = dofmap.index_map_bs() * dofmap.index_map->size_local();
-    auto it = std::lower_bound(_slaves.begin(), _slaves.end(), num_local);
-    _num_local_slaves = std::distance(_slaves.begin(), it);
+    auto it = std::lower_bound(slaves.begin(), slaves.end(), num_local);
+    _num_local_slaves = std::distance(slaves.begin(), it);
 
     // Create new function space with extended index map
     _V = std::make_shared<const dolfinx::fem::FunctionSpace>(
-        create_extended_functionspace(V, _master_data, _owner_data));
+        create_extended_functionspace(V, masters, owners));
+
+    // The cells with slaves or ghost dofs are only marked when needed (see
+    // ghost_cell_marker). The storage is created here, such that clones
+    // share the markers
+    _ghost_cell_marker = std::make_shared<std::vector<std::int8_t>>();
 
     // Map global masters to local index in extended function space
     std::vector<std::int32_t> masters_local
-        = map_dofs_global_to_local(_V, _master_data);
+        = map_dofs_global_to_local(_V, masters);
     _master_map = std::make_shared<dolfinx::graph::AdjacencyList<std::int32_t>>(
-        masters_local, masters_offsets);
+        std::move(masters_local), masters_offsets);
+    _coeff_map = std::make_shared<dolfinx::graph::AdjacencyList<T>>(
+        std::move(coeffs), masters_offsets);
+    _owner_map = std::make_shared<dolfinx::graph::AdjacencyList<std::int32_t>>(
+        std::move(owners), std::move(masters_offsets));
+    _slaves = std::move(slaves);
   }
   //-----------------------------------------------------------------------------
   /// Backsubstitute slave/master constraint for a given function
@@ -139,6 +194,132 @@ public:
     }
   };
 
+  /// Assign each slave to phase groups used in `update_phases`. The
+  /// current coefficients of the constraint are stored as reference
+  /// coefficients. Slaves that are not listed are not scaled.
+  /// @param[in] slaves List of slaves (local to process)
+  /// @param[in] group_offsets Offsets into `groups` for each slave
+  /// @param[in] groups The phase groups of each slave, i.e. the groups of
+  /// slaves[i] are groups[group_offsets[i]:group_offsets[i+1]]. The phase of
+  /// a slave is the product of the phases of its groups.
+  void set_phase_groups(std::span<const std::int32_t> slaves,
+                        std::span<const std::int32_t> group_offsets,
+                        std::span<const std::int32_t> groups)
+  {
+    if (group_offsets.size() != slaves.size() + 1
+        or static_cast<std::size_t>(group_offsets.back()) != groups.size())
+    {
+      throw std::runtime_error("Phase group offsets do not match the slaves.");
+    }
+    if (std::any_of(groups.begin(), groups.end(),
+                    [](auto group) { return group < 0; }))
+    {
+      throw std::runtime_error("Phase groups have to be non-negative.");
+    }
+
+    // Order the groups as the slaves of the constraint
+    std::vector<std::int32_t> num_groups(_slaves.size() + 1, 0);
+    std::vector<std::int32_t> position(slaves.size());
+    for (std::size_t i = 0; i < slaves.size(); ++i)
+    {
+      auto it = std::lower_bound(_slaves.begin(), _slaves.end(), slaves[i]);
+      if (it == _slaves.end() or *it != slaves[i])
+        throw std::runtime_error("Phase group given for a non-slave dof.");
+      position[i] = std::distance(_slaves.begin(), it);
+      num_groups[position[i] + 1] = group_offsets[i + 1] - group_offsets[i];
+    }
+    std::partial_sum(num_groups.begin(), num_groups.end(), num_groups.begin());
+    std::vector<std::int32_t> data(num_groups.back());
+    for (std::size_t i = 0; i < slaves.size(); ++i)
+    {
+      std::copy(std::next(groups.begin(), group_offsets[i]),
+                std::next(groups.begin(), group_offsets[i + 1]),
+                std::next(data.begin(), num_groups[position[i]]));
+    }
+    _phase_groups
+        = std::make_shared<dolfinx::graph::AdjacencyList<std::int32_t>>(
+            std::move(data), std::move(num_groups));
+    _num_phase_groups
+        = groups.empty()
+              ? 0
+              : *std::max_element(groups.begin(), groups.end()) + 1;
+    _ref_coeffs = _coeff_map->array();
+  }
+
+  /// Update the coefficients of the constraint by scaling the reference
+  /// coefficients of every slave by the product of the phases of its groups,
+  /// i.e. coeffs = ref_coeffs * prod_g phases[g]. As the masters are
+  /// unchanged, the index map and sparsity pattern of the constraint can be
+  /// reused (for instance in a Bloch-Floquet sweep).
+  /// @param[in] phases The phase factor of each group
+  void update_phases(std::span<const T> phases)
+  {
+    if (!_phase_groups)
+      throw std::runtime_error("Phase groups have not been set.");
+    if (phases.size() < static_cast<std::size_t>(_num_phase_groups))
+    {
+      throw std::runtime_error("Expected a phase for each of the "
+                               + std::to_string(_num_phase_groups)
+                               + " phase groups, got "
+                               + std::to_string(phases.size()) + ".");
+    }
+    const std::vector<std::int32_t>& offsets = _coeff_map->offsets();
+    for (std::size_t i = 0; i < _slaves.size(); ++i)
+    {
+      T phase = 1;
+      for (auto group : _phase_groups->links(i))
+        phase *= phases[group];
+      std::span<T> coeffs = _coeff_map->links(_slaves[i]);
+      const std::int32_t offset = offsets[_slaves[i]];
+      for (std::size_t k = 0; k < coeffs.size(); ++k)
+        coeffs[k] = phase * _ref_coeffs[offset + k];
+    }
+  }
+
+  /// Create a copy of the constraint on a function space with an identical
+  /// dofmap, for instance the same space on a mesh with the same topology
+  /// but other coordinates. The masters, owners, cell to slave map, ghost
+  /// cell marker and dofmap are shared with this constraint (through shared
+  /// pointers), the slave arrays are copied, and the coefficients are
+  /// replaced.
+  /// @param[in] V The function space on the new mesh
+  /// @param[in] coeffs The coefficients of the new constraint, ordered as
+  /// `coefficients()->array()`. If empty, the coefficients of this
+  /// constraint are copied
+  /// @returns The new constraint
+  MultiPointConstraint<T>
+  clone(std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+        std::span<const T> coeffs) const
+  {
+    dolfinx::common::Timer timer("~MPC: Clone constraint");
+    const dolfinx::fem::DofMap& dofmap = *(V->dofmap());
+    const dolfinx::fem::DofMap& mpc_dofmap = *(_V->dofmap());
+    if (dofmap.index_map_bs() != mpc_dofmap.index_map_bs()
+        or dofmap.index_map->size_local() != mpc_dofmap.index_map->size_local()
+        or dofmap.list().array() != mpc_dofmap.list().array())
+    {
+      throw std::runtime_error(
+          "Cannot clone constraint. The dofmaps of the spaces differ.");
+    }
+    if (!coeffs.empty() and coeffs.size() != _coeff_map->array().size())
+    {
+      throw std::runtime_error(
+          "Cannot clone constraint. Wrong number of coefficients.");
+    }
+
+    MultiPointConstraint<T> mpc(*this);
+    mpc._V = std::make_shared<const dolfinx::fem::FunctionSpace>(
+        V->mesh(), _V->element(), _V->dofmap());
+    std::vector<T> coeff_data
+        = coeffs.empty() ? _coeff_map->array()
+                         : std::vector<T>(coeffs.begin(), coeffs.end());
+    mpc._coeff_map = std::make_shared<dolfinx::graph::AdjacencyList<T>>(
+        std::move(coeff_data), _coeff_map->offsets());
+    if (!_ref_coeffs.empty())
+      mpc._ref_coeffs = mpc._coeff_map->array();
+    return mpc;
+  }
+
   /// Homogenize slave DoFs (particularly useful for nonlinear problems)
   void homogenize(std::span<T> vector) const
   {
@@ -152,6 +333,35 @@ public:
   {
     return _cell_to_slaves_map;
   }
+  /// Return marker for each cell (local to process) indicating if the cell
+  /// contains a slave or a ghost dof, i.e. if its element vector can
+  /// contribute to entries owned by other processes. The markers are
+  /// computed on the first call, and shared with clones of the constraint
+  const std::vector<std::int8_t>& ghost_cell_marker() const
+  {
+    const dolfinx::graph::AdjacencyList<std::int32_t>& cell_dofs
+        = _V->dofmap()->list();
+    if (_ghost_cell_marker->empty() and cell_dofs.num_nodes() > 0)
+    {
+      dolfinx::common::Timer timer("~MPC: Mark ghost cells");
+      std::vector<std::int8_t>& ghost_cells = *_ghost_cell_marker;
+      ghost_cells.resize(cell_dofs.num_nodes(), 0);
+      const std::int32_t size_local = _V->dofmap()->index_map->size_local();
+      for (std::int32_t c = 0; c < cell_dofs.num_nodes(); ++c)
+      {
+        auto dofs = cell_dofs.links(c);
+        if ((c < _cell_to_slaves_map->num_nodes()
+             and _cell_to_slaves_map->num_links(c) > 0)
+            or std::any_of(dofs.begin(), dofs.end(), [size_local](auto dof)
+                           { return dof >= size_local; }))
+        {
+          ghost_cells[c] = 1;
+        }
+      }
+    }
+    return *_ghost_cell_marker;
+  }
+
   /// Return map from slave to masters (local_index)
   std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
   masters() const
@@ -204,13 +414,23 @@ private:
   std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
       _cell_to_slaves_map;
 
+  // Marker for cells with slaves or ghost dofs (computed on first use)
+  std::shared_ptr<std::vector<std::int8_t>> _ghost_cell_marker;
+
   // Number of slaves owned by the process
   std::int32_t _num_local_slaves;
   // Map from slave (local to process) to masters (local to process)
   std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
       _master_map;
   // Map from slave (local to process)to coefficients
-  std::shared_ptr<const dolfinx::graph::AdjacencyList<T>> _coeff_map;
+  std::shared_ptr<dolfinx::graph::AdjacencyList<T>> _coeff_map;
+  // Phase groups of each slave (ordered as _slaves), the number of groups
+  // and the reference coefficients (ordered as _coeff_map) used for phase
+  // updates
+  std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
+      _phase_groups;
+  std::int32_t _num_phase_groups = 0;
+  std::vector<T> _ref_coeffs;
   // Map from slave( local to process) to rank of process owning master
   std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>> _owner_map;
 };
@@ -9,6 +9,9 @@
 #include <dolfinx/fem/DirichletBC.h>
 #include <dolfinx/geometry/BoundingBoxTree.h>
 #include <dolfinx/geometry/utils.h>
+#include <limits>
+#include <numeric>
+#include <optional>
 #include <xtensor/xadapt.hpp>
 #include <xtensor/xview.hpp>
 namespace
@@ -24,6 +27,12 @@ namespace
 /// not collapsed)
 /// @param[in] parent_space The parent space (The same space as V if not
 /// collapsed)
+/// @param[in] candidate_cells Optional function mapping a cell containing a
+/// slave block to the cells (local to process) that should be searched for
+/// its masters before searching all cells owned by the process
+/// @param[in] vertex_masters If true, only the vertex dofs of the cell
+/// containing the mapped slave coordinate are used as masters, see
+/// `dolfinx_mpc::evaluate_vertex_basis_functions`
 /// @returns The multi point constraint
 template <typename T>
 dolfinx_mpc::mpc_data _create_periodic_condition(
@@ -32,7 +41,11 @@ dolfinx_mpc::mpc_data _create_periodic_condition(
         relation,
     double scale,
     const std::function<const std::int32_t(const std::int32_t&)>& parent_map,
-    const dolfinx::fem::FunctionSpace& parent_space)
+    const dolfinx::fem::FunctionSpace& parent_space,
+    const std::function<std::vector<std::int32_t>(std::int32_t)>&
+        candidate_cells
+    = nullptr,
+    bool vertex_masters = false)
 {
   // Map a list of indices in collapsed space back to the parent space
   auto sub_to_parent = [&parent_map](const std::vector<std::int32_t>& sub_dofs)
@@ -118,20 +131,99 @@ dolfinx_mpc::mpc_data _create_periodic_condition(
   auto cell_imap = mesh->topology().index_map(tdim);
   const int num_cells_local = cell_imap->size_local();
 
-  // Create bounding-box tree over owned cells
-  std::vector<std::int32_t> r(num_cells_local);
-  std::iota(r.begin(), r.end(), 0);
-  dolfinx::geometry::BoundingBoxTree tree(*mesh.get(), tdim, r, 1e-15);
-  auto process_tree = tree.create_global_tree(mesh->comm());
-  auto colliding_bbox_processes
-      = dolfinx::geometry::compute_collisions(process_tree, mapped_T);
+  std::vector<std::int32_t> local_cell_collisions(local_blocks.size(), -1);
+  std::vector<std::int32_t> not_found;
+  if (candidate_cells)
+  {
+    // Search for masters among the candidate cells
+    std::vector<std::int32_t> candidate_offsets(1, 0);
+    candidate_offsets.reserve(local_blocks.size() + 1);
+    std::vector<std::int32_t> candidate_data;
+    for (std::size_t i = 0; i < local_blocks.size(); ++i)
+    {
+      std::vector<std::int32_t> cells = candidate_cells(slave_cells[i]);
+      candidate_data.insert(candidate_data.end(), cells.begin(), cells.end());
+      candidate_offsets.push_back((std::int32_t)candidate_data.size());
+    }
+    dolfinx::graph::AdjacencyList<std::int32_t> candidates(
+        std::move(candidate_data), std::move(candidate_offsets));
+    dolfinx::graph::AdjacencyList<std::int32_t> candidate_collisions
+        = dolfinx_mpc::compute_colliding_cells(*mesh, candidates, mapped_T,
+                                               1e-20);
+    for (std::int32_t i = 0; i < candidate_collisions.num_nodes(); ++i)
+    {
+      if (auto cells = candidate_collisions.links(i); !cells.empty())
+        local_cell_collisions[i] = cells.front();
+      else
+        not_found.push_back(i);
+    }
+  }
+  else
+  {
+    not_found.resize(local_blocks.size());
+    std::iota(not_found.begin(), not_found.end(), 0);
+  }
+
+  // The bounding box trees are only built if some process has points that
+  // were not found among the candidate cells. As the global tree is
+  // collective, all processes have to agree on this
+  std::int8_t search_local = !not_found.empty();
+  std::int8_t search_global = 0;
+  MPI_Allreduce(&search_local, &search_global, 1, MPI_INT8_T, MPI_MAX,
+                mesh->comm());
+
+  // Processes (possibly) containing the points that are not found on this
+  // process
+  std::vector<std::int32_t> bbox_offsets(local_blocks.size() + 1, 0);
+  std::vector<std::int32_t> bbox_data;
+  std::optional<dolfinx::geometry::BoundingBoxTree> tree;
+  if (search_global)
+  {
+    // Create bounding-box tree over owned cells
+    std::vector<std::int32_t> r(num_cells_local);
+    std::iota(r.begin(), r.end(), 0);
+    tree.emplace(*mesh.get(), tdim, r, 1e-15);
+
+    // Search all owned cells for the remaining points
+    xt::xtensor<double, 2> remaining_points({not_found.size(), 3});
+    for (std::size_t i = 0; i < not_found.size(); ++i)
+      xt::row(remaining_points, i) = xt::row(mapped_T, not_found[i]);
+    std::vector<std::int32_t> remaining_collisions
+        = dolfinx_mpc::find_local_collisions(*mesh, *tree, remaining_points,
+                                             1e-20);
+    std::vector<std::int32_t> off_process;
+    for (std::size_t i = 0; i < not_found.size(); ++i)
+    {
+      if (remaining_collisions[i] != -1)
+        local_cell_collisions[not_found[i]] = remaining_collisions[i];
+      else
+        off_process.push_back(not_found[i]);
+    }
+
+    // Compute the processes whose bounding box contains the points that are
+    // not found on this process
+    auto process_tree = tree->create_global_tree(mesh->comm());
+    xt::xtensor<double, 2> off_process_points({off_process.size(), 3});
+    for (std::size_t i = 0; i < off_process.size(); ++i)
+      xt::row(off_process_points, i) = xt::row(mapped_T, off_process[i]);
+    dolfinx::graph::AdjacencyList<std::int32_t> process_collisions
+        = dolfinx::geometry::compute_collisions(process_tree,
+                                                off_process_points);
+    for (std::size_t i = 0; i < off_process.size(); ++i)
+      bbox_offsets[off_process[i] + 1] = process_collisions.num_links((int)i);
+    std::partial_sum(bbox_offsets.begin(), bbox_offsets.end(),
+                     bbox_offsets.begin());
+    bbox_data = process_collisions.array();
+  }
+  dolfinx::graph::AdjacencyList<std::int32_t> colliding_bbox_processes(
+      std::move(bbox_data), std::move(bbox_offsets));
 
-  std::vector<std::int32_t> local_cell_collisions
-      = dolfinx_mpc::find_local_collisions(*mesh, tree, mapped_T, 1e-20);
   dolfinx::common::Timer t0("~~Periodic: Local cell and eval basis");
   xt::xtensor<double, 3> tabulated_basis_values
-      = dolfinx_mpc::evaluate_basis_functions(V, mapped_T,
-                                              local_cell_collisions);
+      = vertex_masters ? dolfinx_mpc::evaluate_vertex_basis_functions(
+            V, mapped_T, local_cell_collisions)
+                       : dolfinx_mpc::evaluate_basis_functions(
+                           V, mapped_T, local_cell_collisions);
   t0.stop();
   // Create output arrays
   std::vector<std::int32_t> slaves;
@@ -338,11 +430,17 @@ dolfinx_mpc::mpc_data _create_periodic_condition(
   std::vector<std::int32_t> num_masters_per_slave_remote;
   num_masters_per_slave_remote.reserve(bs * coords_recv.size() / 3);
 
+  // No points are received if the trees were not built
+  assert(tree or coords_recv.shape(0) == 0);
   std::vector<std::int32_t> remote_cell_collisions
-      = dolfinx_mpc::find_local_collisions(*mesh, tree, coords_recv, 1e-20);
+      = tree ? dolfinx_mpc::find_local_collisions(*mesh, *tree, coords_recv,
+                                                  1e-20)
+             : std::vector<std::int32_t>();
   xt::xtensor<double, 3> remote_basis_values
-      = dolfinx_mpc::evaluate_basis_functions(V, coords_recv,
-                                              remote_cell_collisions);
+      = vertex_masters ? dolfinx_mpc::evaluate_vertex_basis_functions(
+            V, coords_recv, remote_cell_collisions)
+                       : dolfinx_mpc::evaluate_basis_functions(
+                           V, coords_recv, remote_cell_collisions);
 
   // Find remote masters and count how many to send to each process
   std::vector<std::int32_t> num_remote_masters(indegree, 0);
@@ -475,6 +573,7 @@ dolfinx_mpc::mpc_data _create_periodic_condition(
 /// @param[in] scale Scaling of the periodic condition
 /// @param[in] collapse If true, the list of marked dofs is in the collapsed
 /// input space
+/// @param[in] vertex_masters If true, only vertex dofs are used as masters
 /// @returns The multi point constraint
 template <typename T>
 dolfinx_mpc::mpc_data geometrical_condition(
@@ -484,7 +583,7 @@ dolfinx_mpc::mpc_data geometrical_condition(
     const std::function<xt::xarray<double>(const xt::xtensor<double, 2>&)>&
         relation,
     const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<T>>>& bcs,
-    double scale, bool collapse)
+    double scale, bool collapse, bool vertex_masters)
 {
   std::vector<std::int32_t> reduced_blocks;
   if (collapse)
@@ -507,7 +606,8 @@ dolfinx_mpc::mpc_data geometrical_condition(
     auto sub_map
         = [&parent_map](const std::int32_t& i) { return parent_map[i]; };
     return _create_periodic_condition<T>(V_sub, std::span(reduced_blocks),
-                                         relation, scale, sub_map, *V);
+                                         relation, scale, sub_map, *V, nullptr,
+                                         vertex_masters);
   }
   else
   {
@@ -522,7 +622,8 @@ dolfinx_mpc::mpc_data geometrical_condition(
         reduced_blocks.push_back(slave_blocks[i]);
     auto sub_map = [](const std::int32_t& dof) { return dof; };
     return _create_periodic_condition<T>(*V, std::span(reduced_blocks),
-                                         relation, scale, sub_map, *V);
+                                         relation, scale, sub_map, *V, nullptr,
+                                         vertex_masters);
   }
 }
 
@@ -538,6 +639,9 @@ dolfinx_mpc::mpc_data geometrical_condition(
 /// @param[in] scale Scaling of the periodic condition
 /// @param[in] collapse If true, the list of marked dofs is in the collapsed
 /// input space
+/// @param[in] candidate_cells Optional function mapping a cell containing a
+/// slave block to the cells that should be searched first for its masters
+/// @param[in] vertex_masters If true, only vertex dofs are used as masters
 /// @returns The multi point constraint
 template <typename T>
 dolfinx_mpc::mpc_data topological_condition(
@@ -547,7 +651,11 @@ dolfinx_mpc::mpc_data topological_condition(
     const std::function<xt::xarray<double>(const xt::xtensor<double, 2>&)>&
         relation,
     const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<T>>>& bcs,
-    double scale, bool collapse)
+    double scale, bool collapse,
+    const std::function<std::vector<std::int32_t>(std::int32_t)>&
+        candidate_cells
+    = nullptr,
+    bool vertex_masters = false)
 {
 
   std::vector<std::int32_t> entities = meshtag->find(tag);
@@ -574,7 +682,8 @@ dolfinx_mpc::mpc_data topological_condition(
         = [&parent_map](const std::int32_t& i) { return parent_map[i]; };
     // Create mpc on sub space
     dolfinx_mpc::mpc_data sub_data = _create_periodic_condition<T>(
-        V_sub, std::span(reduced_blocks), relation, scale, sub_map, *V);
+        V_sub, std::span(reduced_blocks), relation, scale, sub_map, *V,
+        candidate_cells, vertex_masters);
     return sub_data;
   }
   else
@@ -592,10 +701,147 @@ dolfinx_mpc::mpc_data topological_condition(
     const auto sub_map = [](const std::int32_t& dof) { return dof; };
 
     return _create_periodic_condition<T>(*V, std::span(reduced_blocks),
-                                         relation, scale, sub_map, *V);
+                                         relation, scale, sub_map, *V,
+                                         candidate_cells, vertex_masters);
   }
 };
 
+/// Create a function mapping a cell of a refined mesh to the children of the
+/// master cells of its parent cell, where the master cells are those
+/// containing a master of a slave in the parent cell
+/// @param[in] parent_mpc The multi point constraint on the parent mesh
+/// @param[in] parent_cells Map from each cell (local to process) of the
+/// refined mesh to its parent cell
+/// @param[in] num_cells The number of cells owned by the process in the
+/// refined mesh
+/// @returns The candidate cells (local to process) for a given cell
+template <typename U>
+std::function<std::vector<std::int32_t>(std::int32_t)>
+create_refined_candidate_map(
+    const dolfinx_mpc::MultiPointConstraint<U>& parent_mpc,
+    std::span<const std::int32_t> parent_cells, std::int32_t num_cells)
+{
+  std::shared_ptr<const dolfinx::fem::FunctionSpace> V_parent
+      = parent_mpc.function_space();
+  auto mesh = V_parent->mesh();
+  const int tdim = mesh->topology().dim();
+  auto cell_imap = mesh->topology().index_map(tdim);
+  const std::int32_t num_parent_cells
+      = cell_imap->size_local() + cell_imap->num_ghosts();
+  std::shared_ptr<const dolfinx::fem::DofMap> dofmap = V_parent->dofmap();
+  const int bs = dofmap->index_map_bs();
+  const std::int32_t num_blocks
+      = dofmap->index_map->size_local() + dofmap->index_map->num_ghosts();
+
+  // Create parent block -> parent cells map
+  std::vector<std::int32_t> block_offsets(num_blocks + 1, 0);
+  for (std::int32_t c = 0; c < num_parent_cells; ++c)
+    for (auto block : dofmap->cell_dofs(c))
+      block_offsets[block + 1]++;
+  std::partial_sum(block_offsets.begin(), block_offsets.end(),
+                   block_offsets.begin());
+  std::vector<std::int32_t> block_cells(block_offsets.back());
+  {
+    std::vector<std::int32_t> insert_pos(block_offsets.begin(),
+                                         std::prev(block_offsets.end()));
+    for (std::int32_t c = 0; c < num_parent_cells; ++c)
+      for (auto block : dofmap->cell_dofs(c))
+        block_cells[insert_pos[block]++] = c;
+  }
+
+  // Pair each parent slave block with its master blocks
+  std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>> masters
+      = parent_mpc.masters();
+  std::vector<std::pair<std::int32_t, std::int32_t>> slave_to_master;
+  for (auto slave : parent_mpc.slaves())
+    for (auto master : masters->links(slave))
+      slave_to_master.push_back({slave / bs, master / bs});
+  std::sort(slave_to_master.begin(), slave_to_master.end());
+  slave_to_master.erase(
+      std::unique(slave_to_master.begin(), slave_to_master.end()),
+      slave_to_master.end());
+
+  // Create parent cell -> children map
+  const std::int32_t num_children
+      = std::min(num_cells, (std::int32_t)parent_cells.size());
+  std::vector<std::int32_t> child_offsets(num_parent_cells + 1, 0);
+  for (std::int32_t c = 0; c < num_children; ++c)
+    child_offsets[parent_cells[c] + 1]++;
+  std::partial_sum(child_offsets.begin(), child_offsets.end(),
+                   child_offsets.begin());
+  std::vector<std::int32_t> children(child_offsets.back());
+  {
+    std::vector<std::int32_t> insert_pos(child_offsets.begin(),
+                                         std::prev(child_offsets.end()));
+    for (std::int32_t c = 0; c < num_children; ++c)
+      children[insert_pos[parent_cells[c]]++] = c;
+  }
+
+  std::vector<std::int32_t> cell_to_parent(parent_cells.begin(),
+                                           parent_cells.begin() + num_children);
+  return [dofmap, cell_to_parent = std::move(cell_to_parent),
+          block_offsets = std::move(block_offsets),
+          block_cells = std::move(block_cells),
+          slave_to_master = std::move(slave_to_master),
+          child_offsets = std::move(child_offsets),
+          children = std::move(children)](std::int32_t cell)
+  {
+    std::vector<std::int32_t> candidates;
+    if (cell >= (std::int32_t)cell_to_parent.size())
+      return candidates;
+    for (auto block : dofmap->cell_dofs(cell_to_parent[cell]))
+    {
+      auto it = std::lower_bound(
+          slave_to_master.begin(), slave_to_master.end(),
+          std::pair(block, std::numeric_limits<std::int32_t>::min()));
+      for (; it != slave_to_master.end() and it->first == block; ++it)
+      {
+        const std::int32_t master_block = it->second;
+        for (std::int32_t j = block_offsets[master_block];
+             j < block_offsets[master_block + 1]; ++j)
+        {
+          const std::int32_t master_cell = block_cells[j];
+          candidates.insert(candidates.end(),
+                            std::next(children.begin(),
+                                      child_offsets[master_cell]),
+                            std::next(children.begin(),
+                                      child_offsets[master_cell + 1]));
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+    return candidates;
+  };
+}
+
+/// Create a periodic MPC on a refined mesh, where masters of each slave are
+/// first searched for among the children of the master cells of its parent
+/// cell. See `topological_condition` and `create_refined_candidate_map` for
+/// the input parameters.
+template <typename T>
+dolfinx_mpc::mpc_data refined_condition(
+    const std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    const std::shared_ptr<const dolfinx::mesh::MeshTags<std::int32_t>> meshtag,
+    const std::int32_t tag,
+    const std::function<xt::xarray<double>(const xt::xtensor<double, 2>&)>&
+        relation,
+    const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<T>>>& bcs,
+    double scale, bool collapse,
+    const dolfinx_mpc::MultiPointConstraint<PetscScalar>& parent_mpc,
+    std::span<const std::int32_t> parent_cells)
+{
+  dolfinx::common::Timer timer("~MPC: Create refined periodic constraint");
+  auto mesh = V->mesh();
+  const std::int32_t num_cells
+      = mesh->topology().index_map(mesh->topology().dim())->size_local();
+  auto candidate_cells
+      = create_refined_candidate_map(parent_mpc, parent_cells, num_cells);
+  return topological_condition<T>(V, meshtag, tag, relation, bcs, scale,
+                                  collapse, candidate_cells);
+}
+
 } // namespace
 
 dolfinx_mpc::mpc_data dolfinx_mpc::create_periodic_condition_geometrical(
@@ -606,10 +852,10 @@ dolfinx_mpc::mpc_data dolfinx_mpc::create_periodic_condition_geometrical(
         relation,
     const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<double>>>&
         bcs,
-    double scale, bool collapse)
+    double scale, bool collapse, bool vertex_masters)
 {
   return geometrical_condition<double>(V, indicator, relation, bcs, scale,
-                                       collapse);
+                                       collapse, vertex_masters);
 }
 
 dolfinx_mpc::mpc_data dolfinx_mpc::create_periodic_condition_geometrical(
@@ -621,10 +867,10 @@ dolfinx_mpc::mpc_data dolfinx_mpc::create_periodic_condition_geometrical(
     const std::vector<
         std::shared_ptr<const dolfinx::fem::DirichletBC<std::complex<double>>>>&
         bcs,
-    double scale, bool collapse)
+    double scale, bool collapse, bool vertex_masters)
 {
-  return geometrical_condition<std::complex<double>>(V, indicator, relation,
-                                                     bcs, scale, collapse);
+  return geometrical_condition<std::complex<double>>(
+      V, indicator, relation, bcs, scale, collapse, vertex_masters);
 }
 
 dolfinx_mpc::mpc_data dolfinx_mpc::create_periodic_condition_topological(
@@ -635,10 +881,10 @@ dolfinx_mpc::mpc_data dolfinx_mpc::create_periodic_condition_topological(
         relation,
     const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<double>>>&
         bcs,
-    double scale, bool collapse)
+    double scale, bool collapse, bool vertex_masters)
 {
   return topological_condition<double>(V, meshtag, tag, relation, bcs, scale,
-                                       collapse);
+                                       collapse, nullptr, vertex_masters);
 };
 
 dolfinx_mpc::mpc_data dolfinx_mpc::create_periodic_condition_topological(
@@ -650,8 +896,148 @@ dolfinx_mpc::mpc_data dolfinx_mpc::create_periodic_condition_topological(
     const std::vector<
         std::shared_ptr<const dolfinx::fem::DirichletBC<std::complex<double>>>>&
         bcs,
-    double scale, bool collapse)
+    double scale, bool collapse, bool vertex_masters)
+{
+  return topological_condition<std::complex<double>>(
+      V, meshtag, tag, relation, bcs, scale, collapse, nullptr,
+      vertex_masters);
+}
+
+dolfinx_mpc::mpc_data dolfinx_mpc::create_periodic_condition_refined(
+    const std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    const std::shared_ptr<const dolfinx::mesh::MeshTags<std::int32_t>> meshtag,
+    const std::int32_t tag,
+    const std::function<xt::xarray<double>(const xt::xtensor<double, 2>&)>&
+        relation,
+    const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<double>>>&
+        bcs,
+    double scale, bool collapse,
+    const std::shared_ptr<const MultiPointConstraint<PetscScalar>> parent_mpc,
+    std::span<const std::int32_t> parent_cells)
+{
+  return refined_condition<double>(V, meshtag, tag, relation, bcs, scale,
+                                   collapse, *parent_mpc, parent_cells);
+}
+
+dolfinx_mpc::mpc_data dolfinx_mpc::create_periodic_condition_refined(
+    const std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    const std::shared_ptr<const dolfinx::mesh::MeshTags<std::int32_t>> meshtag,
+    const std::int32_t tag,
+    const std::function<xt::xarray<double>(const xt::xtensor<double, 2>&)>&
+        relation,
+    const std::vector<
+        std::shared_ptr<const dolfinx::fem::DirichletBC<std::complex<double>>>>&
+        bcs,
+    double scale, bool collapse,
+    const std::shared_ptr<const MultiPointConstraint<PetscScalar>> parent_mpc,
+    std::span<const std::int32_t> parent_cells)
 {
-  return topological_condition<std::complex<double>>(V, meshtag, tag, relation,
-                                                     bcs, scale, collapse);
+  return refined_condition<std::complex<double>>(
+      V, meshtag, tag, relation, bcs, scale, collapse, *parent_mpc,
+      parent_cells);
+}
+//-----------------------------------------------------------------------------
+std::vector<PetscScalar> dolfinx_mpc::compute_periodic_coefficients(
+    const MultiPointConstraint<PetscScalar>& mpc,
+    std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    std::span<const double> points, double scale)
+{
+  dolfinx::common::Timer timer("~MPC: Recompute periodic coefficients");
+  const std::vector<std::int32_t>& slaves = mpc.slaves();
+  if (points.size() != 3 * slaves.size())
+    throw std::runtime_error("Expected one point per slave.");
+  std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>> masters
+      = mpc.masters();
+
+  std::shared_ptr<const dolfinx::fem::DofMap> dofmap = V->dofmap();
+  const int bs = dofmap->index_map_bs();
+  const std::int32_t num_blocks
+      = dofmap->index_map->size_local() + dofmap->index_map->num_ghosts();
+  std::shared_ptr<const dolfinx::mesh::Mesh> mesh = V->mesh();
+  std::shared_ptr<const dolfinx::common::IndexMap> cell_map
+      = mesh->topology().index_map(mesh->topology().dim());
+  const std::int32_t num_cells
+      = cell_map->size_local() + cell_map->num_ghosts();
+
+  // Map from each block to the cells containing it
+  std::vector<std::int32_t> block_offsets(num_blocks + 1, 0);
+  for (std::int32_t c = 0; c < num_cells; ++c)
+    for (auto block : dofmap->cell_dofs(c))
+      block_offsets[block + 1]++;
+  std::partial_sum(block_offsets.begin(), block_offsets.end(),
+                   block_offsets.begin());
+  std::vector<std::int32_t> block_cells(block_offsets.back());
+  {
+    std::vector<std::int32_t> insert_pos(block_offsets.begin(),
+                                         std::prev(block_offsets.end()));
+    for (std::int32_t c = 0; c < num_cells; ++c)
+      for (auto block : dofmap->cell_dofs(c))
+        block_cells[insert_pos[block]++] = c;
+  }
+
+  // Find a cell containing all masters of each slave
+  std::vector<std::int32_t> master_cells(slaves.size(), -1);
+  for (std::size_t i = 0; i < slaves.size(); ++i)
+  {
+    std::span<const std::int32_t> slave_masters = masters->links(slaves[i]);
+    if (slave_masters.empty())
+      continue;
+    if (std::any_of(slave_masters.begin(), slave_masters.end(),
+                    [bs, num_blocks](auto master)
+                    { return master / bs >= num_blocks; }))
+    {
+      throw std::runtime_error("Cannot recompute coefficients of masters "
+                               "that are not in the local cells.");
+    }
+    const std::int32_t first_block = slave_masters.front() / bs;
+    for (std::int32_t j = block_offsets[first_block];
+         j < block_offsets[first_block + 1]; ++j)
+    {
+      std::span<const std::int32_t> cell_blocks
+          = dofmap->cell_dofs(block_cells[j]);
+      if (std::all_of(slave_masters.begin(), slave_masters.end(),
+                      [&cell_blocks, bs](auto master)
+                      {
+                        return std::find(cell_blocks.begin(), cell_blocks.end(),
+                                         master / bs)
+                               != cell_blocks.end();
+                      }))
+      {
+        master_cells[i] = block_cells[j];
+        break;
+      }
+    }
+    if (master_cells[i] == -1)
+    {
+      throw std::runtime_error(
+          "Could not find a cell containing all masters of a slave.");
+    }
+  }
+
+  // Evaluate the basis functions of the master cells at the mapped points
+  xt::xtensor<double, 2> x({slaves.size(), 3});
+  std::copy(points.begin(), points.end(), x.begin());
+  xt::xtensor<double, 3> basis_values
+      = dolfinx_mpc::evaluate_basis_functions(*V, x, master_cells);
+
+  std::shared_ptr<const dolfinx::graph::AdjacencyList<PetscScalar>> coeffs
+      = mpc.coefficients();
+  const std::vector<std::int32_t>& offsets = coeffs->offsets();
+  std::vector<PetscScalar> new_coeffs(coeffs->array().size(), 0);
+  for (std::size_t i = 0; i < slaves.size(); ++i)
+  {
+    if (master_cells[i] == -1)
+      continue;
+    std::span<const std::int32_t> cell_blocks
+        = dofmap->cell_dofs(master_cells[i]);
+    std::span<const std::int32_t> slave_masters = masters->links(slaves[i]);
+    for (std::size_t k = 0; k < slave_masters.size(); ++k)
+    {
+      const auto j = std::distance(
+          cell_blocks.begin(), std::find(cell_blocks.begin(), cell_blocks.end(),
+                                         slave_masters[k] / bs));
+      new_coeffs[offsets[slaves[i]] + k] = scale * basis_values(i, j, 0);
+    }
+  }
+  return new_coeffs;
 }
@@ -20,7 +20,7 @@ mpc_data create_periodic_condition_geometrical(
         relation,
     const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<double>>>&
         bcs,
-    double scale, bool collapse);
+    double scale, bool collapse, bool vertex_masters = false);
 
 mpc_data create_periodic_condition_geometrical(
     const std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
@@ -31,7 +31,7 @@ mpc_data create_periodic_condition_geometrical(
     const std::vector<
         std::shared_ptr<const dolfinx::fem::DirichletBC<std::complex<double>>>>&
         bcs,
-    double scale, bool collapse);
+    double scale, bool collapse, bool vertex_masters = false);
 
 mpc_data create_periodic_condition_topological(
     const std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
@@ -41,7 +41,7 @@ mpc_data create_periodic_condition_topological(
         relation,
     const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<double>>>&
         bcs,
-    double scale, bool collapse);
+    double scale, bool collapse, bool vertex_masters = false);
 
 mpc_data create_periodic_condition_topological(
     const std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
@@ -52,5 +52,67 @@ mpc_data create_periodic_condition_topological(
     const std::vector<
         std::shared_ptr<const dolfinx::fem::DirichletBC<std::complex<double>>>>&
         bcs,
-    double scale, bool collapse);
+    double scale, bool collapse, bool vertex_masters = false);
+
+/// Create a periodic constraint on a refined mesh, given the constraint on
+/// the parent mesh. The masters of each slave is first searched for among
+/// the children of the master cells of its parent cell, and only slaves not
+/// found there are searched for globally.
+/// @param[in] V The function space on the refined mesh (possibly a sub
+/// space)
+/// @param[in] meshtag Meshtag on the refined mesh with the slave entities
+/// @param[in] tag The value of the slave entities in the mesh tag
+/// @param[in] relation Function relating coordinates of the slave surface
+/// to the master surface
+/// @param[in] bcs List of Dirichlet BCs on the input space
+/// @param[in] scale Scaling of the periodic condition
+/// @param[in] collapse If true, the list of marked dofs is in the collapsed
+/// input space
+/// @param[in] parent_mpc The (finalized) constraint on the parent mesh
+/// @param[in] parent_cells Map from each cell (local to process) of the
+/// refined mesh to its parent cell, as given by the refinement
+/// @returns The multi point constraint
+mpc_data create_periodic_condition_refined(
+    const std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    const std::shared_ptr<const dolfinx::mesh::MeshTags<std::int32_t>> meshtag,
+    const std::int32_t tag,
+    const std::function<xt::xarray<double>(const xt::xtensor<double, 2>&)>&
+        relation,
+    const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<double>>>&
+        bcs,
+    double scale, bool collapse,
+    const std::shared_ptr<const MultiPointConstraint<PetscScalar>> parent_mpc,
+    std::span<const std::int32_t> parent_cells);
+
+mpc_data create_periodic_condition_refined(
+    const std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    const std::shared_ptr<const dolfinx::mesh::MeshTags<std::int32_t>> meshtag,
+    const std::int32_t tag,
+    const std::function<xt::xarray<double>(const xt::xtensor<double, 2>&)>&
+        relation,
+    const std::vector<
+        std::shared_ptr<const dolfinx::fem::DirichletBC<std::complex<double>>>>&
+        bcs,
+    double scale, bool collapse,
+    const std::shared_ptr<const MultiPointConstraint<PetscScalar>> parent_mpc,
+    std::span<const std::int32_t> parent_cells);
+
+/// Recompute the coefficients of a periodic constraint u(x_s) = scale *
+/// u(relation(x_s)) on a function space with the same dofmap as the
+/// constraint (see MultiPointConstraint::clone), for instance on a mesh
+/// with the same topology but other coordinates. The masters of each slave
+/// are kept, and their coefficients are the basis functions of a cell
+/// containing all the masters, evaluated at the mapped slave coordinate.
+/// Requires the constraint to be created on the full (non-mixed) space, with
+/// all masters on the process.
+/// @param[in] mpc The (finalized) constraint
+/// @param[in] V The function space on the new mesh
+/// @param[in] points The mapped coordinate of each slave, ordered as
+/// `mpc.slaves()`, shape (num_slaves, 3)
+/// @param[in] scale Scaling of the periodic condition
+/// @returns The coefficients, ordered as `mpc.coefficients()->array()`
+std::vector<PetscScalar> compute_periodic_coefficients(
+    const MultiPointConstraint<PetscScalar>& mpc,
+    std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    std::span<const double> points, double scale);
 } // namespace dolfinx_mpc
\ No newline at end of file
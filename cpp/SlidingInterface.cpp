@@ -0,0 +1,469 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#include "SlidingInterface.h"
+#include <algorithm>
+#include <cmath>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <numbers>
+#include <numeric>
+
+namespace
+{
+
+/// Gather data of varying size from all processes on all processes
+/// @param[in] comm The MPI communicator
+/// @param[in] local_data The data of this process
+/// @returns The data of all processes, ordered by rank
+template <typename T>
+std::vector<T> all_gather(MPI_Comm comm, const std::vector<T>& local_data)
+{
+  const int size = dolfinx::MPI::size(comm);
+  const int num_local = (int)local_data.size();
+  std::vector<int> counts(size);
+  MPI_Allgather(&num_local, 1, MPI_INT, counts.data(), 1, MPI_INT, comm);
+  std::vector<int> displs(size + 1, 0);
+  std::partial_sum(counts.begin(), counts.end(), displs.begin() + 1);
+  std::vector<T> data(displs.back());
+  MPI_Allgatherv(local_data.data(), num_local, dolfinx::MPI::mpi_type<T>(),
+                 data.data(), counts.data(), displs.data(),
+                 dolfinx::MPI::mpi_type<T>(), comm);
+  return data;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+dolfinx_mpc::SlidingInterface::SlidingInterface(
+    std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+    const dolfinx::mesh::MeshTags<std::int32_t>& meshtags,
+    std::int32_t slave_marker, std::int32_t master_marker,
+    std::array<double, 3> origin, std::array<double, 3> axis, double tol)
+    : _V(V), _slave_to_neighbor(0), _tol(tol)
+{
+  dolfinx::common::Timer timer("~MPC: Create sliding interface");
+  std::shared_ptr<const dolfinx::mesh::Mesh> mesh = V->mesh();
+  MPI_Comm comm = mesh->comm();
+  const int rank = dolfinx::MPI::rank(comm);
+  const int tdim = mesh->topology().dim();
+  const int fdim = tdim - 1;
+  if (meshtags.dim() != fdim)
+    throw std::runtime_error("Meshtags have to be defined on facets.");
+
+  // Check that the dofs of the space are at the vertices
+  std::shared_ptr<const dolfinx::fem::DofMap> dofmap = V->dofmap();
+  const dolfinx::fem::ElementDofLayout& layout = dofmap->element_dof_layout();
+  const dolfinx::mesh::CellType facet_type = dolfinx::mesh::cell_entity_type(
+      mesh->topology().cell_type(), fdim, 0);
+  _num_facet_vertices = dolfinx::mesh::num_cell_vertices(facet_type);
+  if ((facet_type != dolfinx::mesh::CellType::interval
+       and facet_type != dolfinx::mesh::CellType::triangle)
+      or layout.num_entity_dofs(0) != 1
+      or layout.entity_closure_dofs(fdim, 0).size() != _num_facet_vertices)
+  {
+    throw std::runtime_error("Sliding interfaces are only supported for first "
+                             "order Lagrange spaces with interval or "
+                             "triangular facets.");
+  }
+
+  // Create an orthonormal frame (e0, e1, axis) for the rotation axis
+  const double axis_norm = std::sqrt(
+      std::inner_product(axis.begin(), axis.end(), axis.begin(), 0.0));
+  if (axis_norm == 0)
+    throw std::runtime_error("The rotation axis cannot be zero.");
+  std::for_each(axis.begin(), axis.end(),
+                [axis_norm](auto& a) { a /= axis_norm; });
+  const std::size_t min_index = std::distance(
+      axis.begin(), std::min_element(axis.begin(), axis.end(),
+                                     [](auto a, auto b)
+                                     { return std::abs(a) < std::abs(b); }));
+  std::array<double, 3> e0 = {0, 0, 0};
+  e0[min_index] = 1;
+  for (std::size_t i = 0; i < 3; ++i)
+    e0[i] -= axis[min_index] * axis[i];
+  const double e0_norm
+      = std::sqrt(std::inner_product(e0.begin(), e0.end(), e0.begin(), 0.0));
+  std::for_each(e0.begin(), e0.end(), [e0_norm](auto& e) { e /= e0_norm; });
+  const std::array<double, 3> e1 = {axis[1] * e0[2] - axis[2] * e0[1],
+                                    axis[2] * e0[0] - axis[0] * e0[2],
+                                    axis[0] * e0[1] - axis[1] * e0[0]};
+
+  // Compute the angle and axial position of the ith column of a set of
+  // coordinates
+  auto parametrize = [&origin, &axis, &e0, &e1](
+                         const xt::xtensor<double, 2>& x, std::size_t i,
+                         double* p)
+  {
+    double r0 = 0;
+    double r1 = 0;
+    double z = 0;
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      const double r = x(j, i) - origin[j];
+      r0 += r * e0[j];
+      r1 += r * e1[j];
+      z += r * axis[j];
+    }
+    p[0] = std::atan2(r1, r0);
+    p[1] = z;
+  };
+
+  // Find the owned blocks on the slave facets and the blocks of the owned
+  // master facets, with a cell containing each of them
+  mesh->topology_mutable().create_connectivity(fdim, tdim);
+  mesh->topology_mutable().create_connectivity(tdim, fdim);
+  auto f_to_c = mesh->topology().connectivity(fdim, tdim);
+  auto c_to_f = mesh->topology().connectivity(tdim, fdim);
+  const std::int32_t num_owned_facets
+      = mesh->topology().index_map(fdim)->size_local();
+  std::shared_ptr<const dolfinx::common::IndexMap> imap = dofmap->index_map;
+  const std::int32_t size_local = imap->size_local();
+  std::vector<std::int8_t> is_slave_block(size_local, 0);
+  std::vector<std::int32_t> slave_cells;
+  std::vector<std::int32_t> master_blocks;
+  std::vector<std::int32_t> master_cells;
+  for (std::size_t i = 0; i < meshtags.indices().size(); ++i)
+  {
+    const std::int32_t value = meshtags.values()[i];
+    const std::int32_t facet = meshtags.indices()[i];
+    if ((value != slave_marker and value != master_marker)
+        or (value == master_marker and facet >= num_owned_facets))
+    {
+      continue;
+    }
+    const std::int32_t cell = f_to_c->links(facet).front();
+    auto cell_facets = c_to_f->links(cell);
+    const auto local_facet = std::distance(
+        cell_facets.begin(),
+        std::find(cell_facets.begin(), cell_facets.end(), facet));
+    auto cell_blocks = dofmap->cell_dofs(cell);
+    for (auto j : layout.entity_closure_dofs(fdim, (int)local_facet))
+    {
+      const std::int32_t block = cell_blocks[j];
+      if (value == master_marker)
+      {
+        master_blocks.push_back(block);
+        master_cells.push_back(cell);
+      }
+      else if (block < size_local and !is_slave_block[block])
+      {
+        is_slave_block[block] = 1;
+        _slave_blocks.push_back(block);
+        slave_cells.push_back(cell);
+      }
+    }
+  }
+
+  // Parametrize the slaves
+  {
+    const xt::xtensor<double, 2> x = dolfinx_mpc::tabulate_dof_coordinates(
+        *V, _slave_blocks, slave_cells);
+    _slave_coordinates.resize(2 * _slave_blocks.size());
+    for (std::size_t i = 0; i < _slave_blocks.size(); ++i)
+      parametrize(x, i, _slave_coordinates.data() + 2 * i);
+  }
+
+  // Parametrize the master facets, with continuous angles over each facet
+  const std::size_t nv = _num_facet_vertices;
+  std::vector<double> master_coordinates(2 * master_blocks.size());
+  {
+    const xt::xtensor<double, 2> x = dolfinx_mpc::tabulate_dof_coordinates(
+        *V, master_blocks, master_cells);
+    for (std::size_t i = 0; i < master_blocks.size(); ++i)
+      parametrize(x, i, master_coordinates.data() + 2 * i);
+    constexpr double pi = std::numbers::pi;
+    for (std::size_t f = 0; f < master_blocks.size() / nv; ++f)
+    {
+      const double theta0 = master_coordinates[2 * f * nv];
+      for (std::size_t v = 1; v < nv; ++v)
+      {
+        double& theta = master_coordinates[2 * (f * nv + v)];
+        if (theta - theta0 > pi)
+          theta -= 2 * pi;
+        else if (theta - theta0 < -pi)
+          theta += 2 * pi;
+      }
+    }
+  }
+  std::vector<std::int64_t> master_blocks_global(master_blocks.size());
+  imap->local_to_global(master_blocks, master_blocks_global);
+  std::vector<std::int32_t> master_owners(master_blocks.size());
+  const std::vector<int>& ghost_owners = imap->owners();
+  std::transform(master_blocks.begin(), master_blocks.end(),
+                 master_owners.begin(),
+                 [size_local, rank, &ghost_owners](auto block)
+                 {
+                   return block < size_local ? rank
+                                             : ghost_owners[block - size_local];
+                 });
+
+  // Gather the master interface on all processes
+  _facet_blocks = all_gather(comm, master_blocks_global);
+  _facet_owners = all_gather(comm, master_owners);
+  _facet_coordinates = all_gather(comm, master_coordinates);
+
+  // Compute the bounding box of each facet in the parameter space
+  const std::size_t num_facets = _facet_blocks.size() / nv;
+  std::vector<double> bboxes(4 * num_facets);
+  std::array<double, 2> x_min = {0, 0};
+  std::array<double, 2> x_max = {0, 0};
+  std::array<double, 2> mean_width = {0, 0};
+  for (std::size_t f = 0; f < num_facets; ++f)
+  {
+    for (std::size_t d = 0; d < 2; ++d)
+    {
+      double lo = _facet_coordinates[2 * f * nv + d];
+      double hi = lo;
+      for (std::size_t v = 1; v < nv; ++v)
+      {
+        lo = std::min(lo, _facet_coordinates[2 * (f * nv + v) + d]);
+        hi = std::max(hi, _facet_coordinates[2 * (f * nv + v) + d]);
+      }
+      const double eps = _tol * (hi - lo);
+      bboxes[4 * f + 2 * d] = lo - eps;
+      bboxes[4 * f + 2 * d + 1] = hi + eps;
+      x_min[d] = f == 0 ? lo - eps : std::min(x_min[d], lo - eps);
+      x_max[d] = f == 0 ? hi + eps : std::max(x_max[d], hi + eps);
+      mean_width[d] += (hi - lo) / num_facets;
+    }
+  }
+
+  // Create a lookup grid with cells of the mean facet size, with at most
+  // four grid cells per facet
+  const std::int64_t max_grid_cells
+      = std::max(4 * num_facets, std::size_t(1));
+  for (std::size_t d = 0; d < 2; ++d)
+  {
+    const double extent = x_max[d] - x_min[d];
+    _grid_n[d] = (extent > 0 and mean_width[d] > 0)
+                     ? (std::int32_t)std::min(
+                         std::ceil(extent / mean_width[d]),
+                         (double)std::max(num_facets, std::size_t(1)))
+                     : 1;
+  }
+  while ((std::int64_t)_grid_n[0] * _grid_n[1] > max_grid_cells)
+  {
+    const std::size_t d = _grid_n[0] > _grid_n[1] ? 0 : 1;
+    _grid_n[d] = (_grid_n[d] + 1) / 2;
+  }
+  for (std::size_t d = 0; d < 2; ++d)
+  {
+    const double extent = x_max[d] - x_min[d];
+    _grid_min[d] = x_min[d];
+    _grid_h[d] = extent > 0 ? extent / _grid_n[d] : 1;
+  }
+
+  // Insert each facet in the grid cells overlapping its bounding box
+  auto grid_range = [this, &bboxes](std::size_t f, std::size_t d)
+  {
+    auto index = [this, d](double x)
+    {
+      const double s = (x - _grid_min[d]) / _grid_h[d];
+      return std::clamp((std::int32_t)std::floor(s), 0, _grid_n[d] - 1);
+    };
+    return std::array<std::int32_t, 2>{index(bboxes[4 * f + 2 * d]),
+                                       index(bboxes[4 * f + 2 * d + 1])};
+  };
+  _grid_offsets.assign(_grid_n[0] * _grid_n[1] + 1, 0);
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    std::vector<std::int32_t> insert_pos;
+    if (pass == 1)
+    {
+      std::partial_sum(_grid_offsets.begin(), _grid_offsets.end(),
+                       _grid_offsets.begin());
+      _grid_facets.resize(_grid_offsets.back());
+      insert_pos.assign(_grid_offsets.begin(), std::prev(_grid_offsets.end()));
+    }
+    for (std::size_t f = 0; f < num_facets; ++f)
+    {
+      const std::array<std::int32_t, 2> r0 = grid_range(f, 0);
+      const std::array<std::int32_t, 2> r1 = grid_range(f, 1);
+      for (std::int32_t i = r0[0]; i <= r0[1]; ++i)
+      {
+        for (std::int32_t j = r1[0]; j <= r1[1]; ++j)
+        {
+          const std::int32_t cell = i * _grid_n[1] + j;
+          if (pass == 0)
+            _grid_offsets[cell + 1]++;
+          else
+            _grid_facets[insert_pos[cell]++] = (std::int32_t)f;
+        }
+      }
+    }
+  }
+
+  // Create the owner->ghost communicator and map the slaves (unrolled, in
+  // the order of create_constraint) to the processes ghosting them
+  const int bs = dofmap->index_map_bs();
+  std::vector<std::int32_t> slaves(bs * _slave_blocks.size());
+  for (std::size_t i = 0; i < _slave_blocks.size(); ++i)
+    for (int k = 0; k < bs; ++k)
+      slaves[bs * i + k] = bs * _slave_blocks[i] + k;
+  _owner_to_ghost = dolfinx_mpc::create_owner_to_ghost_comm(*imap);
+  _slave_to_neighbor
+      = dolfinx_mpc::compute_slave_to_neighbor(slaves, *imap, bs);
+}
+//-----------------------------------------------------------------------------
+dolfinx_mpc::SlidingInterface::~SlidingInterface()
+{
+  if (_owner_to_ghost != MPI_COMM_NULL)
+    MPI_Comm_free(&_owner_to_ghost);
+}
+//-----------------------------------------------------------------------------
+std::int32_t
+dolfinx_mpc::SlidingInterface::locate_facet(double theta, double z,
+                                            std::span<double> lambda) const
+{
+  constexpr double pi = std::numbers::pi;
+  const std::size_t nv = _num_facet_vertices;
+
+  // Index of the grid cell containing a coordinate, -1 if outside the grid
+  auto grid_index = [this](double x, std::size_t d) -> std::int32_t
+  {
+    const double s = (x - _grid_min[d]) / _grid_h[d];
+    if (s < -_tol or s > _grid_n[d] + _tol)
+      return -1;
+    return std::clamp((std::int32_t)std::floor(s), 0, _grid_n[d] - 1);
+  };
+  const std::int32_t z_index = grid_index(z, 1);
+  if (z_index == -1)
+    return -1;
+
+  // Facets crossing the cut of the angle at pi can contain the point
+  // shifted by a full rotation
+  for (double shift : {0.0, 2 * pi, -2 * pi})
+  {
+    const double t = theta + shift;
+    const std::int32_t t_index = grid_index(t, 0);
+    if (t_index == -1)
+      continue;
+    const std::int32_t cell = t_index * _grid_n[1] + z_index;
+    for (std::int32_t i = _grid_offsets[cell]; i < _grid_offsets[cell + 1];
+         ++i)
+    {
+      const std::int32_t f = _grid_facets[i];
+      const double* x = _facet_coordinates.data() + 2 * nv * f;
+      if (nv == 2)
+      {
+        // Interval in the angle
+        const double dt = x[2] - x[0];
+        if (dt == 0)
+          continue;
+        lambda[1] = (t - x[0]) / dt;
+        lambda[0] = 1 - lambda[1];
+      }
+      else
+      {
+        // Triangle in the angle-axial plane
+        const double a00 = x[2] - x[0];
+        const double a01 = x[4] - x[0];
+        const double a10 = x[3] - x[1];
+        const double a11 = x[5] - x[1];
+        const double det = a00 * a11 - a01 * a10;
+        if (det == 0)
+          continue;
+        const double b0 = t - x[0];
+        const double b1 = z - x[1];
+        lambda[1] = (a11 * b0 - a01 * b1) / det;
+        lambda[2] = (a00 * b1 - a10 * b0) / det;
+        lambda[0] = 1 - lambda[1] - lambda[2];
+      }
+      if (std::all_of(lambda.begin(), std::next(lambda.begin(), nv),
+                      [this](auto l) { return l >= -_tol; }))
+      {
+        return f;
+      }
+    }
+  }
+  return -1;
+}
+//-----------------------------------------------------------------------------
+dolfinx_mpc::mpc_data
+dolfinx_mpc::SlidingInterface::create_constraint(double angle) const
+{
+  dolfinx::common::Timer timer("~MPC: Sliding interface constraint");
+  std::shared_ptr<const dolfinx::common::IndexMap> imap
+      = _V->dofmap()->index_map;
+  const int bs = _V->dofmap()->index_map_bs();
+  const std::size_t nv = _num_facet_vertices;
+
+  // Pair each slave with the master facet containing its rotated position
+  std::vector<std::int32_t> slaves;
+  std::vector<std::int64_t> masters;
+  std::vector<PetscScalar> coeffs;
+  std::vector<std::int32_t> owners;
+  std::vector<std::int32_t> num_masters_per_slave;
+  slaves.reserve(bs * _slave_blocks.size());
+  num_masters_per_slave.reserve(bs * _slave_blocks.size());
+  std::vector<double> lambda(3);
+  for (std::size_t i = 0; i < _slave_blocks.size(); ++i)
+  {
+    const double theta = std::remainder(_slave_coordinates[2 * i] + angle,
+                                        2 * std::numbers::pi);
+    const std::int32_t f
+        = locate_facet(theta, _slave_coordinates[2 * i + 1], lambda);
+    if (f == -1)
+    {
+      throw std::runtime_error(
+          "Could not find a master facet for a slave of the sliding "
+          "interface.");
+    }
+    for (int k = 0; k < bs; ++k)
+    {
+      slaves.push_back(bs * _slave_blocks[i] + k);
+      std::int32_t num_masters = 0;
+      for (std::size_t v = 0; v < nv; ++v)
+      {
+        if (std::abs(lambda[v]) < 1e-14)
+          continue;
+        masters.push_back(bs * _facet_blocks[nv * f + v] + k);
+        owners.push_back(_facet_owners[nv * f + v]);
+        coeffs.push_back(lambda[v]);
+        num_masters++;
+      }
+      num_masters_per_slave.push_back(num_masters);
+    }
+  }
+
+  // Distribute ghost data over the communicator of the interface
+  dolfinx_mpc::mpc_data ghost_data
+      = dolfinx_mpc::distribute_ghost_data<PetscScalar>(
+          slaves, masters, coeffs, owners, num_masters_per_slave, imap, bs,
+          _owner_to_ghost, _slave_to_neighbor);
+
+  // Add ghost data to existing arrays
+  slaves.insert(slaves.end(), ghost_data.slaves.begin(),
+                ghost_data.slaves.end());
+  masters.insert(masters.end(), ghost_data.masters.begin(),
+                 ghost_data.masters.end());
+  num_masters_per_slave.insert(num_masters_per_slave.end(),
+                               ghost_data.offsets.begin(),
+                               ghost_data.offsets.end());
+  coeffs.insert(coeffs.end(), ghost_data.coeffs.begin(),
+                ghost_data.coeffs.end());
+  owners.insert(owners.end(), ghost_data.owners.begin(),
+                ghost_data.owners.end());
+
+  // Compute offsets
+  std::vector<std::int32_t> offsets(num_masters_per_slave.size() + 1, 0);
+  std::partial_sum(num_masters_per_slave.begin(), num_masters_per_slave.end(),
+                   offsets.begin() + 1);
+
+  dolfinx_mpc::mpc_data output;
+  output.slaves = slaves;
+  output.masters = masters;
+  output.coeffs = coeffs;
+  output.offsets = offsets;
+  output.owners = owners;
+  return output;
+}
+//-----------------------------------------------------------------------------
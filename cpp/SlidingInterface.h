@@ -0,0 +1,132 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#pragma once
+
+#include "utils.h"
+#include <array>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/MeshTags.h>
+#include <memory>
+#include <vector>
+
+namespace dolfinx_mpc
+{
+
+/// A sliding (rotor-stator) interface between a rotating and a fixed part of
+/// a mesh with coinciding cylindrical (or circular in 2D) interfaces. The
+/// constraint u_s = u_m ties the slave (rotating) side to the master (fixed)
+/// side for a given rotation angle.
+///
+/// The master facets are parametrized once by their angle and axial
+/// position with respect to the rotation axis, gathered on all processes
+/// and sorted into a lookup grid. Creating the constraint for a new angle
+/// then only requires a lookup for each slave, and the distribution of the
+/// slave data to the processes ghosting them, over a neighbourhood
+/// communicator created once with the interface.
+/// @note The master interface is replicated on every process (a global
+/// block, an owner and two coordinates per facet vertex, and the lookup
+/// grid), as a rotation can map a slave to any master facet. The memory per
+/// process therefore grows with the size of the interface (not the mesh).
+/// @note Only supported for first order Lagrange spaces (or blocked first
+/// order spaces, where each component of the slave is tied to the same
+/// component of the masters) with interval (2D) or triangular (3D) facets
+class SlidingInterface
+{
+public:
+  /// Create a sliding interface (collective)
+  /// @param[in] V The function space
+  /// @param[in] meshtags The meshtags of the interface facets
+  /// @param[in] slave_marker The marker of the facets on the rotating side
+  /// @param[in] master_marker The marker of the facets on the fixed side
+  /// @param[in] origin A point on the rotation axis
+  /// @param[in] axis The direction of the rotation axis. The rotation angle
+  /// is positive in the counter-clockwise direction around the axis
+  /// @param[in] tol The tolerance on the barycentric coordinates (in the
+  /// angle-axial parameter space) of a slave inside a master facet
+  SlidingInterface(std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+                   const dolfinx::mesh::MeshTags<std::int32_t>& meshtags,
+                   std::int32_t slave_marker, std::int32_t master_marker,
+                   std::array<double, 3> origin, std::array<double, 3> axis,
+                   double tol = 1e-10);
+
+  // Copy constructor (deleted)
+  SlidingInterface(const SlidingInterface& si) = delete;
+
+  // Assignment operator (deleted)
+  SlidingInterface& operator=(const SlidingInterface& si) = delete;
+
+  /// Destructor
+  ~SlidingInterface();
+
+  /// Create the constraint for a rotation of the slave side (collective)
+  /// @param[in] angle The rotation angle (in radians)
+  /// @returns The multi-point constraint data
+  mpc_data create_constraint(double angle) const;
+
+  /// Return the function space
+  std::shared_ptr<const dolfinx::fem::FunctionSpace> function_space() const
+  {
+    return _V;
+  }
+
+  /// Return the number of slave blocks owned by the process
+  std::size_t num_slave_blocks() const { return _slave_blocks.size(); }
+
+  /// Return the number of master facets (on all processes)
+  std::size_t num_master_facets() const
+  {
+    return _facet_blocks.size() / _num_facet_vertices;
+  }
+
+private:
+  /// Find the master facet containing a point in the parameter space
+  /// @param[in] theta The angle of the point in [-pi, pi]
+  /// @param[in] z The axial position of the point
+  /// @param[out] lambda The barycentric coordinates of the point in the facet
+  /// @returns The index of the facet, -1 if no facet contains the point
+  std::int32_t locate_facet(double theta, double z,
+                            std::span<double> lambda) const;
+
+  // The function space
+  std::shared_ptr<const dolfinx::fem::FunctionSpace> _V;
+
+  // Owned slave blocks and their angle and axial position, shape
+  // (num_slave_blocks, 2)
+  std::vector<std::int32_t> _slave_blocks;
+  std::vector<double> _slave_coordinates;
+
+  // Communicator from the owners to the processes ghosting the dofs, and
+  // the neighbourhood indices of the processes ghosting each (unrolled)
+  // slave, used to distribute the slave data for each angle
+  MPI_Comm _owner_to_ghost = MPI_COMM_NULL;
+  dolfinx::graph::AdjacencyList<std::int32_t> _slave_to_neighbor;
+
+  // Number of vertices per facet
+  std::size_t _num_facet_vertices;
+
+  // Global block, owner, angle and axial position of the vertices of all
+  // master facets. The angles of a facet are continuous, i.e. facets
+  // crossing the cut of the angle at pi have angles outside [-pi, pi)
+  std::vector<std::int64_t> _facet_blocks;
+  std::vector<std::int32_t> _facet_owners;
+  std::vector<double> _facet_coordinates;
+
+  // Lookup grid over the bounding box of the facets in the parameter
+  // space, where the facets overlapping grid cell i are
+  // _grid_facets[_grid_offsets[i]:_grid_offsets[i+1]]
+  std::array<double, 2> _grid_min;
+  std::array<double, 2> _grid_h;
+  std::array<std::int32_t, 2> _grid_n;
+  std::vector<std::int32_t> _grid_offsets;
+  std::vector<std::int32_t> _grid_facets;
+
+  // Tolerance for point location
+  double _tol;
+};
+
+} // namespace dolfinx_mpc
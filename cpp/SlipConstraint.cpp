@@ -13,13 +13,20 @@
 #include <xtensor/xview.hpp>
 using namespace dolfinx_mpc;
 
-mpc_data dolfinx_mpc::create_slip_condition(
+namespace
+{
+/// Create a slip condition, where blocks with a directional vector aligned
+/// with a coordinate axis (if tol > 0) are returned as Dirichlet dofs per
+/// component. See `create_slip_condition_with_dirichlet` for input
+/// parameters.
+std::pair<mpc_data, std::vector<std::vector<std::int32_t>>>
+slip_condition_impl(
     std::shared_ptr<dolfinx::fem::FunctionSpace>& space,
     const dolfinx::mesh::MeshTags<std::int32_t>& meshtags, std::int32_t marker,
     const dolfinx::fem::Function<PetscScalar>& v,
     std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>
         bcs,
-    const bool sub_space)
+    const bool sub_space, const double tol)
 {
   // Map from collapsed sub space to parent space
   std::function<const std::int32_t(const std::int32_t&)> parent_map;
@@ -112,6 +119,9 @@ mpc_data dolfinx_mpc::create_slip_condition(
   std::vector<std::int32_t> owners;
   std::vector<std::int32_t> offsets(1, 0);
 
+  // Dofs (per component) of blocks with an axis-aligned normal
+  std::vector<std::vector<std::int32_t>> dirichlet_dofs(num_normal_components);
+
   // Temporary arrays used to hold information about masters
   std::vector<std::int64_t> pair_m;
   for (auto block : slave_blocks)
@@ -126,6 +136,22 @@ mpc_data dolfinx_mpc::create_slip_condition(
 
     std::int32_t parent_slave
         = parent_map(block * num_normal_components + slave_index);
+
+    // If all other components are negligible, the constraint reduces to
+    // zeroing the slave component
+    if (const double max_normal = std::abs(normal[slave_index]);
+        tol > 0 and max_normal > 0)
+    {
+      bool axis_aligned = true;
+      for (std::int32_t i = 0; i < num_normal_components; ++i)
+        if (i != slave_index and std::abs(normal[i]) > tol * max_normal)
+          axis_aligned = false;
+      if (axis_aligned)
+      {
+        dirichlet_dofs[slave_index].push_back(parent_slave);
+        continue;
+      }
+    }
     slaves.push_back(parent_slave);
 
     std::vector<std::int32_t> parent_masters;
@@ -173,5 +199,35 @@ mpc_data dolfinx_mpc::create_slip_condition(
   data.offsets = offsets;
   data.owners = owners;
   data.coeffs = coeffs;
-  return data;
-}
\ No newline at end of file
+  return {std::move(data), std::move(dirichlet_dofs)};
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+mpc_data dolfinx_mpc::create_slip_condition(
+    std::shared_ptr<dolfinx::fem::FunctionSpace>& space,
+    const dolfinx::mesh::MeshTags<std::int32_t>& meshtags, std::int32_t marker,
+    const dolfinx::fem::Function<PetscScalar>& v,
+    std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>
+        bcs,
+    const bool sub_space)
+{
+  return slip_condition_impl(space, meshtags, marker, v, bcs, sub_space, -1)
+      .first;
+}
+//-----------------------------------------------------------------------------
+std::pair<mpc_data, std::vector<std::vector<std::int32_t>>>
+dolfinx_mpc::create_slip_condition_with_dirichlet(
+    std::shared_ptr<dolfinx::fem::FunctionSpace>& space,
+    const dolfinx::mesh::MeshTags<std::int32_t>& meshtags, std::int32_t marker,
+    const dolfinx::fem::Function<PetscScalar>& v,
+    std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>
+        bcs,
+    const bool sub_space, const double tol)
+{
+  if (tol <= 0)
+    throw std::runtime_error("Tolerance for axis-aligned blocks has to be "
+                             "positive.");
+  return slip_condition_impl(space, meshtags, marker, v, bcs, sub_space, tol);
+}
+//-----------------------------------------------------------------------------
\ No newline at end of file
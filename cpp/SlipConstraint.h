@@ -20,4 +20,28 @@ mpc_data create_slip_condition(
         bcs,
     const bool sub_space);
 
+/// Create a slip condition dot(u, v)=0 where blocks with v aligned with a
+/// coordinate axis are returned as component-wise (homogeneous) Dirichlet
+/// conditions instead of multi-point constraints.
+/// @param[in] space The function space (possibly a sub space)
+/// @param[in] meshtags The meshtags
+/// @param[in] marker Marker for the facets to apply the condition to
+/// @param[in] v The directional vector (most commonly a normal vector)
+/// @param[in] bcs List of Dirichlet conditions (no slip condition is applied
+/// to these dofs)
+/// @param[in] sub_space True if `space` is a sub space
+/// @param[in] tol A block is considered axis-aligned if all but one
+/// component of v is smaller than `tol` times the largest component
+/// @returns The multi-point constraint for the oblique blocks, and for each
+/// component of v the dofs (local to process, in the parent space) to be
+/// set to zero
+std::pair<mpc_data, std::vector<std::vector<std::int32_t>>>
+create_slip_condition_with_dirichlet(
+    std::shared_ptr<dolfinx::fem::FunctionSpace>& space,
+    const dolfinx::mesh::MeshTags<std::int32_t>& meshtags, std::int32_t marker,
+    const dolfinx::fem::Function<PetscScalar>& v,
+    std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>
+        bcs,
+    const bool sub_space, const double tol);
+
 } // namespace dolfinx_mpc
\ No newline at end of file
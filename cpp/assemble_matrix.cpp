@@ -5,19 +5,19 @@
 // SPDX-License-Identifier:    MIT
 
 #include "assemble_matrix.h"
+#include <algorithm>
 #include <assemble_utils.h>
 #include <dolfinx/fem/Constant.h>
 #include <dolfinx/fem/DirichletBC.h>
 #include <dolfinx/fem/assembler.h>
 #include <dolfinx/fem/utils.h>
-#include <xtensor/xtensor.hpp>
-#include <xtensor/xview.hpp>
 namespace
 {
 
 /// Given an assembled element matrix Ae, remove all entries (i,j) where both i
 /// and j corresponds to a slave degree of freedom
-/// @param[in] Ae The element matrix
+/// @param[out] Ae_stripped The stripped matrix (row-major)
+/// @param[in] Ae The element matrix (row-major)
 /// @param[in] num_dofs The number of degrees of freedom in each row and column
 /// (blocked)
 /// @param[in] bs The block size for the rows and columns
@@ -25,10 +25,9 @@ namespace
 /// degree of freedom
 /// @param[in] dofs Map from index local to cell to index local to process for
 /// rows rows and columns
-/// @returns The matrix stripped of slave contributions
 template <typename T>
-xt::xtensor<T, 2> create_stripped_matrix(
-    const xt::xtensor<T, 2>& Ae,
+void create_stripped_matrix(
+    std::span<T> Ae_stripped, std::span<const T> Ae,
     const std::array<const std::uint32_t, 2>& num_dofs,
     const std::array<const int, 2>& bs,
     const std::array<const std::vector<std::int8_t>, 2>& is_slave,
@@ -39,10 +38,8 @@ xt::xtensor<T, 2> create_stripped_matrix(
   const auto& [row_dofs, col_dofs] = dofs;
   const auto& [slave_rows, slave_cols] = is_slave;
 
-  const int ndim0 = row_bs * num_row_dofs;
   const int ndim1 = col_bs * num_col_dofs;
-  xt::xtensor<T, 2> Ae_stripped = xt::empty<T>({ndim0, ndim1});
-  assert(Ae.shape() == Ae_stripped.shape());
+  assert(Ae.size() == Ae_stripped.size());
 
   // Strip Ae of all entries where both i and j are slaves
   bool slave_row;
@@ -61,21 +58,34 @@ xt::xtensor<T, 2> create_stripped_matrix(
         {
           slave_col = slave_cols[col_block + col];
           const int l_col = j * col_bs + col;
-          Ae_stripped(l_row, l_col)
-              = (slave_row && slave_col) ? T(0.0) : Ae(l_row, l_col);
+          Ae_stripped[l_row * ndim1 + l_col]
+              = (slave_row && slave_col) ? T(0.0) : Ae[l_row * ndim1 + l_col];
         }
       }
     }
   }
-  return Ae_stripped;
 };
 
+/// Modify an element matrix for the multi point constraints, and insert the
+/// contributions to the masters into the global matrix
+/// @param[in] mat_set Function adding (unblocked) values to the matrix
+/// @param[in] num_dofs The number of degrees of freedom in each row and column
+/// (blocked)
+/// @param[in,out] Ae The element matrix (row-major)
+/// @param[in] dofs The dofs (blocked, local to process) of the rows and
+/// columns
+/// @param[in] bs The block size of the rows and columns
+/// @param[in] slaves The slaves in the cell for the rows and columns
+/// @param[in] masters The masters of the rows and columns constraints
+/// @param[in] coeffs The coefficients of the rows and columns constraints
+/// @param[in] is_slave Markers indicating if a dof is a slave
+/// @param[in,out] ws Work arrays
 template <typename T>
 void modify_mpc_cell(
     const std::function<int(const std::span<const std::int32_t>&,
                             const std::span<const std::int32_t>&,
                             const std::span<const T>)>& mat_set,
-    const std::array<const std::uint32_t, 2>& num_dofs, xt::xtensor<T, 2>& Ae,
+    const std::array<const std::uint32_t, 2>& num_dofs, std::span<T> Ae,
     const std::array<const std::span<const int32_t>, 2>& dofs,
     const std::array<const int, 2>& bs,
     const std::array<const std::span<const int32_t>, 2>& slaves,
@@ -84,40 +94,79 @@ void modify_mpc_cell(
         masters,
     const std::array<std::shared_ptr<const dolfinx::graph::AdjacencyList<T>>,
                      2>& coeffs,
-    const std::array<const std::vector<std::int8_t>, 2>& is_slave)
+    const std::array<const std::vector<std::int8_t>, 2>& is_slave,
+    dolfinx_mpc::AssemblyWorkspace<T>& ws)
 {
-  std::array<std::size_t, 2> num_flattened_masters = {0, 0};
-  std::array<std::vector<std::int32_t>, 2> local_index;
+  const int ndim0 = bs[0] * num_dofs[0];
+  const int ndim1 = bs[1] * num_dofs[1];
+  std::array<std::vector<std::int32_t>, 2>& local_index = ws.local_index;
   for (int axis = 0; axis < 2; ++axis)
   {
     // NOTE: Should this be moved into the MPC constructor?
     // Locate which local dofs are slave dofs and compute the local index of the
     // slave
-    local_index[axis] = dolfinx_mpc::compute_local_slave_index(
-        slaves[axis], num_dofs[axis], bs[axis], dofs[axis], is_slave[axis]);
-
-    // Count number of masters in flattened structure for the rows and columns
-    for (std::uint32_t i = 0; i < num_dofs[axis]; i++)
+    local_index[axis].resize(slaves[axis].size());
+    dolfinx_mpc::compute_local_slave_index(local_index[axis], slaves[axis],
+                                           num_dofs[axis], bs[axis], dofs[axis],
+                                           is_slave[axis]);
+
+    // Flatten slaves, masters and coeffs for efficient
+    // modification of the matrices
+    ws.flattened_masters[axis].clear();
+    ws.flattened_slaves[axis].clear();
+    ws.flattened_coeffs[axis].clear();
+    for (std::size_t i = 0; i < slaves[axis].size(); i++)
     {
-      for (int j = 0; j < bs[axis]; j++)
+      auto _masters = masters[axis]->links(slaves[axis][i]);
+      auto _coeffs = coeffs[axis]->links(slaves[axis][i]);
+      for (std::size_t j = 0; j < _masters.size(); j++)
       {
-        const std::int32_t dof = dofs[axis][i] * bs[axis] + j;
-        if (is_slave[axis][dof])
-          num_flattened_masters[axis] += masters[axis]->links(dof).size();
+        ws.flattened_slaves[axis].push_back(local_index[axis][i]);
+        ws.flattened_masters[axis].push_back(_masters[j]);
+        ws.flattened_coeffs[axis].push_back(_coeffs[j]);
       }
     }
+
+    // Unroll dof blocks
+    ws.unrolled_dofs[axis].resize(bs[axis] * num_dofs[axis]);
+    for (std::uint32_t j = 0; j < num_dofs[axis]; ++j)
+      for (int k = 0; k < bs[axis]; ++k)
+        ws.unrolled_dofs[axis][j * bs[axis] + k] = dofs[axis][j] * bs[axis] + k;
+  }
+  const std::array<std::vector<std::int32_t>, 2>& flattened_masters
+      = ws.flattened_masters;
+  const std::array<std::vector<std::int32_t>, 2>& flattened_slaves
+      = ws.flattened_slaves;
+  const std::array<std::vector<T>, 2>& flattened_coeffs = ws.flattened_coeffs;
+
+  // Data structures used for insertion of master contributions
+  std::array<std::int32_t, 1> row;
+  std::array<std::int32_t, 1> col;
+  std::array<T, 1> A0;
+
+  // Insert the master-master contributions from the slave-slave entries,
+  // which are the only entries of the original matrix needed after it is
+  // modified below
+  for (std::size_t i = 0; i < flattened_masters[0].size(); ++i)
+  {
+    // Loop through other masters on the same cell and add in contribution
+    for (std::size_t j = 0; j < flattened_masters[1].size(); ++j)
+    {
+      row[0] = flattened_masters[0][i];
+      col[0] = flattened_masters[1][j];
+      A0[0] = flattened_coeffs[0][i] * flattened_coeffs[1][j]
+              * Ae[flattened_slaves[0][i] * ndim1 + flattened_slaves[1][j]];
+      mat_set(row, col, A0);
+    }
   }
 
-  // Create copy to use for distribution to master dofs
-  xt::xtensor<T, 2> Ae_original = Ae;
   // Build matrix where all slave-slave entries are 0 for usage to row and
   // column addition
-  xt::xtensor<T, 2> Ae_stripped
-      = create_stripped_matrix<T>(Ae, num_dofs, bs, is_slave, dofs);
+  ws.Ae_stripped.resize(Ae.size());
+  create_stripped_matrix<T>(ws.Ae_stripped, Ae, num_dofs, bs, is_slave, dofs);
+  const std::vector<T>& Ae_stripped = ws.Ae_stripped;
 
   // Zero out slave entries in element matrix
-  const int ndim0 = bs[0] * num_dofs[0];
-  const int ndim1 = bs[1] * num_dofs[1];
   // Zero slave row
   std::for_each(local_index[0].cbegin(), local_index[0].cend(),
                 [&Ae, ndim1](const auto dof) {
@@ -131,89 +180,88 @@ void modify_mpc_cell(
                     Ae[row * ndim1 + dof] = 0.0;
                 });
 
-  // Flatten slaves, masters and coeffs for efficient
-  // modification of the matrices
-  std::array<std::vector<std::int32_t>, 2> flattened_masters;
-  std::array<std::vector<std::int32_t>, 2> flattened_slaves;
-  std::array<std::vector<T>, 2> flattened_coeffs;
-  for (std::int8_t axis = 0; axis < 2; axis++)
-  {
-    flattened_masters[axis].reserve(num_flattened_masters[axis]);
-    flattened_slaves[axis].reserve(num_flattened_masters[axis]);
-    flattened_coeffs[axis].reserve(num_flattened_masters[axis]);
-    for (std::size_t i = 0; i < slaves[axis].size(); i++)
-    {
-      auto _masters = masters[axis]->links(slaves[axis][i]);
-      auto _coeffs = coeffs[axis]->links(slaves[axis][i]);
-      for (std::size_t j = 0; j < _masters.size(); j++)
-      {
-        flattened_slaves[axis].push_back(local_index[axis][i]);
-        flattened_masters[axis].push_back(_masters[j]);
-        flattened_coeffs[axis].push_back(_coeffs[j]);
-      }
-    }
-  }
-  for (std::int8_t axis = 0; axis < 2; ++axis)
-    assert(num_flattened_masters[axis] == flattened_masters[axis].size());
-
-  // Data structures used for insertion of master contributions
-  std::array<std::int32_t, 1> row;
-  std::array<std::int32_t, 1> col;
-  std::array<T, 1> A0;
-  xt::xarray<T> Arow(ndim0);
-  xt::xarray<T> Acol(ndim1);
-
   // Loop over all masters for the MPC applied to rows.
   // Insert contributions in columns
-  std::vector<std::int32_t> unrolled_dofs(ndim1);
-  for (std::size_t i = 0; i < num_flattened_masters[0]; ++i)
+  ws.Acol.resize(ndim1);
+  for (std::size_t i = 0; i < flattened_masters[0].size(); ++i)
   {
-    Acol
-        = flattened_coeffs[0][i] * xt::row(Ae_stripped, flattened_slaves[0][i]);
-
-    // Unroll dof blocks
-    for (std::uint32_t j = 0; j < num_dofs[1]; ++j)
-      for (int k = 0; k < bs[1]; ++k)
-        unrolled_dofs[j * bs[1] + k] = dofs[1][j] * bs[1] + k;
+    const T coeff = flattened_coeffs[0][i];
+    const std::size_t offset = flattened_slaves[0][i] * ndim1;
+    for (int j = 0; j < ndim1; ++j)
+      ws.Acol[j] = coeff * Ae_stripped[offset + j];
 
     // Insert modified entries
     row[0] = flattened_masters[0][i];
-    mat_set(row, unrolled_dofs, Acol);
+    mat_set(row, ws.unrolled_dofs[1], ws.Acol);
   }
 
   // Loop over all masters for the MPC applied to columns.
   // Insert contributions in rows
-  unrolled_dofs.resize(ndim0);
-  for (std::size_t i = 0; i < num_flattened_masters[1]; ++i)
+  ws.Arow.resize(ndim0);
+  for (std::size_t i = 0; i < flattened_masters[1].size(); ++i)
   {
-    Arow
-        = flattened_coeffs[1][i] * xt::col(Ae_stripped, flattened_slaves[1][i]);
-
-    // Unroll dof blocks
-    for (std::uint32_t j = 0; j < num_dofs[0]; ++j)
-      for (int k = 0; k < bs[0]; ++k)
-        unrolled_dofs[j * bs[0] + k] = dofs[0][j] * bs[0] + k;
+    const T coeff = flattened_coeffs[1][i];
+    const std::int32_t slave_col = flattened_slaves[1][i];
+    for (int j = 0; j < ndim0; ++j)
+      ws.Arow[j] = coeff * Ae_stripped[j * ndim1 + slave_col];
 
     // Insert modified entries
     col[0] = flattened_masters[1][i];
-    mat_set(unrolled_dofs, col, Arow);
+    mat_set(ws.unrolled_dofs[0], col, ws.Arow);
   }
-
-  for (std::size_t i = 0; i < num_flattened_masters[0]; ++i)
+}
+//-----------------------------------------------------------------------------
+/// Zero the rows and columns of an element matrix that correspond to
+/// degrees of freedom with essential boundary conditions
+/// @param[in,out] Ae The element matrix (row-major)
+/// @param[in] cell The cell
+/// @param[in] dofs0 The dofs of the rows (blocked)
+/// @param[in] bs0 The block size of the rows
+/// @param[in] classification0 The classification of the row dofs
+/// @param[in] dofs1 The dofs of the columns (blocked)
+/// @param[in] bs1 The block size of the columns
+/// @param[in] classification1 The classification of the column dofs
+template <typename T>
+void zero_bc_entries(
+    std::span<T> Ae, std::int32_t cell, std::span<const std::int32_t> dofs0,
+    int bs0, const dolfinx_mpc::DofClassification<T>& classification0,
+    std::span<const std::int32_t> dofs1, int bs1,
+    const dolfinx_mpc::DofClassification<T>& classification1)
+{
+  const std::size_t ndim0 = bs0 * dofs0.size();
+  const std::size_t ndim1 = bs1 * dofs1.size();
+  if (classification0.has_bc(cell))
   {
-    // Loop through other masters on the same cell and add in contribution
-    for (std::size_t j = 0; j < num_flattened_masters[1]; ++j)
+    for (std::size_t i = 0; i < dofs0.size(); ++i)
     {
-
-      row[0] = flattened_masters[0][i];
-      col[0] = flattened_masters[1][j];
-      A0[0] = flattened_coeffs[0][i] * flattened_coeffs[1][j]
-              * Ae_original(flattened_slaves[0][i], flattened_slaves[1][j]);
-      mat_set(row, col, A0);
+      for (int k = 0; k < bs0; ++k)
+      {
+        if (classification0.is_bc(bs0 * dofs0[i] + k))
+        {
+          // Zero row bs0 * i + k
+          const int row = bs0 * i + k;
+          std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
+        }
+      }
     }
   }
-} // namespace
-
+  if (classification1.has_bc(cell))
+  {
+    for (std::size_t j = 0; j < dofs1.size(); ++j)
+    {
+      for (int k = 0; k < bs1; ++k)
+      {
+        if (classification1.is_bc(bs1 * dofs1[j] + k))
+        {
+          // Zero column bs1 * j + k
+          const int col = bs1 * j + k;
+          for (std::size_t row = 0; row < ndim0; ++row)
+            Ae[row * ndim1 + col] = 0.0;
+        }
+      }
+    }
+  }
+}
 //-----------------------------------------------------------------------------
 template <typename T>
 void assemble_exterior_facets(
@@ -233,15 +281,20 @@ void assemble_exterior_facets(
         void(const std::span<T>&, const std::span<const std::uint32_t>&,
              std::int32_t, int)>& apply_dof_transformation_to_transpose,
     const dolfinx::graph::AdjacencyList<std::int32_t>& dofmap1, int bs1,
-    const std::vector<std::int8_t>& bc0, const std::vector<std::int8_t>& bc1,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& kernel,
     const std::span<const T> coeffs, int cstride,
-    const std::vector<T>& constants,
+    std::span<const T> constants,
     const std::span<const std::uint32_t>& cell_info,
-    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc0,
-    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc1)
+    const dolfinx_mpc::DofClassification<T>& classification0,
+    const dolfinx_mpc::DofClassification<T>& classification1,
+    dolfinx_mpc::AssemblyWorkspace<T>& workspace)
 {
+  std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>> mpc0
+      = classification0.constraint();
+  std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>> mpc1
+      = classification1.constraint();
+
   // Get MPC data
   const std::array<
       std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>, 2>
@@ -250,7 +303,6 @@ void assemble_exterior_facets(
       coefficients = {mpc0->coefficients(), mpc1->coefficients()};
   const std::array<const std::vector<std::int8_t>, 2> is_slave
       = {mpc0->is_slave(), mpc1->is_slave()};
-
   const std::array<
       std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>, 2>
       cell_to_slaves = {mpc0->cell_to_slaves(), mpc1->cell_to_slaves()};
@@ -263,85 +315,74 @@ void assemble_exterior_facets(
   const int num_dofs_g = x_dofmap.num_links(0);
   std::span<const double> x_g = mesh.geometry().x();
 
-  // Iterate over all facets
-  std::vector<double> coordinate_dofs(3 * num_dofs_g);
   const auto num_dofs0 = (std::uint32_t)dofmap0.links(0).size();
   const auto num_dofs1 = (std::uint32_t)dofmap1.links(0).size();
   const std::uint32_t ndim0 = bs0 * num_dofs0;
   const std::uint32_t ndim1 = bs1 * num_dofs1;
   const std::array<const std::uint32_t, 2> num_dofs = {num_dofs0, num_dofs1};
   const std::array<const int, 2> bs = {bs0, bs1};
-  xt::xtensor<T, 2> Ae({ndim0, ndim1});
-  const std::span<T> _Ae(Ae);
 
-  for (std::size_t l = 0; l < facets.size(); l += 2)
+  // Iterate over the facets in batches. The geometry of the cells of a
+  // batch is gathered into a contiguous buffer, the kernel is called for
+  // each facet of the batch, and the element matrices of the batch are then
+  // modified for the constraints and inserted. The packed coefficients of a
+  // batch are contiguous, as they are ordered as the facets. The buffers and
+  // the work arrays of the MPC modification are taken from the workspace
+  constexpr std::size_t batch_size = dolfinx_mpc::assembly_batch_size;
+  const std::size_t Ae_size = ndim0 * ndim1;
+  const std::size_t num_facets = facets.size() / 2;
+  std::vector<double>& coordinate_dofs = workspace.coordinate_dofs;
+  coordinate_dofs.resize(3 * num_dofs_g * batch_size);
+  std::vector<T>& Ae_batch = workspace.element_tensors;
+  Ae_batch.resize(Ae_size * batch_size);
+  for (std::size_t f0 = 0; f0 < num_facets; f0 += batch_size)
   {
-
-    const std::int32_t cell = facets[l];
-    const int local_facet = facets[l + 1];
-
-    // Get cell vertex coordinates
-    std::span<const std::int32_t> x_dofs = x_dofmap.links(cell);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      std::copy_n(
-          std::next(x_g.begin(), 3 * x_dofs[i]),3,
-          std::next(coordinate_dofs.begin(), 3 * i));
-    }
-    // Tabulate tensor
-    std::fill(Ae.data(), Ae.data() + Ae.size(), 0);
-    kernel(Ae.data(), coeffs.data() + l / 2 * cstride, constants.data(),
-           coordinate_dofs.data(), &local_facet, nullptr);
-    apply_dof_transformation(_Ae, cell_info, cell, ndim1);
-    apply_dof_transformation_to_transpose(_Ae, cell_info, cell, ndim0);
-
-    // Zero rows/columns for essential bcs
-    std::span<const std::int32_t> dmap0 = dofmap0.links(cell);
-    std::span<const std::int32_t> dmap1 = dofmap1.links(cell);
-    if (!bc0.empty())
+    const std::size_t num_batch = std::min(batch_size, num_facets - f0);
+    std::span<const std::int32_t> batch
+        = facets.subspan(2 * f0, 2 * num_batch);
+    dolfinx_mpc::pack_coordinate_dofs(coordinate_dofs, x_dofmap, x_g, batch,
+                                      2);
+
+    // Tabulate the element matrices of the batch
+    std::fill_n(Ae_batch.begin(), Ae_size * num_batch, 0);
+    for (std::size_t k = 0; k < num_batch; ++k)
     {
-      for (std::uint32_t i = 0; i < num_dofs0; ++i)
-      {
-        for (int k = 0; k < bs0; ++k)
-        {
-          if (bc0[bs0 * dmap0[i] + k])
-          {
-            // Zero row bs0 * i + k
-            const int row = bs0 * i + k;
-            std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
-          }
-        }
-      }
+      const std::int32_t cell = batch[2 * k];
+      const int local_facet = batch[2 * k + 1];
+      std::span<T> Ae(Ae_batch.data() + k * Ae_size, Ae_size);
+      kernel(Ae.data(), coeffs.data() + (f0 + k) * cstride, constants.data(),
+             coordinate_dofs.data() + 3 * num_dofs_g * k, &local_facet,
+             nullptr);
+      apply_dof_transformation(Ae, cell_info, cell, ndim1);
+      apply_dof_transformation_to_transpose(Ae, cell_info, cell, ndim0);
     }
-    if (!bc1.empty())
+
+    // Apply the essential bcs and the constraints to the element matrices of
+    // the batch, and insert them
+    for (std::size_t k = 0; k < num_batch; ++k)
     {
-      for (std::size_t j = 0; j < num_dofs1; ++j)
+      const std::int32_t cell = batch[2 * k];
+      std::span<T> Ae(Ae_batch.data() + k * Ae_size, Ae_size);
+
+      // Zero rows/columns for essential bcs
+      std::span<const std::int32_t> dmap0 = dofmap0.links(cell);
+      std::span<const std::int32_t> dmap1 = dofmap1.links(cell);
+      zero_bc_entries<T>(Ae, cell, dmap0, bs0, classification0, dmap1, bs1,
+                         classification1);
+
+      // Modify local element matrix Ae and insert contributions into master
+      // locations
+      if (classification0.has_slave(cell) or classification1.has_slave(cell))
       {
-        for (int k = 0; k < bs1; ++k)
-        {
-          if (bc1[bs1 * dmap1[j] + k])
-          {
-            // Zero column bs1 * j + k
-            const int col = bs1 * j + k;
-            for (std::uint32_t row = 0; row < ndim0; ++row)
-              Ae[row * ndim1 + col] = 0.0;
-          }
-        }
+        const std::array<const std::span<const int32_t>, 2> slaves
+            = {cell_to_slaves[0]->links(cell), cell_to_slaves[1]->links(cell)};
+        const std::array<const std::span<const int32_t>, 2> dofs
+            = {dmap0, dmap1};
+        modify_mpc_cell<T>(mat_add_values, num_dofs, Ae, dofs, bs, slaves,
+                           masters, coefficients, is_slave, workspace);
       }
+      mat_add_block_values(dmap0, dmap1, Ae);
     }
-
-    // Modify local element matrix Ae and insert contributions into master
-    // locations
-    if ((cell_to_slaves[0]->num_links(cell) > 0)
-        || (cell_to_slaves[1]->num_links(cell) > 0))
-    {
-      const std::array<const std::span<const int32_t>, 2> slaves
-          = {cell_to_slaves[0]->links(cell), cell_to_slaves[1]->links(cell)};
-      const std::array<const std::span<const int32_t>, 2> dofs = {dmap0, dmap1};
-      modify_mpc_cell<T>(mat_add_values, num_dofs, Ae, dofs, bs, slaves,
-                         masters, coefficients, is_slave);
-    }
-    mat_add_block_values(dmap0, dmap1, Ae);
   }
 } // namespace
 //-----------------------------------------------------------------------------
@@ -363,15 +404,20 @@ void assemble_cells_impl(
                        const std::int32_t, const int)>
         apply_dof_transformation_to_transpose,
     const dolfinx::graph::AdjacencyList<std::int32_t>& dofmap1, int bs1,
-    const std::vector<std::int8_t>& bc0, const std::vector<std::int8_t>& bc1,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& kernel,
     const std::span<const T>& coeffs, int cstride,
-    const std::vector<T>& constants,
+    std::span<const T> constants,
     const std::span<const std::uint32_t>& cell_info,
-    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc0,
-    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc1)
+    const dolfinx_mpc::DofClassification<T>& classification0,
+    const dolfinx_mpc::DofClassification<T>& classification1,
+    dolfinx_mpc::AssemblyWorkspace<T>& workspace)
 {
+  std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>> mpc0
+      = classification0.constraint();
+  std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>> mpc1
+      = classification1.constraint();
+
   // Get MPC data
   const std::array<
       std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>, 2>
@@ -380,10 +426,8 @@ void assemble_cells_impl(
       coefficients = {mpc0->coefficients(), mpc1->coefficients()};
   const std::array<const std::vector<std::int8_t>, 2> is_slave
       = {mpc0->is_slave(), mpc1->is_slave()};
-
   const std::array<
-      const std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>,
-      2>
+      std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>, 2>
       cell_to_slaves = {mpc0->cell_to_slaves(), mpc1->cell_to_slaves()};
 
   // Prepare cell geometry
@@ -394,71 +438,70 @@ void assemble_cells_impl(
   const int num_dofs_g = x_dofmap.num_links(0);
   std::span<const double> x_g = geometry.x();
 
-  // Iterate over active cells
-  std::vector<double> coordinate_dofs(3 * num_dofs_g);
   const auto num_dofs0 = (std::uint32_t)dofmap0.links(0).size();
   const auto num_dofs1 = (std::uint32_t)dofmap1.links(0).size();
   const std::uint32_t ndim0 = num_dofs0 * bs0;
   const std::uint32_t ndim1 = num_dofs1 * bs1;
   const std::array<const std::uint32_t, 2> num_dofs = {num_dofs0, num_dofs1};
   const std::array<const int, 2> bs = {bs0, bs1};
-  xt::xtensor<T, 2> Ae({ndim0, ndim1});
-  const std::span<T> _Ae(Ae);
-  for (std::size_t c = 0; c < active_cells.size(); c++)
+
+  // Iterate over the active cells in batches. The geometry of a batch is
+  // gathered into a contiguous buffer, the kernel is called for each cell of
+  // the batch, and the element matrices of the batch are then modified for
+  // the constraints and inserted. The packed coefficients of a batch are
+  // contiguous, as they are ordered as the active cells. The buffers and the
+  // work arrays of the MPC modification are taken from the workspace
+  constexpr std::size_t batch_size = dolfinx_mpc::assembly_batch_size;
+  const std::size_t Ae_size = ndim0 * ndim1;
+  std::vector<double>& coordinate_dofs = workspace.coordinate_dofs;
+  coordinate_dofs.resize(3 * num_dofs_g * batch_size);
+  std::vector<T>& Ae_batch = workspace.element_tensors;
+  Ae_batch.resize(Ae_size * batch_size);
+  for (std::size_t c0 = 0; c0 < active_cells.size(); c0 += batch_size)
   {
-    const std::int32_t cell = active_cells[c];
-    // Get cell coordinates/geometry
-    std::span<const int32_t> x_dofs = x_dofmap.links(cell);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    const std::size_t num_batch
+        = std::min(batch_size, active_cells.size() - c0);
+    std::span<const std::int32_t> batch(active_cells.data() + c0, num_batch);
+    dolfinx_mpc::pack_coordinate_dofs(coordinate_dofs, x_dofmap, x_g, batch,
+                                      1);
+
+    // Tabulate the element matrices of the batch
+    std::fill_n(Ae_batch.begin(), Ae_size * num_batch, 0);
+    for (std::size_t k = 0; k < num_batch; ++k)
     {
-      std::copy_n(
-          std::next(x_g.begin(), 3 * x_dofs[i]),3,
-          std::next(coordinate_dofs.begin(), 3 * i));
+      std::span<T> Ae(Ae_batch.data() + k * Ae_size, Ae_size);
+      kernel(Ae.data(), coeffs.data() + (c0 + k) * cstride, constants.data(),
+             coordinate_dofs.data() + 3 * num_dofs_g * k, nullptr, nullptr);
+      apply_dof_transformation(Ae, cell_info, batch[k], ndim1);
+      apply_dof_transformation_to_transpose(Ae, cell_info, batch[k], ndim0);
     }
-    // Tabulate tensor
-    std::fill(Ae.data(), Ae.data() + Ae.size(), 0);
-    kernel(Ae.data(), coeffs.data() + c * cstride, constants.data(),
-           coordinate_dofs.data(), nullptr, nullptr);
-    apply_dof_transformation(_Ae, cell_info, cell, ndim1);
-    apply_dof_transformation_to_transpose(_Ae, cell_info, cell, ndim0);
-
-    // Zero rows/columns for essential bcs
-    std::span<const int32_t> dofs0 = dofmap0.links(cell);
-    std::span<const int32_t> dofs1 = dofmap1.links(cell);
-    if (!bc0.empty())
-    {
-      for (std::uint32_t i = 0; i < num_dofs0; ++i)
-      {
-        for (std::int32_t k = 0; k < bs0; ++k)
-        {
-          if (bc0[bs0 * dofs0[i] + k])
-            xt::row(Ae, bs0 * i + k).fill(0);
-        }
-      }
-    }
-    if (!bc1.empty())
+
+    // Apply the essential bcs and the constraints to the element matrices of
+    // the batch, and insert them
+    for (std::size_t k = 0; k < num_batch; ++k)
     {
-      for (std::uint32_t j = 0; j < num_dofs1; ++j)
+      const std::int32_t cell = batch[k];
+      std::span<T> Ae(Ae_batch.data() + k * Ae_size, Ae_size);
+
+      // Zero rows/columns for essential bcs
+      std::span<const int32_t> dofs0 = dofmap0.links(cell);
+      std::span<const int32_t> dofs1 = dofmap1.links(cell);
+      zero_bc_entries<T>(Ae, cell, dofs0, bs0, classification0, dofs1, bs1,
+                         classification1);
+
+      // Modify local element matrix Ae and insert contributions into master
+      // locations
+      if (classification0.has_slave(cell) or classification1.has_slave(cell))
       {
-        for (std::int32_t k = 0; k < bs1; ++k)
-        {
-          if (bc1[bs1 * dofs1[j] + k])
-            xt::col(Ae, bs1 * j + k) = xt::zeros<T>({num_dofs0 * bs0});
-        }
+        const std::array<const std::span<const int32_t>, 2> slaves
+            = {cell_to_slaves[0]->links(cell), cell_to_slaves[1]->links(cell)};
+        const std::array<const std::span<const int32_t>, 2> dofs
+            = {dofs0, dofs1};
+        modify_mpc_cell<T>(mat_add_values, num_dofs, Ae, dofs, bs, slaves,
+                           masters, coefficients, is_slave, workspace);
       }
+      mat_add_block_values(dofs0, dofs1, Ae);
     }
-    // Modify local element matrix Ae and insert contributions into master
-    // locations
-    if ((cell_to_slaves[0]->num_links(cell) > 0)
-        || (cell_to_slaves[1]->num_links(cell) > 0))
-    {
-      const std::array<const std::span<const int32_t>, 2> slaves
-          = {cell_to_slaves[0]->links(cell), cell_to_slaves[1]->links(cell)};
-      const std::array<const std::span<const int32_t>, 2> dofs = {dofs0, dofs1};
-      modify_mpc_cell<T>(mat_add_values, num_dofs, Ae, dofs, bs, slaves,
-                         masters, coefficients, is_slave);
-    }
-    mat_add_block_values(dofs0, dofs1, Ae);
   }
 }
 //-----------------------------------------------------------------------------
@@ -470,10 +513,12 @@ void assemble_matrix_impl(
     const std::function<int(const std::span<const std::int32_t>&,
                             const std::span<const std::int32_t>&,
                             const std::span<const T>)>& mat_add_values,
-    const dolfinx::fem::Form<T>& a, const std::vector<std::int8_t>& bc0,
-    const std::vector<std::int8_t>& bc1,
-    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc0,
-    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc1)
+    const dolfinx::fem::Form<T>& a, std::span<const T> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    const dolfinx_mpc::DofClassification<T>& classification0,
+    const dolfinx_mpc::DofClassification<T>& classification1,
+    dolfinx_mpc::AssemblyWorkspace<T>& workspace)
 {
   std::shared_ptr<const dolfinx::mesh::Mesh> mesh = a.mesh();
   assert(mesh);
@@ -489,13 +534,6 @@ void assemble_matrix_impl(
   const int bs0 = dofmap0->bs();
   const dolfinx::graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
   const int bs1 = dofmap1->bs();
-  // Prepare constants
-  const std::vector<T> constants = pack_constants(a);
-
-  // Prepare coefficients
-  auto coeff_vec = dolfinx::fem::allocate_coefficient_storage(a);
-  dolfinx::fem::pack_coefficients(a, coeff_vec);
-  auto coefficients = dolfinx::fem::make_coefficients_span(coeff_vec);
 
   std::shared_ptr<const dolfinx::fem::FiniteElement> element0
       = a.function_spaces().at(0)->element();
@@ -528,8 +566,8 @@ void assemble_matrix_impl(
     assemble_cells_impl<T>(
         mat_add_block_values, mat_add_values, mesh->geometry(), active_cells,
         apply_dof_transformation, dofs0, bs0,
-        apply_dof_transformation_to_transpose, dofs1, bs1, bc0, bc1, fn, coeffs,
-        cstride, constants, cell_info, mpc0, mpc1);
+        apply_dof_transformation_to_transpose, dofs1, bs1, fn, coeffs, cstride,
+        constants, cell_info, classification0, classification1, workspace);
   }
 
   for (int i : a.integral_ids(dolfinx::fem::IntegralType::exterior_facet))
@@ -541,8 +579,8 @@ void assemble_matrix_impl(
     assemble_exterior_facets<T>(mat_add_block_values, mat_add_values, *mesh,
                                 facets, apply_dof_transformation, dofs0, bs0,
                                 apply_dof_transformation_to_transpose, dofs1,
-                                bs1, bc0, bc1, fn, coeffs, cstride, constants,
-                                cell_info, mpc0, mpc1);
+                                bs1, fn, coeffs, cstride, constants, cell_info,
+                                classification0, classification1, workspace);
   }
 
   // if (a.num_integrals(dolfinx::fem::IntegralType::interior_facet) > 0)
@@ -573,54 +611,30 @@ void _assemble_matrix(
     const std::function<int(const std::span<const std::int32_t>&,
                             const std::span<const std::int32_t>&,
                             const std::span<const T>&)>& mat_add,
-    const dolfinx::fem::Form<T>& a,
-    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc0,
-    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc1,
-    const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<T>>>& bcs,
-    const T diagval)
+    const dolfinx::fem::Form<T>& a, std::span<const T> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    const dolfinx_mpc::DofClassification<T>& classification0,
+    const dolfinx_mpc::DofClassification<T>& classification1,
+    dolfinx_mpc::AssemblyWorkspace<T>& workspace, const T diagval)
 {
   dolfinx::common::Timer timer("~MPC: Assemble matrix (C++)");
-
-  // Index maps for dof ranges
-  std::shared_ptr<const dolfinx::common::IndexMap> map0
-      = a.function_spaces().at(0)->dofmap()->index_map;
-  std::shared_ptr<const dolfinx::common::IndexMap> map1
-      = a.function_spaces().at(1)->dofmap()->index_map;
-  int bs0 = a.function_spaces().at(0)->dofmap()->index_map_bs();
-  int bs1 = a.function_spaces().at(1)->dofmap()->index_map_bs();
-
-  // Build dof markers
-  std::vector<std::int8_t> dof_marker0, dof_marker1;
-  std::int32_t dim0 = bs0 * (map0->size_local() + map0->num_ghosts());
-  std::int32_t dim1 = bs1 * (map1->size_local() + map1->num_ghosts());
-  for (std::size_t k = 0; k < bcs.size(); ++k)
-  {
-    assert(bcs[k]);
-    assert(bcs[k]->function_space());
-    if (a.function_spaces().at(0)->contains(*bcs[k]->function_space()))
-    {
-      dof_marker0.resize(dim0, false);
-      bcs[k]->mark_dofs(dof_marker0);
-    }
-    if (a.function_spaces().at(1)->contains(*bcs[k]->function_space()))
-    {
-      dof_marker1.resize(dim1, false);
-      bcs[k]->mark_dofs(dof_marker1);
-    }
-  }
+  std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>> mpc0
+      = classification0.constraint();
+  std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>> mpc1
+      = classification1.constraint();
 
   // Assemble
-  assemble_matrix_impl<T>(mat_add_block, mat_add, a, dof_marker0, dof_marker1,
-                          mpc0, mpc1);
+  assemble_matrix_impl<T>(mat_add_block, mat_add, a, constants, coefficients,
+                          classification0, classification1, workspace);
 
   // Add diagval on diagonal for slave dofs
   if (mpc0->function_space() == mpc1->function_space())
   {
     const std::vector<std::int32_t>& slaves = mpc0->slaves();
     const std::int32_t num_local_slaves = mpc0->num_local_slaves();
-    std::vector<std::int32_t> diag_dof(1);
-    std::vector<T> diag_value(1);
-    diag_value[0] = diagval;
+    std::array<std::int32_t, 1> diag_dof;
+    const std::array<T, 1> diag_value = {diagval};
     for (std::int32_t i = 0; i < num_local_slaves; ++i)
     {
       diag_dof[0] = slaves[i];
@@ -629,6 +643,61 @@ void _assemble_matrix(
   }
   timer.stop();
 }
+//-----------------------------------------------------------------------------
+template <typename T>
+void _assemble_matrix(
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const T>&)>& mat_add_block,
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const T>&)>& mat_add,
+    const dolfinx::fem::Form<T>& a,
+    const dolfinx_mpc::DofClassification<T>& classification0,
+    const dolfinx_mpc::DofClassification<T>& classification1, const T diagval)
+{
+  // Pack constants and coefficients
+  const std::vector<T> constants = pack_constants(a);
+  auto coeff_vec = dolfinx::fem::allocate_coefficient_storage(a);
+  dolfinx::fem::pack_coefficients(a, coeff_vec);
+  dolfinx_mpc::AssemblyWorkspace<T> workspace;
+  _assemble_matrix<T>(mat_add_block, mat_add, a, std::span<const T>(constants),
+                      dolfinx::fem::make_coefficients_span(coeff_vec),
+                      classification0, classification1, workspace, diagval);
+}
+//-----------------------------------------------------------------------------
+template <typename T>
+void _assemble_matrix(
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const T>&)>& mat_add_block,
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const T>&)>& mat_add,
+    const dolfinx::fem::Form<T>& a,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc0,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc1,
+    const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<T>>>& bcs,
+    const T diagval)
+{
+  // Classify the dofs of the rows and columns. For square forms with the
+  // same constraint on rows and columns, a single classification is used
+  // for both
+  const dolfinx_mpc::DofClassification<T> classification0(
+      a.function_spaces().at(0), bcs, mpc0);
+  if (a.function_spaces().at(0) == a.function_spaces().at(1) and mpc0 == mpc1)
+  {
+    _assemble_matrix<T>(mat_add_block, mat_add, a, classification0,
+                        classification0, diagval);
+  }
+  else
+  {
+    const dolfinx_mpc::DofClassification<T> classification1(
+        a.function_spaces().at(1), bcs, mpc1);
+    _assemble_matrix<T>(mat_add_block, mat_add, a, classification0,
+                        classification1, diagval);
+  }
+}
 } // namespace
 //-----------------------------------------------------------------------------
 void dolfinx_mpc::assemble_matrix(
@@ -671,3 +740,85 @@ void dolfinx_mpc::assemble_matrix(
 {
   _assemble_matrix(mat_add_block, mat_add, a, mpc0, mpc1, bcs, diagval);
 }
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::assemble_matrix(
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const double>&)>& mat_add_block,
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const double>&)>& mat_add,
+    const dolfinx::fem::Form<double>& a, std::span<const double> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const double>, int>>& coefficients,
+    const dolfinx_mpc::DofClassification<double>& classification0,
+    const dolfinx_mpc::DofClassification<double>& classification1,
+    dolfinx_mpc::AssemblyWorkspace<double>& workspace, const double diagval)
+{
+  _assemble_matrix<double>(mat_add_block, mat_add, a, constants, coefficients,
+                           classification0, classification1, workspace,
+                           diagval);
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::assemble_matrix(
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const std::complex<double>>&)>&
+        mat_add_block,
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const std::complex<double>>&)>&
+        mat_add,
+    const dolfinx::fem::Form<std::complex<double>>& a,
+    std::span<const std::complex<double>> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const std::complex<double>>, int>>&
+        coefficients,
+    const dolfinx_mpc::DofClassification<std::complex<double>>&
+        classification0,
+    const dolfinx_mpc::DofClassification<std::complex<double>>&
+        classification1,
+    dolfinx_mpc::AssemblyWorkspace<std::complex<double>>& workspace,
+    const std::complex<double> diagval)
+{
+  _assemble_matrix<std::complex<double>>(mat_add_block, mat_add, a, constants,
+                                         coefficients, classification0,
+                                         classification1, workspace, diagval);
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::assemble_matrix(
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const double>&)>& mat_add_block,
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const double>&)>& mat_add,
+    const dolfinx::fem::Form<double>& a,
+    const dolfinx_mpc::DofClassification<double>& classification0,
+    const dolfinx_mpc::DofClassification<double>& classification1,
+    const double diagval)
+{
+  _assemble_matrix<double>(mat_add_block, mat_add, a, classification0,
+                           classification1, diagval);
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::assemble_matrix(
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const std::complex<double>>&)>&
+        mat_add_block,
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const std::complex<double>>&)>&
+        mat_add,
+    const dolfinx::fem::Form<std::complex<double>>& a,
+    const dolfinx_mpc::DofClassification<std::complex<double>>&
+        classification0,
+    const dolfinx_mpc::DofClassification<std::complex<double>>&
+        classification1,
+    const std::complex<double> diagval)
+{
+  _assemble_matrix<std::complex<double>>(mat_add_block, mat_add, a,
+                                         classification0, classification1,
+                                         diagval);
+}
@@ -5,10 +5,16 @@
 // SPDX-License-Identifier:    MIT
 #pragma once
 
+#include "DofClassification.h"
 #include "MultiPointConstraint.h"
+#include "assemble_utils.h"
+#include <dolfinx/common/IndexMap.h>
 #include <dolfinx/fem/DirichletBC.h>
 #include <dolfinx/fem/Form.h>
 #include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
 #include <xtensor/xcomplex.hpp>
 
 namespace dolfinx_mpc
@@ -70,4 +76,200 @@ void assemble_matrix(
         bcs,
     const std::complex<double> diagval = 1.0);
 
+//-----------------------------------------------------------------------------
+/// Assemble bilinear form into a matrix, using precomputed classifications
+/// of the row and column dofs
+/// @param[in] mat_add_block The function for adding block values into the
+/// matrix
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear from to assemble
+/// @param[in] classification0 The classification of the row dofs, holding
+/// the Dirichlet conditions and the constraint of the rows
+/// @param[in] classification1 The classification of the column dofs
+/// @param[in] diagval Value to set on diagonal of matrix for slave dofs
+/// (default=1)
+void assemble_matrix(
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const double>&)>& mat_add_block,
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const double>&)>& mat_add,
+    const dolfinx::fem::Form<double>& a,
+    const DofClassification<double>& classification0,
+    const DofClassification<double>& classification1,
+    const double diagval = 1.0);
+
+//-----------------------------------------------------------------------------
+/// Assemble bilinear form into a matrix, using precomputed classifications
+/// of the row and column dofs
+/// @param[in] mat_add_block The function for adding block values into the
+/// matrix
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear from to assemble
+/// @param[in] classification0 The classification of the row dofs, holding
+/// the Dirichlet conditions and the constraint of the rows
+/// @param[in] classification1 The classification of the column dofs
+/// @param[in] diagval Value to set on diagonal of matrix for slave dofs
+/// (default=1)
+void assemble_matrix(
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const std::complex<double>>&)>&
+        mat_add_block,
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const std::complex<double>>&)>&
+        mat_add,
+    const dolfinx::fem::Form<std::complex<double>>& a,
+    const DofClassification<std::complex<double>>& classification0,
+    const DofClassification<std::complex<double>>& classification1,
+    const std::complex<double> diagval = 1.0);
+
+//-----------------------------------------------------------------------------
+/// Assemble bilinear form into a matrix, using precomputed classifications
+/// of the row and column dofs, pre-packed constants and coefficients (see
+/// dolfinx::fem::pack_constants and dolfinx::fem::pack_coefficients) and
+/// reusable work arrays
+/// @param[in] mat_add_block The function for adding block values into the
+/// matrix
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear from to assemble
+/// @param[in] constants The packed constants of a
+/// @param[in] coefficients The packed coefficients of a
+/// @param[in] classification0 The classification of the row dofs, holding
+/// the Dirichlet conditions and the constraint of the rows
+/// @param[in] classification1 The classification of the column dofs
+/// @param[in,out] workspace The work arrays of the assembly
+/// @param[in] diagval Value to set on diagonal of matrix for slave dofs
+/// (default=1)
+void assemble_matrix(
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const double>&)>& mat_add_block,
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const double>&)>& mat_add,
+    const dolfinx::fem::Form<double>& a, std::span<const double> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const double>, int>>& coefficients,
+    const DofClassification<double>& classification0,
+    const DofClassification<double>& classification1,
+    AssemblyWorkspace<double>& workspace, const double diagval = 1.0);
+
+//-----------------------------------------------------------------------------
+/// Assemble bilinear form into a matrix, using precomputed classifications
+/// of the row and column dofs, pre-packed constants and coefficients (see
+/// dolfinx::fem::pack_constants and dolfinx::fem::pack_coefficients) and
+/// reusable work arrays
+/// @param[in] mat_add_block The function for adding block values into the
+/// matrix
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear from to assemble
+/// @param[in] constants The packed constants of a
+/// @param[in] coefficients The packed coefficients of a
+/// @param[in] classification0 The classification of the row dofs, holding
+/// the Dirichlet conditions and the constraint of the rows
+/// @param[in] classification1 The classification of the column dofs
+/// @param[in,out] workspace The work arrays of the assembly
+/// @param[in] diagval Value to set on diagonal of matrix for slave dofs
+/// (default=1)
+void assemble_matrix(
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const std::complex<double>>&)>&
+        mat_add_block,
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const std::complex<double>>&)>&
+        mat_add,
+    const dolfinx::fem::Form<std::complex<double>>& a,
+    std::span<const std::complex<double>> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const std::complex<double>>, int>>&
+        coefficients,
+    const DofClassification<std::complex<double>>& classification0,
+    const DofClassification<std::complex<double>>& classification1,
+    AssemblyWorkspace<std::complex<double>>& workspace,
+    const std::complex<double> diagval = 1.0);
+
+//-----------------------------------------------------------------------------
+/// Restrict a matrix insertion function to the upper triangular part of a
+/// symmetric matrix, i.e. only entries (i, j) where the global block index
+/// of i is less than or equal to the global block index of j are inserted.
+/// @param[in] set_fn The function for adding values into the matrix
+/// @param[in] index_map The index map of the rows and columns
+/// @param[in] bs The block size of the index map
+/// @param[in] blocked True if `set_fn` takes block indices (with bs x bs
+/// values per entry), false if it takes dof indices
+/// @returns The restricted insertion function
+template <typename T>
+std::function<int(const std::span<const std::int32_t>&,
+                  const std::span<const std::int32_t>&,
+                  const std::span<const T>&)>
+upper_triangular_fn(
+    const std::function<int(const std::span<const std::int32_t>&,
+                            const std::span<const std::int32_t>&,
+                            const std::span<const T>&)>& set_fn,
+    const dolfinx::common::IndexMap& index_map, int bs, bool blocked)
+{
+  const std::int32_t num_blocks
+      = index_map.size_local() + index_map.num_ghosts();
+  std::vector<std::int32_t> blocks(num_blocks);
+  std::iota(blocks.begin(), blocks.end(), 0);
+  auto global_blocks = std::make_shared<std::vector<std::int64_t>>(num_blocks);
+  index_map.local_to_global(blocks, *global_blocks);
+
+  // Number of values per index, and number of indices per block
+  const int value_bs = blocked ? bs : 1;
+  const int index_bs = blocked ? 1 : bs;
+  return [set_fn, global_blocks, value_bs, index_bs,
+          upper_cols = std::vector<std::int32_t>(),
+          upper_vals = std::vector<T>()](
+             const std::span<const std::int32_t>& rows,
+             const std::span<const std::int32_t>& cols,
+             const std::span<const T>& vals) mutable -> int
+  {
+    const std::vector<std::int64_t>& global = *global_blocks;
+    const std::size_t row_size = value_bs * cols.size();
+    for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+      const std::int64_t row = global[rows[i] / index_bs];
+      upper_cols.clear();
+      for (auto col : cols)
+        if (row <= global[col / index_bs])
+          upper_cols.push_back(col);
+      if (upper_cols.empty())
+        continue;
+
+      std::span<const T> row_vals
+          = vals.subspan(i * value_bs * row_size, value_bs * row_size);
+      int ierr;
+      if (upper_cols.size() == cols.size())
+        ierr = set_fn(rows.subspan(i, 1), cols, row_vals);
+      else
+      {
+        upper_vals.clear();
+        for (int k = 0; k < value_bs; ++k)
+        {
+          for (std::size_t j = 0; j < cols.size(); ++j)
+          {
+            if (row <= global[cols[j] / index_bs])
+            {
+              auto value = std::next(row_vals.begin(),
+                                     k * row_size + j * value_bs);
+              upper_vals.insert(upper_vals.end(), value,
+                                std::next(value, value_bs));
+            }
+          }
+        }
+        ierr = set_fn(rows.subspan(i, 1), upper_cols, upper_vals);
+      }
+      if (ierr != 0)
+        return ierr;
+    }
+    return 0;
+  };
+}
+
 } // namespace dolfinx_mpc
\ No newline at end of file
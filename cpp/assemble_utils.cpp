@@ -6,6 +6,7 @@
 
 #include "assemble_utils.h"
 #include <algorithm>
+#include <cassert>
 
 std::vector<std::int32_t> dolfinx_mpc::compute_local_slave_index(
     const std::span<const std::int32_t>& slaves, const std::uint32_t num_dofs,
@@ -13,7 +14,18 @@ std::vector<std::int32_t> dolfinx_mpc::compute_local_slave_index(
     const std::vector<std::int8_t>& is_slave)
 {
   std::vector<std::int32_t> local_index(slaves.size());
-
+  compute_local_slave_index(local_index, slaves, num_dofs, bs, cell_dofs,
+                            is_slave);
+  return local_index;
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::compute_local_slave_index(
+    std::span<std::int32_t> local_index,
+    const std::span<const std::int32_t>& slaves, const std::uint32_t num_dofs,
+    const int bs, const std::span<const std::int32_t> cell_dofs,
+    const std::vector<std::int8_t>& is_slave)
+{
+  assert(local_index.size() == slaves.size());
   for (std::uint32_t i = 0; i < num_dofs; i++)
     for (int j = 0; j < bs; j++)
     {
@@ -25,5 +37,26 @@ std::vector<std::int32_t> dolfinx_mpc::compute_local_slave_index(
         local_index[slave_index] = i * bs + j;
       }
     }
-  return local_index;
-};
\ No newline at end of file
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::pack_coordinate_dofs(
+    std::span<double> coordinate_dofs,
+    const dolfinx::graph::AdjacencyList<std::int32_t>& x_dofmap,
+    std::span<const double> x_g, std::span<const std::int32_t> entities,
+    std::size_t stride)
+{
+  // FIXME: Reconsider when using mixed topology (mixed celltypes)
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  assert(coordinate_dofs.size() >= 3 * num_dofs_g * entities.size() / stride);
+  for (std::size_t e = 0; e < entities.size() / stride; ++e)
+  {
+    std::span<const std::int32_t> x_dofs
+        = x_dofmap.links(entities[stride * e]);
+    double* cell_coords = coordinate_dofs.data() + 3 * num_dofs_g * e;
+    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    {
+      std::copy_n(std::next(x_g.begin(), 3 * x_dofs[i]), 3,
+                  std::next(cell_coords, 3 * i));
+    }
+  }
+}
@@ -5,12 +5,62 @@
 // SPDX-License-Identifier:    MIT
 
 #pragma once
+#include <array>
 #include <cstdint>
+#include <dolfinx/graph/AdjacencyList.h>
 #include <span>
 #include <utility>
 #include <vector>
 namespace dolfinx_mpc
 {
+/// Number of entities whose element tensors are tabulated together in the
+/// assembly loops
+constexpr std::size_t assembly_batch_size = 8;
+
+/// Work arrays of the assembly loops. The arrays are only grown by an
+/// assembly, such that repeated assemblies with the same workspace do not
+/// allocate memory for element tensors after the first call
+template <typename T>
+struct AssemblyWorkspace
+{
+  /// Coordinate dofs of a batch of entities
+  std::vector<double> coordinate_dofs;
+  /// Element tensors of a batch of entities
+  std::vector<T> element_tensors;
+  /// Copy of an element vector, used when moving slave contributions
+  std::vector<T> element_copy;
+  /// Element matrix used in the lifting
+  std::vector<T> element_matrix;
+  /// Values of the Dirichlet conditions used in the lifting
+  std::vector<T> bc_values;
+
+  /// Work arrays for the modification of element tensors of slave cells,
+  /// for the rows (0) and columns (1)
+  std::array<std::vector<std::int32_t>, 2> local_index;
+  std::array<std::vector<std::int32_t>, 2> flattened_masters;
+  std::array<std::vector<std::int32_t>, 2> flattened_slaves;
+  std::array<std::vector<T>, 2> flattened_coeffs;
+  std::array<std::vector<std::int32_t>, 2> unrolled_dofs;
+  std::vector<T> Ae_stripped;
+  std::vector<T> Arow;
+  std::vector<T> Acol;
+};
+
+/// Gather the coordinate dofs of a batch of cells into a contiguous buffer,
+/// where the coordinates of the ith cell start at 3 * num_dofs_g * i
+/// @param[in,out] coordinate_dofs The buffer, of size at least 3 * num_dofs_g
+/// times the number of entities
+/// @param[in] x_dofmap The geometry dofmap
+/// @param[in] x_g The geometry coordinates (padded to 3D)
+/// @param[in] entities The entities, where the cell of the ith entity is
+/// entities[stride * i]
+/// @param[in] stride The stride of each entity in entities
+void pack_coordinate_dofs(
+    std::span<double> coordinate_dofs,
+    const dolfinx::graph::AdjacencyList<std::int32_t>& x_dofmap,
+    std::span<const double> x_g, std::span<const std::int32_t> entities,
+    std::size_t stride);
+
 /// For a set of unrolled dofs (slaves) compute the index (local to the cell
 /// dofs)
 /// @param[in] slaves List of unrolled dofs
@@ -26,4 +76,20 @@ compute_local_slave_index(const std::span<const int32_t>& slaves,
                           const std::span<const int32_t> cell_dofs,
                           const std::vector<std::int8_t>& is_slave);
 
+/// For a set of unrolled dofs (slaves) compute the index (local to the cell
+/// dofs), without allocating memory
+/// @param[out] local_index Map from position in slaves array to dof local to
+/// the cell. Must have the same size as slaves
+/// @param[in] slaves List of unrolled dofs
+/// @param[in] num_dofs Number of dofs (blocked)
+/// @param[in] bs The block size
+/// @param[in] cell_dofs The cell dofs
+/// @param[in] is_slave Array indicating if any dof (unrolled, local to process)
+/// is a slave
+void compute_local_slave_index(std::span<std::int32_t> local_index,
+                               const std::span<const int32_t>& slaves,
+                               const std::uint32_t num_dofs, const int bs,
+                               const std::span<const int32_t> cell_dofs,
+                               const std::vector<std::int8_t>& is_slave);
+
 } // namespace dolfinx_mpc
@@ -5,17 +5,24 @@
 // SPDX-License-Identifier:    MIT
 
 #include "assemble_vector.h"
+#include "assemble_utils.h"
+#include <algorithm>
+#include <dolfinx/common/Timer.h>
 #include <dolfinx/fem/Constant.h>
 #include <dolfinx/fem/DirichletBC.h>
 #include <dolfinx/fem/assembler.h>
 #include <dolfinx/fem/utils.h>
+#include <dolfinx/la/petsc.h>
 #include <iostream>
 
 namespace
 {
 
 /// Assemble an integration kernel over a set of active entities, described
-/// through into vector of type T, and apply the multipoint constraint
+/// through into vector of type T, and apply the multipoint constraint. The
+/// entities are assembled in batches of dolfinx_mpc::assembly_batch_size
+/// entities, where the element vectors of a batch are tabulated together
+/// before they are modified for the constraint and added to b
 /// @param[in, out] b The vector to assemble into
 /// @param[in] active_entities The set of active entities.
 /// @param[in] dofmap The dofmap
@@ -23,8 +30,11 @@ namespace
 /// @param[in] mpc The multipoint constraint
 /// @param[in] fetch_cells Function that fetches the cell index for an entity
 /// in active_entities
-/// @param[in] assemble_local_element_matrix Function f(be, index) that
-/// assembles into a local element matrix for a given entity
+/// @param[in] assemble_local_element_vectors Function f(be, entities, index)
+/// that assembles the element vectors of a batch of entities into be, where
+/// the element vector of the ith entity starts at i * bs * num_dofs, and index
+/// is the position of the first entity of the batch in active_entities
+/// @param[in,out] workspace The work arrays of the assembly
 /// @tparam T Scalar type for vector
 /// @tparam e stride Stride for each entity in active_entities
 template <typename T, std::size_t estride>
@@ -36,7 +46,8 @@ void _assemble_entities_impl(
         fetch_cells,
     const std::function<void(std::span<T>, std::span<const std::int32_t>,
                              std::size_t)>
-        assemble_local_element_vector)
+        assemble_local_element_vectors,
+    dolfinx_mpc::AssemblyWorkspace<T>& workspace)
 {
 
   // Get MPC data
@@ -50,42 +61,140 @@ void _assemble_entities_impl(
 
   // NOTE: Assertion that all links have the same size (no P refinement)
   const int num_dofs = dofmap.links(0).size();
-  std::vector<T> be(bs * num_dofs);
-  const std::span<T> _be(be);
-  std::vector<T> be_copy(bs * num_dofs);
-  const std::span<T> _be_copy(be_copy);
+  const std::size_t ndim = bs * num_dofs;
+  constexpr std::size_t batch_size = dolfinx_mpc::assembly_batch_size;
+  std::vector<T>& be_batch = workspace.element_tensors;
+  be_batch.resize(ndim * batch_size);
+  std::vector<T>& be_copy = workspace.element_copy;
+  be_copy.resize(ndim);
+  const std::span<T> _be_copy(be_copy.data(), ndim);
 
-  // Assemble over all entities
-  for (std::size_t e = 0; e < active_entities.size(); e += estride)
+  // Assemble over all entities, one batch at a time
+  const std::size_t num_entities = active_entities.size() / estride;
+  for (std::size_t e0 = 0; e0 < num_entities; e0 += batch_size)
   {
-    auto entity = active_entities.subspan(e, estride);
-    // Assemble into element vector
-    assemble_local_element_vector(_be, entity, e / estride);
-
-    const std::int32_t cell = fetch_cells(entity);
-    auto dofs = dofmap.links(cell);
-    // Modify local element matrix if entity is connected to a slave cell
-    std::span<const int32_t> slaves = cell_to_slaves->links(cell);
-    if (!slaves.empty())
+    const std::size_t num_batch = std::min(batch_size, num_entities - e0);
+    std::span<const std::int32_t> batch
+        = active_entities.subspan(e0 * estride, num_batch * estride);
+
+    // Assemble into the element vectors of the batch
+    assemble_local_element_vectors(
+        std::span<T>(be_batch.data(), ndim * num_batch), batch, e0);
+
+    for (std::size_t k = 0; k < num_batch; ++k)
+    {
+      const std::int32_t cell
+          = fetch_cells(batch.subspan(k * estride, estride));
+      auto dofs = dofmap.links(cell);
+      std::span<T> be(be_batch.data() + k * ndim, ndim);
+
+      // Modify local element matrix if entity is connected to a slave cell
+      std::span<const int32_t> slaves = cell_to_slaves->links(cell);
+      if (!slaves.empty())
+      {
+        // Modify element vector for MPC and insert into b for non-local
+        // contributions
+        std::copy(be.begin(), be.end(), be_copy.begin());
+        dolfinx_mpc::modify_mpc_vec<T>(b, be, _be_copy, dofs, num_dofs, bs,
+                                       is_slave, slaves, masters, coefficients,
+                                       workspace.local_index[0]);
+      }
+
+      // Add local contribution to b
+      for (int i = 0; i < num_dofs; ++i)
+        for (int j = 0; j < bs; ++j)
+          b[bs * dofs[i] + j] += be[bs * i + j];
+    }
+  }
+}
+
+/// Assemble an integration kernel over the active entities whose cell is in
+/// a given assembly phase, see _assemble_entities_impl. The entities of the
+/// phase are assembled in contiguous runs
+/// @param[in] ghost_cells Marker for the cells assembled in phase 0. The
+/// entities of the other cells are assembled in phase 1. If empty, all
+/// entities are in phase 0
+/// @param[in] phase The phase to assemble
+template <typename T, std::size_t estride>
+void _assemble_entities_phase(
+    std::span<T> b, std::span<const std::int32_t> active_entities,
+    const dolfinx::graph::AdjacencyList<std::int32_t>& dofmap, int bs,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc,
+    const std::function<const std::int32_t(std::span<const std::int32_t>)>
+        fetch_cells,
+    const std::function<void(std::span<T>, std::span<const std::int32_t>,
+                             std::size_t)>
+        assemble_local_element_vectors,
+    dolfinx_mpc::AssemblyWorkspace<T>& workspace,
+    std::span<const std::int8_t> ghost_cells, std::int8_t phase)
+{
+  if (ghost_cells.empty())
+  {
+    if (phase == 0)
     {
-      // Modify element vector for MPC and insert into b for non-local
-      // contributions
-      std::copy(be.begin(), be.end(), be_copy.begin());
-      dolfinx_mpc::modify_mpc_vec<T>(b, _be, _be_copy, dofs, num_dofs, bs,
-                                     is_slave, slaves, masters, coefficients);
+      _assemble_entities_impl<T, estride>(b, active_entities, dofmap, bs, mpc,
+                                          fetch_cells,
+                                          assemble_local_element_vectors,
+                                          workspace);
     }
+    return;
+  }
 
-    // Add local contribution to b
-    for (int i = 0; i < num_dofs; ++i)
-      for (int k = 0; k < bs; ++k)
-        b[bs * dofs[i] + k] += be[bs * i + k];
+  auto in_phase = [&](std::size_t e)
+  {
+    const std::int32_t cell
+        = fetch_cells(active_entities.subspan(e * estride, estride));
+    return (ghost_cells[cell] != 0) == (phase == 0);
+  };
+  const std::size_t num_entities = active_entities.size() / estride;
+  std::size_t e0 = 0;
+  while (e0 < num_entities)
+  {
+    // Find the next run of entities in the phase
+    while (e0 < num_entities and !in_phase(e0))
+      ++e0;
+    std::size_t e1 = e0;
+    while (e1 < num_entities and in_phase(e1))
+      ++e1;
+    if (e1 > e0)
+    {
+      // Shift the entity index to the position in active_entities
+      const auto assemble_run
+          = [&assemble_local_element_vectors, e0](
+                std::span<T> be, std::span<const std::int32_t> entities,
+                std::size_t index)
+      { assemble_local_element_vectors(be, entities, e0 + index); };
+      _assemble_entities_impl<T, estride>(
+          b, active_entities.subspan(e0 * estride, (e1 - e0) * estride),
+          dofmap, bs, mpc, fetch_cells, assemble_run, workspace);
+    }
+    e0 = e1;
   }
 }
 
+/// Assemble a linear form into a vector with a multi point constraint
+/// @param[in, out] b The vector to assemble into
+/// @param[in] L The linear form
+/// @param[in] constants The packed constants of L
+/// @param[in] coefficients The packed coefficients of L
+/// @param[in] mpc The multi point constraint
+/// @param[in,out] workspace The work arrays of the assembly
+/// @param[in] ghost_cells Marker for the cells whose entities are assembled
+/// first (phase 0), see MultiPointConstraint::ghost_cell_marker. The entities
+/// of the other cells are assembled in phase 1. If empty, all cells are in
+/// phase 0
+/// @param[in] begin_phase1 Function called after the assembly of phase 0,
+/// returning the vector the entities of phase 1 are assembled into
 template <typename T>
 void _assemble_vector(
     std::span<T> b, const dolfinx::fem::Form<T>& L,
-    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc)
+    std::span<const T> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc,
+    dolfinx_mpc::AssemblyWorkspace<T>& workspace,
+    std::span<const std::int8_t> ghost_cells = {},
+    const std::function<std::span<T>()>& begin_phase1 = nullptr)
 {
 
   std::shared_ptr<const dolfinx::mesh::Mesh> mesh = L.mesh();
@@ -98,12 +207,6 @@ void _assemble_vector(
   const dolfinx::graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
   const int bs = dofmap->bs();
 
-  // Prepare constants & coefficients
-  const std::vector<T> constants = pack_constants(L);
-  auto coeff_vec = dolfinx::fem::allocate_coefficient_storage(L);
-  dolfinx::fem::pack_coefficients(L, coeff_vec);
-  auto coefficients = dolfinx::fem::make_coefficients_span(coeff_vec);
-
   // Prepare cell geometry
   const dolfinx::graph::AdjacencyList<std::int32_t>& x_dofmap
       = mesh->geometry().dofmap();
@@ -125,101 +228,11 @@ void _assemble_vector(
     cell_info = std::span(mesh->topology().get_cell_permutation_info());
   }
   // FIXME: Add proper interface for num coordinate dofs
-  const std::size_t num_dofs_g = x_dofmap.num_links(cell);
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
   // FIXME: Reconsider when using mixed topology (mixed celltypes)
-  std::vector<double> coordinate_dofs(3 * num_dofs_g);
-
-  if (L.num_integrals(dolfinx::fem::IntegralType::cell) > 0)
-  {
-    const auto fetch_cell
-        = [&](std::span<const std::int32_t> entity) { return entity.front(); };
-    for (int i : L.integral_ids(dolfinx::fem::IntegralType::cell))
-    {
-      const auto& coeffs
-          = coefficients.at({dolfinx::fem::IntegralType::cell, i});
-      const auto& fn = L.kernel(dolfinx::fem::IntegralType::cell, i);
-      /// Assemble local cell kernels into a vector
-      /// @param[in] be The local element vector
-      /// @param[in] cell The cell index
-      /// @param[in] index The index of the cell in the active_cells (To fetch
-      /// the appropriate coefficients)
-      const auto assemble_local_cell_vector
-          = [&](std::span<T> be, std::span<const std::int32_t> entity,
-                std::int32_t index)
-      {
-        auto cell = entity.front();
-
-        // Fetch the coordinates of the cell
-        const std::span<const std::int32_t> x_dofs = x_dofmap.links(cell);
-        for (std::size_t i = 0; i < x_dofs.size(); ++i)
-        {std::copy_n(
-              std::next(x_g.begin(), 3 * x_dofs[i]),3,
-              std::next(coordinate_dofs.begin(), 3 * i));
-        }
-        // Tabulate tensor
-        std::fill(be.data(), be.data() + be.size(), 0);
-        fn(be.data(), coeffs.first.data() + index * coeffs.second,
-           constants.data(), coordinate_dofs.data(), nullptr, nullptr);
-
-        // Apply any required transformations
-        dof_transform(be, cell_info, cell, 1);
-      };
-
-      // Assemble over all active cells
-      const std::vector<std::int32_t>& active_cells = L.cell_domains(i);
-      _assemble_entities_impl<T, 1>(b, active_cells, dofs, bs, mpc, fetch_cell,
-                                    assemble_local_cell_vector);
-    }
-  }
-  // Prepare permutations for exterior and interior facet integrals
-  if (L.num_integrals(dolfinx::fem::IntegralType::exterior_facet) > 0)
-  {
-
-    // Create lambda function fetching cell index from exterior facet entity
-    auto fetch_cell = [](auto entity) { return entity.front(); };
-
-    // Assemble exterior facet integral kernels
-    for (int i : L.integral_ids(dolfinx::fem::IntegralType::exterior_facet))
-    {
-      const auto& fn = L.kernel(dolfinx::fem::IntegralType::exterior_facet, i);
-      const auto& coeffs
-          = coefficients.at({dolfinx::fem::IntegralType::exterior_facet, i});
-      /// Assemble local exterior facet kernels into a vector
-      /// @param[in] be The local element vector
-      /// @param[in] entity The entity, given as a cell index and the local
-      /// index relative to the cell
-      /// @param[in] index The index of entity in active_facets
-      const auto assemble_local_exterior_facet_vector
-          = [&](std::span<T> be, std::span<const std::int32_t> entity,
-                std::size_t index)
-      {
-        // Fetch the coordinates of the cell
-        const std::int32_t cell = entity[0];
-        const int local_facet = entity[1];
-        const std::span<const std::int32_t> x_dofs = x_dofmap.links(cell);
-        for (std::size_t i = 0; i < x_dofs.size(); ++i)
-        {
-         std::copy_n(
-              std::next(x_g.begin(), 3 * x_dofs[i]),3,
-              std::next(coordinate_dofs.begin(), 3 * i));
-        }
-
-        // Tabulate tensor
-        std::fill(be.data(), be.data() + be.size(), 0);
-        fn(be.data(), coeffs.first.data() + index * coeffs.second,
-           constants.data(), coordinate_dofs.data(), &local_facet, nullptr);
-
-        // Apply any required transformations
-        dof_transform(be, cell_info, cell, 1);
-      };
-
-      // Assemble over all active cells
-      const std::vector<std::int32_t>& active_facets
-          = L.exterior_facet_domains(i);
-      _assemble_entities_impl<T, 2>(b, active_facets, dofs, bs, mpc, fetch_cell,
-                                    assemble_local_exterior_facet_vector);
-    }
-  }
+  std::vector<double>& coordinate_dofs = workspace.coordinate_dofs;
+  coordinate_dofs.resize(3 * num_dofs_g * dolfinx_mpc::assembly_batch_size);
+  const std::size_t ndim = bs * dofs.links(0).size();
 
   if (L.num_integrals(dolfinx::fem::IntegralType::interior_facet) > 0)
   {
@@ -238,6 +251,133 @@ void _assemble_vector(
     // else
     //   get_perm = [](std::size_t) { return 0; };
   }
+
+  // Assemble the entities of each phase, where the entities of the second
+  // phase are assembled into the vector returned by begin_phase1
+  const std::int8_t num_phases
+      = (ghost_cells.empty() and !begin_phase1) ? 1 : 2;
+  for (std::int8_t phase = 0; phase < num_phases; ++phase)
+  {
+    if (phase == 1 and begin_phase1)
+      b = begin_phase1();
+
+    if (L.num_integrals(dolfinx::fem::IntegralType::cell) > 0)
+    {
+      const auto fetch_cell = [&](std::span<const std::int32_t> entity)
+      { return entity.front(); };
+      for (int i : L.integral_ids(dolfinx::fem::IntegralType::cell))
+      {
+        const auto& coeffs
+            = coefficients.at({dolfinx::fem::IntegralType::cell, i});
+        const auto& fn = L.kernel(dolfinx::fem::IntegralType::cell, i);
+        /// Assemble local cell kernels into element vectors for a batch of
+        /// cells. The geometry of the batch is gathered into one buffer, and
+        /// the kernel is called for each cell of the batch
+        /// @param[in] be The element vectors of the batch
+        /// @param[in] entities The cell indices
+        /// @param[in] index The index of the first cell in the active_cells
+        /// (To fetch the appropriate coefficients)
+        const auto assemble_local_cell_vectors
+            = [&](std::span<T> be, std::span<const std::int32_t> entities,
+                  std::size_t index)
+        {
+          dolfinx_mpc::pack_coordinate_dofs(coordinate_dofs, x_dofmap, x_g,
+                                            entities, 1);
+          std::fill(be.begin(), be.end(), 0);
+          for (std::size_t k = 0; k < entities.size(); ++k)
+          {
+            // Tabulate tensor
+            std::span<T> _be = be.subspan(k * ndim, ndim);
+            fn(_be.data(), coeffs.first.data() + (index + k) * coeffs.second,
+               constants.data(), coordinate_dofs.data() + 3 * num_dofs_g * k,
+               nullptr, nullptr);
+
+            // Apply any required transformations
+            dof_transform(_be, cell_info, entities[k], 1);
+          }
+        };
+
+        // Assemble over all active cells
+        const std::vector<std::int32_t>& active_cells = L.cell_domains(i);
+        _assemble_entities_phase<T, 1>(b, active_cells, dofs, bs, mpc,
+                                       fetch_cell, assemble_local_cell_vectors,
+                                       workspace, ghost_cells, phase);
+      }
+    }
+    // Prepare permutations for exterior and interior facet integrals
+    if (L.num_integrals(dolfinx::fem::IntegralType::exterior_facet) > 0)
+    {
+
+      // Create lambda function fetching cell index from exterior facet entity
+      auto fetch_cell = [](auto entity) { return entity.front(); };
+
+      // Assemble exterior facet integral kernels
+      for (int i : L.integral_ids(dolfinx::fem::IntegralType::exterior_facet))
+      {
+        const auto& fn
+            = L.kernel(dolfinx::fem::IntegralType::exterior_facet, i);
+        const auto& coeffs
+            = coefficients.at({dolfinx::fem::IntegralType::exterior_facet, i});
+        /// Assemble local exterior facet kernels into element vectors for a
+        /// batch of facets. The geometry of the cells of the batch is
+        /// gathered into one buffer, and the kernel is called for each facet
+        /// of the batch
+        /// @param[in] be The element vectors of the batch
+        /// @param[in] entities The entities, each given as a cell index and
+        /// the local index relative to the cell
+        /// @param[in] index The index of the first entity in active_facets
+        const auto assemble_local_exterior_facet_vectors
+            = [&](std::span<T> be, std::span<const std::int32_t> entities,
+                  std::size_t index)
+        {
+          dolfinx_mpc::pack_coordinate_dofs(coordinate_dofs, x_dofmap, x_g,
+                                            entities, 2);
+          std::fill(be.begin(), be.end(), 0);
+          for (std::size_t k = 0; k < entities.size() / 2; ++k)
+          {
+            // Tabulate tensor
+            const std::int32_t cell = entities[2 * k];
+            const int local_facet = entities[2 * k + 1];
+            std::span<T> _be = be.subspan(k * ndim, ndim);
+            fn(_be.data(), coeffs.first.data() + (index + k) * coeffs.second,
+               constants.data(), coordinate_dofs.data() + 3 * num_dofs_g * k,
+               &local_facet, nullptr);
+
+            // Apply any required transformations
+            dof_transform(_be, cell_info, cell, 1);
+          }
+        };
+
+        // Assemble over all active cells
+        const std::vector<std::int32_t>& active_facets
+            = L.exterior_facet_domains(i);
+        _assemble_entities_phase<T, 2>(
+            b, active_facets, dofs, bs, mpc, fetch_cell,
+            assemble_local_exterior_facet_vectors, workspace, ghost_cells,
+            phase);
+      }
+    }
+  }
+}
+
+/// Assemble a linear form into a vector with a multi point constraint,
+/// packing the constants and coefficients of the form, see the overload
+/// with packed data for details
+template <typename T>
+void _assemble_vector(
+    std::span<T> b, const dolfinx::fem::Form<T>& L,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc,
+    std::span<const std::int8_t> ghost_cells = {},
+    const std::function<std::span<T>()>& begin_phase1 = nullptr)
+{
+  // Prepare constants & coefficients
+  const std::vector<T> constants = pack_constants(L);
+  auto coeff_vec = dolfinx::fem::allocate_coefficient_storage(L);
+  dolfinx::fem::pack_coefficients(L, coeff_vec);
+  dolfinx_mpc::AssemblyWorkspace<T> workspace;
+  _assemble_vector<T>(b, L, std::span<const T>(constants),
+                      dolfinx::fem::make_coefficients_span(coeff_vec), mpc,
+                      workspace, ghost_cells, begin_phase1);
 }
 } // namespace
 //-----------------------------------------------------------------------------
@@ -258,3 +398,83 @@ void dolfinx_mpc::assemble_vector(
   _assemble_vector<std::complex<double>>(b, L, mpc);
 }
 //-----------------------------------------------------------------------------
+void dolfinx_mpc::assemble_vector(
+    std::span<double> b, const dolfinx::fem::Form<double>& L,
+    std::span<const double> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const double>, int>>& coefficients,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<double>>& mpc,
+    dolfinx_mpc::AssemblyWorkspace<double>& workspace)
+{
+  _assemble_vector<double>(b, L, constants, coefficients, mpc, workspace);
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::assemble_vector(
+    std::span<std::complex<double>> b,
+    const dolfinx::fem::Form<std::complex<double>>& L,
+    std::span<const std::complex<double>> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const std::complex<double>>, int>>&
+        coefficients,
+    const std::shared_ptr<
+        const dolfinx_mpc::MultiPointConstraint<std::complex<double>>>& mpc,
+    dolfinx_mpc::AssemblyWorkspace<std::complex<double>>& workspace)
+{
+  _assemble_vector<std::complex<double>>(b, L, constants, coefficients, mpc,
+                                         workspace);
+}
+//-----------------------------------------------------------------------------
+void dolfinx_mpc::assemble_vector(
+    Vec b, const dolfinx::fem::Form<PetscScalar>& L,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<PetscScalar>>&
+        mpc)
+{
+  dolfinx::common::Timer timer("~MPC: Assemble vector (overlapped)");
+  auto check = [](PetscErrorCode ierr, const std::string& fn)
+  {
+    if (ierr != 0)
+      dolfinx::la::petsc::error(ierr, __FILE__, fn);
+  };
+
+  Vec b_local = nullptr;
+  check(VecGhostGetLocalForm(b, &b_local), "VecGhostGetLocalForm");
+  if (!b_local)
+  {
+    throw std::runtime_error(
+        "Cannot assemble vector with ghost accumulation. Vector is not "
+        "ghosted.");
+  }
+  PetscInt n = 0;
+  check(VecGetSize(b_local, &n), "VecGetSize");
+  PetscInt n_owned = 0;
+  check(VecGetLocalSize(b, &n_owned), "VecGetLocalSize");
+  PetscScalar* array = nullptr;
+  check(VecGetArray(b_local, &array), "VecGetArray");
+
+  // The cells with slaves or ghost dofs contribute to the ghost entries, and
+  // are assembled into the local form first. The reverse ghost update is then
+  // started, and the remaining cells (which only touch owned, non-slave
+  // entries) are assembled into a separate buffer while the contributions
+  // are sent. The buffer is added to the owned entries after the update has
+  // finished, as PETSc does not allow access to the vector in between
+  std::vector<PetscScalar> b1;
+  const auto begin_phase1 = [&]()
+  {
+    check(VecRestoreArray(b_local, &array), "VecRestoreArray");
+    check(VecGhostRestoreLocalForm(b, &b_local), "VecGhostRestoreLocalForm");
+    check(VecGhostUpdateBegin(b, ADD_VALUES, SCATTER_REVERSE),
+          "VecGhostUpdateBegin");
+    b1.assign(n_owned, 0);
+    return std::span<PetscScalar>(b1);
+  };
+  _assemble_vector<PetscScalar>(std::span<PetscScalar>(array, n), L, mpc,
+                                mpc->ghost_cell_marker(), begin_phase1);
+  check(VecGhostUpdateEnd(b, ADD_VALUES, SCATTER_REVERSE),
+        "VecGhostUpdateEnd");
+
+  // Add the contributions of the remaining cells
+  check(VecGetArray(b, &array), "VecGetArray");
+  std::transform(b1.cbegin(), b1.cend(), array, array, std::plus<>());
+  check(VecRestoreArray(b, &array), "VecRestoreArray");
+}
+//-----------------------------------------------------------------------------
@@ -11,6 +11,8 @@
 #include <dolfinx/fem/DirichletBC.h>
 #include <dolfinx/fem/Form.h>
 #include <functional>
+#include <map>
+#include <petscvec.h>
 #include <xtensor/xcomplex.hpp>
 
 namespace dolfinx_mpc
@@ -30,6 +32,8 @@ class MultiPointConstraint;
 /// @param [in] slaves The slave dofs (local to process)
 /// @param [in] masters Adjacency list with master dofs
 /// @param [in] coeffs Adjacency list with the master coefficients
+/// @param [in, out] local_index Work array for the index of the slaves local
+/// to the cell, reused between cells such that no memory is allocated per cell
 template <typename T>
 void modify_mpc_vec(
     const std::span<T>& b, const std::span<T>& b_local,
@@ -39,13 +43,15 @@ void modify_mpc_vec(
     const std::span<const std::int32_t>& slaves,
     const std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>&
         masters,
-    const std::shared_ptr<const dolfinx::graph::AdjacencyList<T>>& coeffs)
+    const std::shared_ptr<const dolfinx::graph::AdjacencyList<T>>& coeffs,
+    std::vector<std::int32_t>& local_index)
 {
 
   // NOTE: Should this be moved into the MPC constructor?
   // Get local index of slaves in cell
-  std::vector<std::int32_t> local_index
-      = compute_local_slave_index(slaves, num_dofs, bs, cell_blocks, is_slave);
+  local_index.resize(slaves.size());
+  compute_local_slave_index(local_index, slaves, num_dofs, bs, cell_blocks,
+                            is_slave);
 
   // Move contribution from each slave to corresponding master dof
   for (std::size_t i = 0; i < local_index.size(); i++)
@@ -82,4 +88,59 @@ void assemble_vector(
     const std::shared_ptr<
         const dolfinx_mpc::MultiPointConstraint<std::complex<double>>>& mpc);
 
+/// Assemble a linear form into a vector, using pre-packed constants and
+/// coefficients (see dolfinx::fem::pack_constants and
+/// dolfinx::fem::pack_coefficients) and reusable work arrays
+/// @param[in] b The vector to be assembled. It will not be zeroed before
+/// assembly.
+/// @param[in] L The linear forms to assemble into b
+/// @param[in] constants The packed constants of L
+/// @param[in] coefficients The packed coefficients of L
+/// @param[in] mpc The multi-point constraint
+/// @param[in,out] workspace The work arrays of the assembly
+void assemble_vector(
+    std::span<double> b, const dolfinx::fem::Form<double>& L,
+    std::span<const double> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const double>, int>>& coefficients,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<double>>& mpc,
+    AssemblyWorkspace<double>& workspace);
+
+/// Assemble a linear form into a vector, using pre-packed constants and
+/// coefficients (see dolfinx::fem::pack_constants and
+/// dolfinx::fem::pack_coefficients) and reusable work arrays
+/// @param[in] b The vector to be assembled. It will not be zeroed before
+/// assembly.
+/// @param[in] L The linear forms to assemble into b
+/// @param[in] constants The packed constants of L
+/// @param[in] coefficients The packed coefficients of L
+/// @param[in] mpc The multi-point constraint
+/// @param[in,out] workspace The work arrays of the assembly
+void assemble_vector(
+    std::span<std::complex<double>> b,
+    const dolfinx::fem::Form<std::complex<double>>& L,
+    std::span<const std::complex<double>> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const std::complex<double>>, int>>&
+        coefficients,
+    const std::shared_ptr<
+        const dolfinx_mpc::MultiPointConstraint<std::complex<double>>>& mpc,
+    AssemblyWorkspace<std::complex<double>>& workspace);
+
+/// Assemble a linear form into a ghosted PETSc vector, and accumulate the
+/// ghost contributions on the owning processes. The cells containing slaves
+/// or ghost dofs (see MultiPointConstraint::ghost_cell_marker) are assembled
+/// first. The reverse ghost update is then started, and the remaining cells
+/// are assembled into a work array while the contributions are
+/// communicated. The work array is added to b when the update has finished.
+/// @param[in, out] b The ghosted vector to be assembled. It will not be zeroed
+/// before assembly. On exit, the ghost contributions (including those to
+/// ghost masters) are added to the owned entries. Throws if b is not ghosted.
+/// @param[in] L The linear form to assemble into b
+/// @param[in] mpc The multi-point constraint
+void assemble_vector(
+    Vec b, const dolfinx::fem::Form<PetscScalar>& L,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<PetscScalar>>&
+        mpc);
+
 } // namespace dolfinx_mpc
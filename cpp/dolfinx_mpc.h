@@ -2,9 +2,17 @@
 
 // DOLFINX_MPC interface
 #include <ContactConstraint.h>
+#include <DofClassification.h>
+#include <DofIdentification.h>
+#include <EquationReader.h>
+#include <HangingNodeConstraint.h>
+#include <LinearProblem.h>
 #include <MultiPointConstraint.h>
+#include <SlidingInterface.h>
 #include <SlipConstraint.h>
 #include <assemble_matrix.h>
 #include <utils.h>
 #include <lifting.h>
+#include <multigrid.h>
+#include <reductions.h>
 #include <assemble_vector.h>
\ No newline at end of file
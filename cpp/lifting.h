@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "DofClassification.h"
 #include "MultiPointConstraint.h"
 #include "assemble_vector.h"
 #include <dolfinx/fem/Constant.h>
@@ -15,6 +16,7 @@
 #include <dolfinx/fem/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Geometry.h>
+#include <map>
 
 namespace
 {
@@ -30,10 +32,8 @@ namespace
 /// @param[in] dofmap0 The dofmap for the columns of the matrix
 /// @param[in] bs0 The block size for the rows
 /// @param[in] bs1 The block size for the columns
-/// @param[in] bc_values1 Array of Dirichlet condition values for dofs local to
-/// process
-/// @param[in] bc_markers1 Array indicating what dofs local to process is in a
-/// DirichletBC
+/// @param[in] classification1 Classification of the column dofs, used to skip
+/// entities without Dirichlet dofs
 /// @param[in] mpc1 Multipoint constraints to apply to the rows of the vector
 /// @param[in] fetch_cells Function that fetches the cell index for each active
 /// entity
@@ -46,14 +46,14 @@ void _lift_bc_entities(
     std::span<T> b, std::span<const std::int32_t> active_entities,
     const dolfinx::graph::AdjacencyList<std::int32_t>& dofmap0,
     const dolfinx::graph::AdjacencyList<std::int32_t>& dofmap1, int bs0,
-    int bs1, const std::span<const T>& bc_values1,
-    const std::vector<std::int8_t>& bc_markers1,
+    int bs1, const dolfinx_mpc::DofClassification<T>& classification1,
     const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc1,
     const std::function<const std::int32_t(std::span<const std::int32_t>)>
         fetch_cells,
     const std::function<void(std::span<T>, std::span<T>, const int, const int,
                              std::span<const std::int32_t>, std::size_t)>
-        lift_local_vector)
+        lift_local_vector,
+    dolfinx_mpc::AssemblyWorkspace<T>& workspace)
 {
 
   // Get MPC data
@@ -67,9 +67,9 @@ void _lift_bc_entities(
 
   // NOTE: Assertion that all links have the same size (no P refinement)
   const int num_dofs0 = dofmap0.links(0).size();
-  std::vector<T> be;
-  std::vector<T> be_copy;
-  std::vector<T> Ae;
+  std::vector<T>& be = workspace.element_tensors;
+  std::vector<T>& be_copy = workspace.element_copy;
+  std::vector<T>& Ae = workspace.element_matrix;
 
   // Assemble over all entities
   for (std::size_t e = 0; e < active_entities.size(); e += estride)
@@ -85,26 +85,12 @@ void _lift_bc_entities(
     Ae.resize(num_rows * num_cols);
 
     // Check if bc is applied to entity
-    bool has_bc = false;
-    std::for_each(dmap1.begin(), dmap1.end(),
-                  [&bc_markers1, bs1, &has_bc](const auto dof)
-                  {
-                    for (int k = 0; k < bs1; ++k)
-                    {
-                      assert(bs1 * dof + k < (int)bc_markers1.size());
-                      if (bc_markers1[bs1 * dof + k])
-                      {
-                        has_bc = true;
-                        break;
-                      }
-                    }
-                  });
-    if (!has_bc)
+    if (!classification1.has_bc(cell))
       continue;
 
     // Lift into local element vector
-    const std::span<T> _be(be);
-    const std::span<T> _Ae(Ae);
+    const std::span<T> _be(be.data(), num_rows);
+    const std::span<T> _Ae(Ae.data(), num_rows * num_cols);
     lift_local_vector(_be, _Ae, num_rows, num_cols, entity, e / estride);
     // Modify local element matrix if entity is connected to a slave cell
     std::span<const int32_t> slaves = cell_to_slaves->links(cell);
@@ -114,10 +100,11 @@ void _lift_bc_entities(
       // Modify element vector for MPC and insert into b for non-local
       // contributions
       be_copy.resize(num_rows);
-      std::copy(be.begin(), be.end(), be_copy.begin());
-      const std::span<T> _be_copy(be_copy);
+      std::copy(_be.begin(), _be.end(), be_copy.begin());
+      const std::span<T> _be_copy(be_copy.data(), num_rows);
       dolfinx_mpc::modify_mpc_vec<T>(b, _be, _be_copy, dmap0, dmap0.size(), bs0,
-                                     is_slave, slaves, masters, coefficients);
+                                     is_slave, slaves, masters, coefficients,
+                                     workspace.local_index[0]);
     }
     // Add local contribution to b
     for (int i = 0; i < num_dofs0; ++i)
@@ -137,38 +124,40 @@ void _lift_bc_entities(
 /// @param[in] a The bilinear forms, where a is the form that
 /// generates A
 /// @param[in] bcs List of boundary conditions
+/// @param[in] classification1 The classification of the dofs of the trial
+/// space with respect to bcs
 /// @param[in] x0 The function to subtract
 /// @param[in] scale Scale of lifting
 /// @param[in] mpc1 The multi point constraints
+/// @param[in] constants The packed constants of a
+/// @param[in] coefficients The packed coefficients of a
+/// @param[in,out] workspace The work arrays of the lifting
 template <typename T>
 void _apply_lifting(
     std::span<T> b, const std::shared_ptr<const dolfinx::fem::Form<T>> a,
     const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<T>>>& bcs,
+    const dolfinx_mpc::DofClassification<T>& classification1,
     const std::span<const T>& x0, double scale,
-    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc1)
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc1,
+    std::span<const T> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    dolfinx_mpc::AssemblyWorkspace<T>& workspace)
 {
-  const std::vector<T> constants = pack_constants(*a);
-  auto coeff_vec = dolfinx::fem::allocate_coefficient_storage(*a);
-  dolfinx::fem::pack_coefficients(*a, coeff_vec);
-  auto coefficients = dolfinx::fem::make_coefficients_span(coeff_vec);
   const std::vector<std::int8_t>& is_slave = mpc1->is_slave();
 
-  // Create 1D arrays of bc values and bc indicator
-  std::vector<std::int8_t> bc_markers1;
-  std::vector<T> bc_values1;
+  // Create 1D array of bc values. The values may change between calls,
+  // while the Dirichlet dofs are given by the classification
+  std::vector<T>& bc_values1 = workspace.bc_values;
   assert(a->function_spaces().at(1));
   auto V1 = a->function_spaces().at(1);
   auto map1 = V1->dofmap()->index_map;
   const int bs1 = V1->dofmap()->index_map_bs();
   assert(map1);
   const int crange = bs1 * (map1->size_local() + map1->num_ghosts());
-  bc_markers1.assign(crange, false);
   bc_values1.assign(crange, 0.0);
   for (const std::shared_ptr<const dolfinx::fem::DirichletBC<T>>& bc : bcs)
-  {
-    bc->mark_dofs(bc_markers1);
     bc->dof_values(bc_values1);
-  }
 
   // Extract dofmaps for columns and rows of a
   assert(a->function_spaces().at(0));
@@ -193,6 +182,11 @@ void _apply_lifting(
       = mesh->geometry().dofmap();
   std::span<const double> x_g = mesh->geometry().x();
   const int tdim = mesh->topology().dim();
+  // FIXME: Add proper interface for num coordinate dofs
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  // FIXME: Reconsider when using mixed topology (mixed celltypes)
+  std::vector<double>& coordinate_dofs = workspace.coordinate_dofs;
+  coordinate_dofs.resize(3 * num_dofs_g);
 
   std::span<const std::uint32_t> cell_info;
   if (needs_transformation_data)
@@ -230,10 +224,6 @@ void _apply_lifting(
                 std::size_t index)
       {
         auto cell = entity.front();
-        // FIXME: Add proper interface for num coordinate dofs
-        const std::size_t num_dofs_g = x_dofmap.num_links(cell);
-        // FIXME: Reconsider when using mixed topology (mixed celltypes)
-        std::vector<double> coordinate_dofs(3 * num_dofs_g);
 
         // Fetch the coordinates of the cell
         const std::span<const std::int32_t> x_dofs = x_dofmap.links(cell);
@@ -257,7 +247,6 @@ void _apply_lifting(
           for (std::int32_t k = 0; k < bs1; k++)
           {
             const std::int32_t jj = bs1 * dmap1[j] + k;
-            assert(jj < (int)bc_markers1.size());
             // Add this in once we have interface for rhs of MPCs
             // MPCs overwrite Dirichlet conditions
             // if (is_slave[jj])
@@ -268,7 +257,7 @@ void _apply_lifting(
             //     be[m] -= Ae[m * num_cols + bs1 * j + k] * val;
             // }
             // else
-            if (bc_markers1[jj])
+            if (classification1.is_bc(jj))
             {
               const T bc = bc_values1[jj];
               const T _x0 = x0.empty() ? 0.0 : x0[jj];
@@ -280,8 +269,9 @@ void _apply_lifting(
       };
       // Assemble over all active cells
       const std::vector<std::int32_t>& cells = a->cell_domains(i);
-      _lift_bc_entities<T, 1>(b, cells, dofmap0, dofmap1, bs0, bs1, bc_values1,
-                              bc_markers1, mpc1, fetch_cells, lift_bcs_cell);
+      _lift_bc_entities<T, 1>(b, cells, dofmap0, dofmap1, bs0, bs1,
+                              classification1, mpc1, fetch_cells,
+                              lift_bcs_cell, workspace);
     }
   }
 
@@ -317,11 +307,6 @@ void _apply_lifting(
         const std::int32_t cell = entity[0];
         const int local_facet = entity[1];
         const std::span<const std::int32_t> x_dofs = x_dofmap.links(cell);
-        // FIXME: Add proper interface for num coordinate dofs
-        const std::size_t num_dofs_g = x_dofmap.num_links(cell);
-        // FIXME: Reconsider when using mixed topology (mixed celltypes)
-
-        std::vector<double> coordinate_dofs(3 * num_dofs_g);
         for (std::size_t i = 0; i < x_dofs.size(); ++i)
         {
           std::copy_n(
@@ -343,7 +328,6 @@ void _apply_lifting(
           for (std::int32_t k = 0; k < bs1; k++)
           {
             const std::int32_t jj = bs1 * dmap1[j] + k;
-            assert(jj < (int)bc_markers1.size());
             // Add this in once we have interface for rhs of MPCs
             // MPCs overwrite Dirichlet conditions
             // if (is_slave[jj])
@@ -355,7 +339,7 @@ void _apply_lifting(
             // }
             // else
 
-            if (bc_markers1[jj])
+            if (classification1.is_bc(jj))
             {
               const T bc = bc_values1[jj];
               const T _x0 = x0.empty() ? 0.0 : x0[jj];
@@ -370,8 +354,8 @@ void _apply_lifting(
       const std::vector<std::int32_t>& active_facets
           = a->exterior_facet_domains(i);
       _lift_bc_entities<T, 2>(b, active_facets, dofmap0, dofmap1, bs0, bs1,
-                              bc_values1, bc_markers1, mpc1, fetch_cell,
-                              lift_bc_exterior_facet);
+                              classification1, mpc1, fetch_cell,
+                              lift_bc_exterior_facet, workspace);
     }
   }
   if (a->num_integrals(dolfinx::fem::IntegralType::interior_facet) > 0)
@@ -392,6 +376,79 @@ void _apply_lifting(
     //     get_perm = [](std::size_t) { return 0; };
   }
 }
+
+/// Modify b such that b <- b - scale * K^T (A (g - x0)), packing the
+/// constants and coefficients of a, see the overload with packed data for
+/// details
+template <typename T>
+void _apply_lifting(
+    std::span<T> b, const std::shared_ptr<const dolfinx::fem::Form<T>> a,
+    const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<T>>>& bcs,
+    const dolfinx_mpc::DofClassification<T>& classification1,
+    const std::span<const T>& x0, double scale,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc1)
+{
+  const std::vector<T> constants = pack_constants(*a);
+  auto coeff_vec = dolfinx::fem::allocate_coefficient_storage(*a);
+  dolfinx::fem::pack_coefficients(*a, coeff_vec);
+  dolfinx_mpc::AssemblyWorkspace<T> workspace;
+  _apply_lifting<T>(b, a, bcs, classification1, x0, scale, mpc1,
+                    std::span<const T>(constants),
+                    dolfinx::fem::make_coefficients_span(coeff_vec), workspace);
+}
+
+/// Apply lifting for a set of bilinear forms, where the Dirichlet dofs of the
+/// trial space of a[j] are given by classifications1[j]. If classifications1
+/// is empty, the classifications are created from bcs1
+template <typename T>
+void _apply_lifting_blocks(
+    std::span<T> b,
+    const std::vector<std::shared_ptr<const dolfinx::fem::Form<T>>>& a,
+    const std::vector<
+        std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<T>>>>& bcs1,
+    const std::vector<
+        std::shared_ptr<const dolfinx_mpc::DofClassification<T>>>&
+        classifications1,
+    const std::vector<std::span<const T>>& x0, double scale,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<T>>& mpc)
+{
+  if (!x0.empty() and x0.size() != a.size())
+  {
+    throw std::runtime_error(
+        "Mismatch in size between x0 and bilinear form in assembler.");
+  }
+
+  if (a.size() != bcs1.size())
+  {
+    throw std::runtime_error(
+        "Mismatch in size between a and bcs in assembler.");
+  }
+
+  if (!classifications1.empty() and classifications1.size() != a.size())
+  {
+    throw std::runtime_error(
+        "Mismatch in size between a and dof classifications in assembler.");
+  }
+
+  for (std::size_t j = 0; j < a.size(); ++j)
+  {
+    std::shared_ptr<const dolfinx_mpc::DofClassification<T>> classification1
+        = classifications1.empty()
+              ? std::make_shared<const dolfinx_mpc::DofClassification<T>>(
+                  a[j]->function_spaces().at(1), bcs1[j], mpc)
+              : classifications1[j];
+    if (x0.empty())
+    {
+      _apply_lifting<T>(b, a[j], bcs1[j], *classification1,
+                        std::span<const T>(), scale, mpc);
+    }
+    else
+    {
+      _apply_lifting<T>(b, a[j], bcs1[j], *classification1, x0[j], scale,
+                        mpc);
+    }
+  }
+}
 } // namespace
 
 namespace dolfinx_mpc
@@ -416,7 +473,7 @@ namespace dolfinx_mpc
 /// @param[in] x0 The vectors used in the lifitng.
 /// @param[in] scale Scaling to apply
 /// @param[in] mpc The multi point constraints
-void apply_lifting(
+inline void apply_lifting(
     std::span<double> b,
     const std::vector<std::shared_ptr<const dolfinx::fem::Form<double>>> a,
     const std::vector<
@@ -425,30 +482,9 @@ void apply_lifting(
     const std::vector<std::span<const double>>& x0, double scale,
     const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<double>>& mpc)
 {
-  if (!x0.empty() and x0.size() != a.size())
-  {
-    throw std::runtime_error(
-        "Mismatch in size between x0 and bilinear form in assembler.");
-  }
-
-  if (a.size() != bcs1.size())
-  {
-    throw std::runtime_error(
-        "Mismatch in size between a and bcs in assembler.");
-  }
-  for (std::size_t j = 0; j < a.size(); ++j)
-  {
-    if (x0.empty())
-    {
-      _apply_lifting<double>(b, a[j], bcs1[j], std::span<const double>(), scale,
-                             mpc);
-    }
-    else
-    {
-      _apply_lifting<double>(b, a[j], bcs1[j], x0[j], scale, mpc);
-    }
-  }
+  _apply_lifting_blocks<double>(b, a, bcs1, {}, x0, scale, mpc);
 }
+
 /// Modify b such that:
 ///
 ///   b <- b - scale * K^T (A_j (g_j 0 x0_j))
@@ -468,7 +504,7 @@ void apply_lifting(
 /// @param[in] x0 The vectors used in the lifitng.
 /// @param[in] scale Scaling to apply
 /// @param[in] mpc The multi point constraints
-void apply_lifting(
+inline void apply_lifting(
     std::span<std::complex<double>> b,
     const std::vector<
         std::shared_ptr<const dolfinx::fem::Form<std::complex<double>>>>
@@ -480,29 +516,159 @@ void apply_lifting(
     const std::shared_ptr<
         const dolfinx_mpc::MultiPointConstraint<std::complex<double>>>& mpc)
 {
-  if (!x0.empty() and x0.size() != a.size())
+  _apply_lifting_blocks<std::complex<double>>(b, a, bcs1, {}, x0, scale, mpc);
+}
+
+/// Modify b such that:
+///
+///   b <- b - scale * K^T (A_j (g_j 0 x0_j))
+///
+/// using precomputed classifications of the dofs of the trial spaces V_j, see
+/// the overload without classifications for details.
+/// @param[in,out] b The vector to be modified
+/// @param[in] a The bilinear formss, where a[j] is the form that
+/// generates A[j]
+/// @param[in] bcs List of boundary conditions for each block, used for the
+/// values of the conditions
+/// @param[in] classifications1 The classification of the dofs of V_j with
+/// respect to bcs1[j]
+/// @param[in] x0 The vectors used in the lifitng.
+/// @param[in] scale Scaling to apply
+/// @param[in] mpc The multi point constraints
+inline void apply_lifting(
+    std::span<double> b,
+    const std::vector<std::shared_ptr<const dolfinx::fem::Form<double>>> a,
+    const std::vector<
+        std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<double>>>>&
+        bcs1,
+    const std::vector<std::shared_ptr<const DofClassification<double>>>&
+        classifications1,
+    const std::vector<std::span<const double>>& x0, double scale,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<double>>& mpc)
+{
+  if (classifications1.size() != a.size())
   {
     throw std::runtime_error(
-        "Mismatch in size between x0 and bilinear form in assembler.");
+        "Mismatch in size between a and dof classifications in assembler.");
   }
+  _apply_lifting_blocks<double>(b, a, bcs1, classifications1, x0, scale, mpc);
+}
 
-  if (a.size() != bcs1.size())
+/// Modify b such that:
+///
+///   b <- b - scale * K^T (A_j (g_j 0 x0_j))
+///
+/// using precomputed classifications of the dofs of the trial spaces V_j, see
+/// the overload without classifications for details.
+/// @param[in,out] b The vector to be modified
+/// @param[in] a The bilinear formss, where a[j] is the form that
+/// generates A[j]
+/// @param[in] bcs List of boundary conditions for each block, used for the
+/// values of the conditions
+/// @param[in] classifications1 The classification of the dofs of V_j with
+/// respect to bcs1[j]
+/// @param[in] x0 The vectors used in the lifitng.
+/// @param[in] scale Scaling to apply
+/// @param[in] mpc The multi point constraints
+inline void apply_lifting(
+    std::span<std::complex<double>> b,
+    const std::vector<
+        std::shared_ptr<const dolfinx::fem::Form<std::complex<double>>>>
+        a,
+    const std::vector<std::vector<std::shared_ptr<
+        const dolfinx::fem::DirichletBC<std::complex<double>>>>>& bcs1,
+    const std::vector<
+        std::shared_ptr<const DofClassification<std::complex<double>>>>&
+        classifications1,
+    const std::vector<std::span<const std::complex<double>>>& x0, double scale,
+    const std::shared_ptr<
+        const dolfinx_mpc::MultiPointConstraint<std::complex<double>>>& mpc)
+{
+  if (classifications1.size() != a.size())
   {
     throw std::runtime_error(
-        "Mismatch in size between a and bcs in assembler.");
-  }
-  for (std::size_t j = 0; j < a.size(); ++j)
-  {
-    if (x0.empty())
-    {
-      _apply_lifting<std::complex<double>>(
-          b, a[j], bcs1[j], std::span<const std::complex<double>>(), scale,
-          mpc);
-    }
-    else
-    {
-      _apply_lifting<std::complex<double>>(b, a[j], bcs1[j], x0[j], scale, mpc);
-    }
+        "Mismatch in size between a and dof classifications in assembler.");
   }
+  _apply_lifting_blocks<std::complex<double>>(b, a, bcs1, classifications1, x0,
+                                              scale, mpc);
+}
+
+/// Modify b such that:
+///
+///   b <- b - scale * K^T (A (g - x0))
+///
+/// for a single bilinear form a, using a precomputed classification of the
+/// dofs of the trial space, pre-packed constants and coefficients of a (see
+/// dolfinx::fem::pack_constants and dolfinx::fem::pack_coefficients) and
+/// reusable work arrays.
+/// @param[in,out] b The vector to be modified
+/// @param[in] a The bilinear form that generates A
+/// @param[in] constants The packed constants of a
+/// @param[in] coefficients The packed coefficients of a
+/// @param[in] bcs1 The boundary conditions on the trial space, used for the
+/// values of the conditions
+/// @param[in] classification1 The classification of the dofs of the trial
+/// space with respect to bcs1
+/// @param[in] x0 The vector used in the lifting. If empty, it is treated
+/// as 0
+/// @param[in] scale Scaling to apply
+/// @param[in] mpc The multi point constraints
+/// @param[in,out] workspace The work arrays of the lifting
+inline void apply_lifting(
+    std::span<double> b,
+    const std::shared_ptr<const dolfinx::fem::Form<double>>& a,
+    std::span<const double> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const double>, int>>& coefficients,
+    const std::vector<std::shared_ptr<const dolfinx::fem::DirichletBC<double>>>&
+        bcs1,
+    const DofClassification<double>& classification1,
+    std::span<const double> x0, double scale,
+    const std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<double>>& mpc,
+    AssemblyWorkspace<double>& workspace)
+{
+  _apply_lifting<double>(b, a, bcs1, classification1, x0, scale, mpc,
+                         constants, coefficients, workspace);
+}
+
+/// Modify b such that:
+///
+///   b <- b - scale * K^T (A (g - x0))
+///
+/// for a single bilinear form a, using a precomputed classification of the
+/// dofs of the trial space, pre-packed constants and coefficients of a (see
+/// dolfinx::fem::pack_constants and dolfinx::fem::pack_coefficients) and
+/// reusable work arrays.
+/// @param[in,out] b The vector to be modified
+/// @param[in] a The bilinear form that generates A
+/// @param[in] constants The packed constants of a
+/// @param[in] coefficients The packed coefficients of a
+/// @param[in] bcs1 The boundary conditions on the trial space, used for the
+/// values of the conditions
+/// @param[in] classification1 The classification of the dofs of the trial
+/// space with respect to bcs1
+/// @param[in] x0 The vector used in the lifting. If empty, it is treated
+/// as 0
+/// @param[in] scale Scaling to apply
+/// @param[in] mpc The multi point constraints
+/// @param[in,out] workspace The work arrays of the lifting
+inline void apply_lifting(
+    std::span<std::complex<double>> b,
+    const std::shared_ptr<const dolfinx::fem::Form<std::complex<double>>>& a,
+    std::span<const std::complex<double>> constants,
+    const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                   std::pair<std::span<const std::complex<double>>, int>>&
+        coefficients,
+    const std::vector<std::shared_ptr<
+        const dolfinx::fem::DirichletBC<std::complex<double>>>>& bcs1,
+    const DofClassification<std::complex<double>>& classification1,
+    std::span<const std::complex<double>> x0, double scale,
+    const std::shared_ptr<
+        const dolfinx_mpc::MultiPointConstraint<std::complex<double>>>& mpc,
+    AssemblyWorkspace<std::complex<double>>& workspace)
+{
+  _apply_lifting<std::complex<double>>(b, a, bcs1, classification1, x0, scale,
+                                       mpc, constants, coefficients,
+                                       workspace);
 }
 } // namespace dolfinx_mpc
\ No newline at end of file
@@ -145,14 +145,16 @@ dolfinx::fem::FunctionSpace dolfinx_mpc::create_extended_functionspace(
                  global_blocks.begin(),
                  [block_size](const auto dof) { return dof / block_size; });
 
+  // The dof numbering of the extended space matches the original space, as
+  // new ghosts are appended after the original ones. If no ghosts are added,
+  // the original dofmap is shared instead of copying the cell->dof
+  // connectivity.
   int mpi_size = -1;
   MPI_Comm_size(comm, &mpi_size);
-  std::shared_ptr<const dolfinx::common::IndexMap> new_index_map;
   if (mpi_size == 1)
-  {
-    new_index_map = old_index_map;
-  }
-  else
+    return dolfinx::fem::FunctionSpace(V->mesh(), V->element(), V->dofmap());
+
+  std::shared_ptr<const dolfinx::common::IndexMap> new_index_map;
   {
     // Map global master blocks to local blocks
     V->dofmap()->index_map->global_to_local(global_blocks, local_blocks);
@@ -177,6 +179,17 @@ dolfinx::fem::FunctionSpace dolfinx_mpc::create_extended_functionspace(
       }
     }
 
+    // Reuse the original dofmap if no process adds new ghosts
+    int num_new_ghosts = (int)new_ghosts.size();
+    int max_new_ghosts = 0;
+    MPI_Allreduce(&num_new_ghosts, &max_new_ghosts, 1, MPI_INT, MPI_MAX,
+                  comm);
+    if (max_new_ghosts == 0)
+    {
+      return dolfinx::fem::FunctionSpace(V->mesh(), V->element(),
+                                         V->dofmap());
+    }
+
     // Append new ghosts (and corresponding rank) at the end of the old set of
     // ghosts originating from the old index map
     std::vector<int> ghost_owners = old_index_map->owners();
@@ -200,7 +213,9 @@ dolfinx::fem::FunctionSpace dolfinx_mpc::create_extended_functionspace(
       = old_dofmap.list();
   std::shared_ptr<const dolfinx::fem::FiniteElement> element = V->element();
 
-  // Create the new dofmap based on the extended index map
+  // Create the new dofmap based on the extended index map. The DofMap owns
+  // its adjacency list, so the cell->dof connectivity is copied here
+  // (dolfinx 0.5 has no DofMap sharing the list of another DofMap)
   auto new_dofmap = std::make_shared<const dolfinx::fem::DofMap>(
       old_dofmap.element_dof_layout(), new_index_map, old_dofmap.bs(),
       dofmap_adj, old_dofmap.bs());
@@ -29,6 +29,13 @@ map_dofs_global_to_local(std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
 
 /// Create an function space with an extended index map, where all input dofs
 /// (global index) is added to the local index map as ghosts.
+///
+/// @note In serial, and in parallel if no process adds a ghost, the dofmap
+/// of V is shared by the new space. Otherwise, the cell->dof adjacency list
+/// of V is copied into the dofmap of the new space, as a dolfinx DofMap owns
+/// its list. The copy has the memory footprint of the original dofmap, so
+/// for large parallel runs with off-process masters the connectivity is
+/// stored twice.
 /// @param[in] V The original function space
 /// @param[in] global_dofs The list of master dofs (global index)
 /// @param[in] owners The owners of the master degrees of freedom
@@ -4,8 +4,18 @@
 //
 // SPDX-License-Identifier:    MIT
 
+#pragma once
+
+#include <algorithm>
+#include <array>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace dolfinx_mpc
 {
@@ -19,4 +29,152 @@ MPI_Comm create_owner_to_ghost_comm(const dolfinx::common::IndexMap& map);
 std::pair<std::vector<int>, std::vector<int>>
 compute_neighborhood(const MPI_Comm& comm);
 
+/// Read-only data gathered from the source processes of the processes on a
+/// shared-memory node, stored once per node in an MPI-3 shared memory window.
+/// The node leader receives the data of the union of the sources of the
+/// processes on its node, such that the memory used per node depends on the
+/// size of the neighbourhoods and not on the size of the communicator.
+template <typename T>
+class NodeSharedArray
+{
+public:
+  /// Gather data from the source processes (collective)
+  /// @param[in] comm The communicator
+  /// @param[in] sources The ranks (in `comm`) of the processes whose data is
+  /// read by this process
+  /// @param[in] local_data The data of this process
+  NodeSharedArray(MPI_Comm comm, std::span<const int> sources,
+                  std::span<const T> local_data)
+  {
+    int rank = -1;
+    MPI_Comm_rank(comm, &rank);
+
+    // Create communicator for the node
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL,
+                        &_node_comm);
+    int node_rank = -1;
+    MPI_Comm_rank(_node_comm, &node_rank);
+    int node_size = -1;
+    MPI_Comm_size(_node_comm, &node_size);
+
+    // Compute the union of the sources of the processes on the node
+    {
+      const int num_sources = (int)sources.size();
+      std::vector<int> counts(node_size);
+      MPI_Allgather(&num_sources, 1, MPI_INT, counts.data(), 1, MPI_INT,
+                    _node_comm);
+      std::vector<int> displs(node_size + 1, 0);
+      std::partial_sum(counts.begin(), counts.end(), displs.begin() + 1);
+      _sources.resize(displs.back());
+      MPI_Allgatherv(sources.data(), num_sources, MPI_INT, _sources.data(),
+                     counts.data(), displs.data(), MPI_INT, _node_comm);
+      std::sort(_sources.begin(), _sources.end());
+      _sources.erase(std::unique(_sources.begin(), _sources.end()),
+                     _sources.end());
+    }
+
+    // The node leader receives the data of the sources. Each process sends
+    // its data to the leaders of the nodes that read it
+    const std::vector<int> recv_ranks
+        = node_rank == 0 ? _sources : std::vector<int>();
+    std::vector<int> send_ranks
+        = dolfinx::MPI::compute_graph_edges_nbx(comm, recv_ranks);
+    std::sort(send_ranks.begin(), send_ranks.end());
+    MPI_Comm leader_comm = MPI_COMM_NULL;
+    MPI_Dist_graph_create_adjacent(
+        comm, (int)recv_ranks.size(), recv_ranks.data(), MPI_UNWEIGHTED,
+        (int)send_ranks.size(), send_ranks.data(), MPI_UNWEIGHTED,
+        MPI_INFO_NULL, false, &leader_comm);
+
+    // Send the data size to the leaders, and share the sizes on the node
+    // (push back to avoid null_ptr)
+    if (local_data.size() > (std::size_t)std::numeric_limits<int>::max())
+    {
+      throw std::runtime_error(
+          "Shared data is too large to be gathered with MPI.");
+    }
+    const int local_size = (int)local_data.size();
+    std::vector<int> sizes(_sources.size() + 1, 0);
+    MPI_Neighbor_allgather(&local_size, 1, MPI_INT, sizes.data(), 1, MPI_INT,
+                           leader_comm);
+    MPI_Bcast(sizes.data(), (int)_sources.size(), MPI_INT, 0, _node_comm);
+    sizes.pop_back();
+    _offsets.resize(_sources.size() + 1, 0);
+    std::partial_sum(sizes.begin(), sizes.end(), _offsets.begin() + 1);
+    if (_offsets.back() > std::numeric_limits<int>::max())
+    {
+      throw std::runtime_error(
+          "Shared data is too large to be gathered with MPI.");
+    }
+
+    // Allocate the window on the node leader, and get its address on the
+    // other processes on the node
+    const MPI_Aint win_size
+        = node_rank == 0 ? _offsets.back() * sizeof(T) : 0;
+    MPI_Win_allocate_shared(win_size, sizeof(T), MPI_INFO_NULL, _node_comm,
+                            &_data, &_win);
+    if (node_rank != 0)
+    {
+      MPI_Aint leader_size = 0;
+      int disp_unit = 0;
+      MPI_Win_shared_query(_win, 0, &leader_size, &disp_unit, &_data);
+    }
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, _win);
+
+    // Receive the data of the sources directly into the window
+    std::vector<int> displs(_offsets.begin(), _offsets.end());
+    MPI_Neighbor_allgatherv(local_data.data(), local_size,
+                            dolfinx::MPI::mpi_type<T>(), _data, sizes.data(),
+                            displs.data(), dolfinx::MPI::mpi_type<T>(),
+                            leader_comm);
+    MPI_Comm_free(&leader_comm);
+    MPI_Win_sync(_win);
+    MPI_Barrier(_node_comm);
+    MPI_Win_sync(_win);
+  }
+
+  // Copy constructor (deleted)
+  NodeSharedArray(const NodeSharedArray& array) = delete;
+
+  // Assignment operator (deleted)
+  NodeSharedArray& operator=(const NodeSharedArray& array) = delete;
+
+  /// Destructor (collective on the node)
+  ~NodeSharedArray()
+  {
+    MPI_Win_unlock_all(_win);
+    MPI_Win_free(&_win);
+    MPI_Comm_free(&_node_comm);
+  }
+
+  /// Return the data gathered from a process
+  /// @param[in] rank The rank of the process. It has to be a source of one
+  /// of the processes on this node
+  std::span<const T> links(int rank) const
+  {
+    auto it = std::lower_bound(_sources.begin(), _sources.end(), rank);
+    if (it == _sources.end() or *it != rank)
+    {
+      throw std::runtime_error("No data gathered from process "
+                               + std::to_string(rank) + ".");
+    }
+    const std::size_t i = std::distance(_sources.begin(), it);
+    return std::span<const T>(_data + _offsets[i],
+                              _offsets[i + 1] - _offsets[i]);
+  }
+
+private:
+  // Communicator of the shared-memory node
+  MPI_Comm _node_comm = MPI_COMM_NULL;
+
+  // Shared memory window and its address on this process
+  MPI_Win _win = MPI_WIN_NULL;
+  T* _data = nullptr;
+
+  // Sources of the processes on the node (sorted), and the position of
+  // their data in the window
+  std::vector<int> _sources;
+  std::vector<std::int64_t> _offsets;
+};
+
 } // namespace dolfinx_mpc
\ No newline at end of file
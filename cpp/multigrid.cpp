@@ -0,0 +1,142 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#include "multigrid.h"
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <petscvec.h>
+
+//-----------------------------------------------------------------------------
+dolfinx::la::petsc::Matrix dolfinx_mpc::create_transformation_matrix(
+    const MultiPointConstraint<PetscScalar>& mpc)
+{
+  dolfinx::common::Timer timer("~MPC: Create transformation matrix");
+  std::shared_ptr<const dolfinx::fem::FunctionSpace> V = mpc.function_space();
+  std::shared_ptr<const dolfinx::common::IndexMap> imap
+      = V->dofmap()->index_map;
+  const int bs = V->dofmap()->index_map_bs();
+  const std::int32_t num_owned = bs * imap->size_local();
+  const std::int64_t offset = bs * imap->local_range()[0];
+
+  const std::vector<std::int8_t>& is_slave = mpc.is_slave();
+  std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>> masters
+      = mpc.masters();
+  std::shared_ptr<const dolfinx::graph::AdjacencyList<PetscScalar>> coeffs
+      = mpc.coefficients();
+
+  // Map masters of owned slaves to global dofs
+  const std::int32_t num_local_slaves = mpc.num_local_slaves();
+  const std::vector<std::int32_t>& slaves = mpc.slaves();
+  std::vector<std::int32_t> master_blocks;
+  std::vector<std::int32_t> master_rems;
+  for (std::int32_t i = 0; i < num_local_slaves; ++i)
+  {
+    for (auto master : masters->links(slaves[i]))
+    {
+      std::div_t div = std::div(master, bs);
+      master_blocks.push_back(div.quot);
+      master_rems.push_back(div.rem);
+    }
+  }
+  std::vector<std::int64_t> global_masters(master_blocks.size());
+  imap->local_to_global(master_blocks, global_masters);
+  for (std::size_t i = 0; i < global_masters.size(); ++i)
+    global_masters[i] = global_masters[i] * bs + master_rems[i];
+
+  // Compute number of non-zeros in the diagonal and off-diagonal block of
+  // each row
+  std::vector<PetscInt> d_nnz(num_owned, 1);
+  std::vector<PetscInt> o_nnz(num_owned, 0);
+  {
+    std::size_t c = 0;
+    for (std::int32_t i = 0; i < num_local_slaves; ++i)
+    {
+      const std::int32_t slave = slaves[i];
+      d_nnz[slave] = 0;
+      for (std::size_t j = 0; j < masters->links(slave).size(); ++j)
+      {
+        if (const std::int64_t master = global_masters[c++];
+            master >= offset and master < offset + num_owned)
+        {
+          d_nnz[slave]++;
+        }
+        else
+          o_nnz[slave]++;
+      }
+    }
+  }
+
+  Mat K;
+  MPI_Comm comm = V->mesh()->comm();
+  MatCreate(comm, &K);
+  MatSetSizes(K, num_owned, num_owned, PETSC_DETERMINE, PETSC_DETERMINE);
+  MatSetType(K, MATAIJ);
+  MatSeqAIJSetPreallocation(K, 0, d_nnz.data());
+  MatMPIAIJSetPreallocation(K, 0, d_nnz.data(), 0, o_nnz.data());
+
+  // Identity rows for all dofs that are not slaves
+  for (std::int32_t i = 0; i < num_owned; ++i)
+    if (!is_slave[i])
+      MatSetValue(K, offset + i, offset + i, 1, ADD_VALUES);
+
+  // Coefficient rows for slaves
+  std::size_t c = 0;
+  for (std::int32_t i = 0; i < num_local_slaves; ++i)
+  {
+    const std::int32_t slave = slaves[i];
+    for (auto coeff : coeffs->links(slave))
+      MatSetValue(K, offset + slave, global_masters[c++], coeff, ADD_VALUES);
+  }
+  MatAssemblyBegin(K, MAT_FINAL_ASSEMBLY);
+  MatAssemblyEnd(K, MAT_FINAL_ASSEMBLY);
+
+  dolfinx::la::petsc::Matrix _K(K, false);
+  return _K;
+}
+//-----------------------------------------------------------------------------
+dolfinx::la::petsc::Matrix dolfinx_mpc::create_mpc_prolongation(
+    Mat P, const MultiPointConstraint<PetscScalar>& mpc_coarse,
+    const MultiPointConstraint<PetscScalar>& mpc_fine)
+{
+  dolfinx::common::Timer timer("~MPC: Create prolongation matrix");
+  dolfinx::la::petsc::Matrix K_c = create_transformation_matrix(mpc_coarse);
+
+  // P K_c
+  Mat P_mpc;
+  MatMatMult(P, K_c.mat(), MAT_INITIAL_MATRIX, PETSC_DEFAULT, &P_mpc);
+
+  // Zero rows of fine slaves
+  std::shared_ptr<const dolfinx::fem::FunctionSpace> V_fine
+      = mpc_fine.function_space();
+  const int bs = V_fine->dofmap()->index_map_bs();
+  const std::int32_t num_owned
+      = bs * V_fine->dofmap()->index_map->size_local();
+  Vec z;
+  MatCreateVecs(P_mpc, nullptr, &z);
+  PetscInt z_size;
+  VecGetLocalSize(z, &z_size);
+  if (z_size != num_owned)
+  {
+    VecDestroy(&z);
+    MatDestroy(&P_mpc);
+    throw std::runtime_error("Row layout of prolongation matrix does not "
+                             "match the fine function space.");
+  }
+  PetscScalar* z_array;
+  VecGetArray(z, &z_array);
+  const std::vector<std::int8_t>& is_slave = mpc_fine.is_slave();
+  for (std::int32_t i = 0; i < num_owned; ++i)
+    z_array[i] = is_slave[i] ? 0 : 1;
+  VecRestoreArray(z, &z_array);
+  MatDiagonalScale(P_mpc, z, nullptr);
+  VecDestroy(&z);
+
+  dolfinx::la::petsc::Matrix _P(P_mpc, false);
+  return _P;
+}
+//-----------------------------------------------------------------------------
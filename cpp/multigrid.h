@@ -0,0 +1,40 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#pragma once
+
+#include "MultiPointConstraint.h"
+#include <dolfinx/la/petsc.h>
+#include <petscmat.h>
+
+namespace dolfinx_mpc
+{
+
+/// Create the transformation matrix K of a multi-point constraint, mapping a
+/// vector where the slave entries are ignored to the vector satisfying the
+/// constraint, i.e. u = K u_reduced. Rows of non-slave dofs are identity
+/// rows, while the row of a slave dof contains the coefficients at its
+/// masters. The columns of the slave dofs are zero.
+/// @param[in] mpc The multi-point constraint
+/// @returns The transformation matrix (distributed as the rows of the
+/// function space of the constraint)
+dolfinx::la::petsc::Matrix
+create_transformation_matrix(const MultiPointConstraint<PetscScalar>& mpc);
+
+/// Create a prolongation matrix between two levels with multi-point
+/// constraints, P_mpc = Z_f P K_c, where K_c is the transformation matrix of
+/// the coarse constraint and Z_f a diagonal matrix zeroing the slave rows of
+/// the fine constraint. The restriction is given by the transpose of P_mpc.
+/// @param[in] P The prolongation (interpolation) matrix from the coarse to
+/// the fine function space (without constraints)
+/// @param[in] mpc_coarse The constraint on the coarse level
+/// @param[in] mpc_fine The constraint on the fine level
+/// @returns The constraint consistent prolongation matrix
+dolfinx::la::petsc::Matrix create_mpc_prolongation(
+    Mat P, const MultiPointConstraint<PetscScalar>& mpc_coarse,
+    const MultiPointConstraint<PetscScalar>& mpc_fine);
+
+} // namespace dolfinx_mpc
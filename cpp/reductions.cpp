@@ -0,0 +1,96 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#include "reductions.h"
+#include "assemble_vector.h"
+#include "lifting.h"
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/la/petsc.h>
+
+//-----------------------------------------------------------------------------
+double dolfinx_mpc::assemble_residual(
+    Vec b, const dolfinx::fem::Form<PetscScalar>& L,
+    const std::shared_ptr<const dolfinx::fem::Form<PetscScalar>>& a,
+    const std::vector<
+        std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
+    Vec x,
+    const std::shared_ptr<const MultiPointConstraint<PetscScalar>>& mpc,
+    dolfinx::la::Norm type)
+{
+  dolfinx::common::Timer timer("~MPC: Assemble residual and norm");
+
+  auto check = [](PetscErrorCode ierr, const std::string& fn)
+  {
+    if (ierr != 0)
+      dolfinx::la::petsc::error(ierr, __FILE__, fn);
+  };
+
+  // Assemble and lift the residual in the local (owned and ghost) part of
+  // the vector
+  {
+    Vec b_local = nullptr;
+    Vec x_local = nullptr;
+    check(VecGhostGetLocalForm(b, &b_local), "VecGhostGetLocalForm");
+    if (!b_local)
+    {
+      throw std::runtime_error(
+          "Cannot assemble residual. Residual vector is not ghosted.");
+    }
+    check(VecGhostGetLocalForm(x, &x_local), "VecGhostGetLocalForm");
+    if (!x_local)
+    {
+      check(VecGhostRestoreLocalForm(b, &b_local),
+            "VecGhostRestoreLocalForm");
+      throw std::runtime_error(
+          "Cannot assemble residual. Solution vector is not ghosted.");
+    }
+    PetscInt n = 0;
+    check(VecGetSize(b_local, &n), "VecGetSize");
+    PetscInt n_x = 0;
+    check(VecGetSize(x_local, &n_x), "VecGetSize");
+    PetscScalar* array = nullptr;
+    check(VecGetArray(b_local, &array), "VecGetArray");
+    const PetscScalar* x_array = nullptr;
+    check(VecGetArrayRead(x_local, &x_array), "VecGetArrayRead");
+    std::span<PetscScalar> _b_local(array, n);
+    std::fill(_b_local.begin(), _b_local.end(), PetscScalar(0));
+    dolfinx_mpc::assemble_vector(_b_local, L, mpc);
+    dolfinx_mpc::apply_lifting(_b_local, {a}, {bcs},
+                               {std::span<const PetscScalar>(x_array, n_x)},
+                               -1.0, mpc);
+    check(VecRestoreArrayRead(x_local, &x_array), "VecRestoreArrayRead");
+    check(VecRestoreArray(b_local, &array), "VecRestoreArray");
+    check(VecGhostRestoreLocalForm(x, &x_local), "VecGhostRestoreLocalForm");
+    check(VecGhostRestoreLocalForm(b, &b_local), "VecGhostRestoreLocalForm");
+  }
+
+  // Accumulate ghost contributions
+  check(VecGhostUpdateBegin(b, ADD_VALUES, SCATTER_REVERSE),
+        "VecGhostUpdateBegin");
+  check(VecGhostUpdateEnd(b, ADD_VALUES, SCATTER_REVERSE),
+        "VecGhostUpdateEnd");
+
+  // Set the boundary values on the owned dofs (which only visits the
+  // Dirichlet dofs), and compute the norm of the owned entries that are not
+  // slaves in one pass
+  PetscInt n = 0;
+  check(VecGetLocalSize(b, &n), "VecGetLocalSize");
+  PetscScalar* array = nullptr;
+  check(VecGetArray(b, &array), "VecGetArray");
+  const PetscScalar* x_array = nullptr;
+  check(VecGetArrayRead(x, &x_array), "VecGetArrayRead");
+  std::span<PetscScalar> _b(array, n);
+  dolfinx::fem::set_bc<PetscScalar>(
+      _b, bcs, std::span<const PetscScalar>(x_array, n), -1.0);
+  const double value = impl::local_norm<PetscScalar>(
+      _b, std::span(mpc->is_slave().data(), n), type);
+  check(VecRestoreArrayRead(x, &x_array), "VecRestoreArrayRead");
+  check(VecRestoreArray(b, &array), "VecRestoreArray");
+
+  return impl::reduce_norm(mpc->function_space()->mesh()->comm(), value, type);
+}
+//-----------------------------------------------------------------------------
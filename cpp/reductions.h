@@ -0,0 +1,228 @@
+// Copyright (C) 2022 Jorgen S. Dokken
+//
+// This file is part of DOLFINX_MPC
+//
+// SPDX-License-Identifier:    MIT
+
+#pragma once
+
+#include "MultiPointConstraint.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/fem/DirichletBC.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/la/utils.h>
+#include <functional>
+#include <memory>
+#include <petscvec.h>
+#include <span>
+#include <vector>
+
+namespace dolfinx_mpc
+{
+namespace impl
+{
+/// Compute the owned entries of K^T x, where K is the prolongation from the
+/// constrained space to the full space, i.e. the slave entries are moved to
+/// their masters (which can be owned by other processes)
+/// @param[in] x The vector (local to process, the owned entries are used)
+/// @param[in] mpc The multi point constraint
+/// @returns The owned entries of K^T x
+template <typename T>
+std::vector<T> condense(std::span<const T> x,
+                        const MultiPointConstraint<T>& mpc)
+{
+  std::shared_ptr<const dolfinx::fem::DofMap> dofmap
+      = mpc.function_space()->dofmap();
+  const int bs = dofmap->index_map_bs();
+  const std::int32_t num_owned = bs * dofmap->index_map->size_local();
+  const std::vector<std::int8_t>& is_slave = mpc.is_slave();
+
+  dolfinx::la::Vector<T> y(dofmap->index_map, bs);
+  std::span<T> _y = y.mutable_array();
+  std::fill(_y.begin(), _y.end(), T(0));
+  for (std::int32_t i = 0; i < num_owned; ++i)
+    if (!is_slave[i])
+      _y[i] = x[i];
+
+  // Move the owned slave entries to the masters, and send the contributions
+  // to ghost masters to the owners
+  const std::vector<std::int32_t>& slaves = mpc.slaves();
+  std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>> masters
+      = mpc.masters();
+  std::shared_ptr<const dolfinx::graph::AdjacencyList<T>> coeffs
+      = mpc.coefficients();
+  for (std::int32_t i = 0; i < mpc.num_local_slaves(); ++i)
+  {
+    auto masters_i = masters->links(slaves[i]);
+    auto coeffs_i = coeffs->links(slaves[i]);
+    for (std::size_t j = 0; j < masters_i.size(); ++j)
+      _y[masters_i[j]] += coeffs_i[j] * x[slaves[i]];
+  }
+  y.scatter_rev(std::plus<T>());
+  return std::vector<T>(_y.begin(), std::next(_y.begin(), num_owned));
+}
+
+/// Compute the local contribution to a norm of the owned entries of a
+/// vector, skipping the entries where mask is set
+/// @param[in] x The owned entries
+/// @param[in] mask Marker for the entries to skip. If empty, all entries are
+/// used
+/// @param[in] type The norm type
+/// @returns The sum of |x_i| (l1), the sum of |x_i|^2 (l2) or max |x_i| (linf)
+template <typename T>
+double local_norm(std::span<const T> x, std::span<const std::int8_t> mask,
+                  dolfinx::la::Norm type)
+{
+  double value = 0;
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    if (!mask.empty() and mask[i])
+      continue;
+    const double abs = std::abs(x[i]);
+    switch (type)
+    {
+    case dolfinx::la::Norm::l1:
+      value += abs;
+      break;
+    case dolfinx::la::Norm::l2:
+      value += abs * abs;
+      break;
+    case dolfinx::la::Norm::linf:
+      value = std::max(value, abs);
+      break;
+    default:
+      throw std::runtime_error("Norm type not supported");
+    }
+  }
+  return value;
+}
+
+/// Reduce the local contributions to a norm over all processes
+/// @param[in] comm The communicator
+/// @param[in] value The local contribution, see local_norm
+/// @param[in] type The norm type
+/// @returns The norm
+inline double reduce_norm(MPI_Comm comm, double value, dolfinx::la::Norm type)
+{
+  double global_value = 0;
+  MPI_Allreduce(&value, &global_value, 1, MPI_DOUBLE,
+                type == dolfinx::la::Norm::linf ? MPI_MAX : MPI_SUM, comm);
+  return type == dolfinx::la::Norm::l2 ? std::sqrt(global_value)
+                                       : global_value;
+}
+} // namespace impl
+
+/// Compute the inner product (x, y) = sum_i conj(x_i) y_i of two vectors on
+/// the constrained space.
+/// @param[in] x The first vector (local to process)
+/// @param[in] y The second vector (local to process)
+/// @param[in] mpc The multi point constraint
+/// @param[in] condense If false, the slave entries are skipped, which is the
+/// inner product of vectors assembled with the constraint. If true, the slave
+/// entries are moved to their masters (K^T x and K^T y) before the product is
+/// computed, which is the inner product of unconstrained (dual) vectors
+/// restricted to the constrained space
+/// @returns The inner product (collective)
+template <typename T>
+T inner_product(std::span<const T> x, std::span<const T> y,
+                const MultiPointConstraint<T>& mpc, bool condense = false)
+{
+  std::shared_ptr<const dolfinx::fem::FunctionSpace> V = mpc.function_space();
+  const std::int32_t num_owned = V->dofmap()->index_map_bs()
+                                 * V->dofmap()->index_map->size_local();
+
+  T local_value = 0;
+  auto add = [&local_value](std::span<const T> x, std::span<const T> y,
+                            std::span<const std::int8_t> mask)
+  {
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+      if (mask.empty() or !mask[i])
+      {
+        if constexpr (std::is_same_v<T, std::complex<double>>)
+          local_value += std::conj(x[i]) * y[i];
+        else
+          local_value += x[i] * y[i];
+      }
+    }
+  };
+  if (condense)
+  {
+    const std::vector<T> x_c = impl::condense(x, mpc);
+    const std::vector<T> y_c = impl::condense(y, mpc);
+    add(x_c, y_c, {});
+  }
+  else
+  {
+    add(x.first(num_owned), y.first(num_owned),
+        std::span(mpc.is_slave().data(), num_owned));
+  }
+
+  T value = 0;
+  MPI_Allreduce(&local_value, &value, 1, dolfinx::MPI::mpi_type<T>(), MPI_SUM,
+                V->mesh()->comm());
+  return value;
+}
+
+/// Compute the norm of a vector on the constrained space.
+/// @param[in] x The vector (local to process)
+/// @param[in] mpc The multi point constraint
+/// @param[in] type The norm type (l1, l2 or linf)
+/// @param[in] condense If false, the slave entries are skipped. If true, the
+/// norm of K^T x is computed, see inner_product
+/// @returns The norm (collective)
+template <typename T>
+double norm(std::span<const T> x, const MultiPointConstraint<T>& mpc,
+            dolfinx::la::Norm type = dolfinx::la::Norm::l2,
+            bool condense = false)
+{
+  std::shared_ptr<const dolfinx::fem::FunctionSpace> V = mpc.function_space();
+  const std::int32_t num_owned = V->dofmap()->index_map_bs()
+                                 * V->dofmap()->index_map->size_local();
+  double value = 0;
+  if (condense)
+  {
+    const std::vector<T> x_c = impl::condense(x, mpc);
+    value = impl::local_norm<T>(x_c, {}, type);
+  }
+  else
+  {
+    value = impl::local_norm<T>(x.first(num_owned),
+                                std::span(mpc.is_slave().data(), num_owned),
+                                type);
+  }
+  return impl::reduce_norm(V->mesh()->comm(), value, type);
+}
+
+/// Assemble the residual of a nonlinear problem with a multi point
+/// constraint, and compute its norm on the constrained space.
+///
+/// The residual b = K^T F(x) is assembled, lifted with -J (g - x), the ghost
+/// contributions are sent to the owners and the Dirichlet dofs are set to
+/// -(g - x). The norm of the owned, non-slave entries is then computed in
+/// one pass over the owned entries, while the array of b is still held, and
+/// reduced over the processes with a single reduction. Throws if b or x is
+/// not ghosted.
+/// @param[in, out] b The ghosted residual vector. It is zeroed before
+/// assembly
+/// @param[in] L The residual form
+/// @param[in] a The Jacobian form, used for the lifting
+/// @param[in] bcs The Dirichlet conditions
+/// @param[in] x The ghosted vector with the current solution
+/// @param[in] mpc The multi point constraint
+/// @param[in] type The norm type (l1, l2 or linf)
+/// @returns The norm of the residual (collective)
+double assemble_residual(
+    Vec b, const dolfinx::fem::Form<PetscScalar>& L,
+    const std::shared_ptr<const dolfinx::fem::Form<PetscScalar>>& a,
+    const std::vector<
+        std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
+    Vec x,
+    const std::shared_ptr<const MultiPointConstraint<PetscScalar>>& mpc,
+    dolfinx::la::Norm type = dolfinx::la::Norm::l2);
+
+} // namespace dolfinx_mpc
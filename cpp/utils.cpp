@@ -6,10 +6,15 @@
 
 #include "utils.h"
 #include <algorithm>
+#include <basix/finite-element.h>
 #include <basix/mdspan.hpp>
+#include <dolfinx/fem/ElementDofLayout.h>
 #include <dolfinx/geometry/utils.h>
+#include <dolfinx/la/Vector.h>
 #include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/cell_types.h>
 #include <dolfinx/mesh/utils.h>
+#include <numeric>
 #include <xtensor/xcomplex.hpp>
 #include <xtensor/xsort.hpp>
 #include <xtensor/xview.hpp>
@@ -93,6 +98,129 @@ create_block_to_facet_map(std::shared_ptr<dolfinx::fem::FunctionSpace> V,
   return dolfinx::graph::AdjacencyList<std::int32_t>(data, offsets);
 }
 
+/// Compute the barycentric coordinates of the orthogonal projection of a
+/// point onto the affine hull of a simplex
+/// @param[in] x The vertex coordinates of the simplex, shape (tdim+1, 3)
+/// @param[in] tdim The topological dimension of the simplex
+/// @param[in] p The point
+/// @param[in, out] work Work array of size at least 2 * 9. On exit, the first
+/// 3 * tdim entries contain the edges x_k - x_0, stored as J[3(k-1)+i]
+/// @param[out] lambda The barycentric coordinates of vertex 1, ..., tdim
+/// @returns False if the simplex is degenerate
+bool compute_barycentric_coordinates(std::span<const double> x, int tdim,
+                                     std::span<const double, 3> p,
+                                     std::span<double> work,
+                                     std::span<double, 3> lambda)
+{
+  assert(work.size() >= 18);
+  // Jacobian J (column k is the kth edge from vertex 0), stored as J[3k+i],
+  // and the normal equations G = J^T J, b = J^T (p - x_0)
+  std::span<double> J = work.subspan(0, 9);
+  std::span<double> G = work.subspan(9, 9);
+  for (int k = 0; k < tdim; ++k)
+    for (int i = 0; i < 3; ++i)
+      J[3 * k + i] = x[3 * (k + 1) + i] - x[i];
+  std::array<double, 3> b = {0, 0, 0};
+  for (int k = 0; k < tdim; ++k)
+  {
+    for (int l = 0; l < tdim; ++l)
+    {
+      G[3 * k + l] = 0;
+      for (int i = 0; i < 3; ++i)
+        G[3 * k + l] += J[3 * k + i] * J[3 * l + i];
+    }
+    for (int i = 0; i < 3; ++i)
+      b[k] += J[3 * k + i] * (p[i] - x[i]);
+  }
+
+  // Solve G lambda = b by Cramer's rule
+  std::fill(lambda.begin(), lambda.end(), 0);
+  switch (tdim)
+  {
+  case 1:
+  {
+    if (G[0] == 0)
+      return false;
+    lambda[0] = b[0] / G[0];
+    return true;
+  }
+  case 2:
+  {
+    const double det = G[0] * G[4] - G[1] * G[3];
+    if (det == 0)
+      return false;
+    lambda[0] = (b[0] * G[4] - G[1] * b[1]) / det;
+    lambda[1] = (G[0] * b[1] - b[0] * G[3]) / det;
+    return true;
+  }
+  case 3:
+  {
+    const double c0 = G[4] * G[8] - G[5] * G[7];
+    const double c1 = G[5] * G[6] - G[3] * G[8];
+    const double c2 = G[3] * G[7] - G[4] * G[6];
+    const double det = G[0] * c0 + G[1] * c1 + G[2] * c2;
+    if (det == 0)
+      return false;
+    lambda[0] = (b[0] * c0 + G[1] * (b[2] * G[5] - b[1] * G[8])
+                 + G[2] * (b[1] * G[7] - b[2] * G[4]))
+                / det;
+    lambda[1] = (G[0] * (b[1] * G[8] - G[5] * b[2]) + b[0] * c1
+                 + G[2] * (G[3] * b[2] - b[1] * G[6]))
+                / det;
+    lambda[2] = (G[0] * (G[4] * b[2] - b[1] * G[7])
+                 + G[1] * (b[1] * G[6] - G[3] * b[2]) + b[0] * c2)
+                / det;
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+/// Compute an upper bound for the squared distance between a point and an
+/// affine simplex, using the barycentric coordinates of the orthogonal
+/// projection of the point onto the affine hull of the simplex. Negative
+/// barycentric coordinates are clamped to zero, which makes the bound exact
+/// if the projection is inside the simplex.
+/// @param[in] x The vertex coordinates of the simplex, shape (tdim+1, 3)
+/// @param[in] tdim The topological dimension of the simplex
+/// @param[in] p The point
+/// @param[in, out] work Work array of size at least 2 * 9
+/// @returns The squared distance bound, or -1 if the simplex is degenerate
+double simplex_squared_distance_bound(std::span<const double> x, int tdim,
+                                      std::span<const double, 3> p,
+                                      std::span<double> work)
+{
+  std::array<double, 3> lambda;
+  if (!compute_barycentric_coordinates(x, tdim, p, work, lambda))
+    return -1;
+  std::span<const double> J = work.subspan(0, 9);
+
+  // Clamp barycentric coordinates to the simplex
+  double sum = 0;
+  for (int k = 0; k < tdim; ++k)
+  {
+    lambda[k] = std::max(lambda[k], 0.0);
+    sum += lambda[k];
+  }
+  if (const double lambda_0 = 1 - sum; lambda_0 < 0)
+  {
+    for (int k = 0; k < tdim; ++k)
+      lambda[k] /= sum;
+  }
+
+  // Squared distance between point and x_0 + J lambda
+  double d2 = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    double y = x[i];
+    for (int k = 0; k < tdim; ++k)
+      y += J[3 * k + i] * lambda[k];
+    d2 += (p[i] - y) * (p[i] - y);
+  }
+  return d2;
+}
+
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -355,6 +483,46 @@ std::array<MPI_Comm, 2> dolfinx_mpc::create_neighborhood_comms(
   return comms;
 }
 //-----------------------------------------------------------------------------
+dolfinx::graph::AdjacencyList<std::int32_t>
+dolfinx_mpc::compute_slave_to_neighbor(std::span<const std::int32_t> slaves,
+                                       const dolfinx::common::IndexMap& imap,
+                                       int bs)
+{
+  const std::vector<std::int32_t>& dest_ranks = imap.dest();
+  assert(std::is_sorted(dest_ranks.begin(), dest_ranks.end()));
+
+  // Map each owned block to the processes ghosting it
+  const dolfinx::graph::AdjacencyList<int> shared_indices
+      = imap.index_to_dest_ranks();
+
+  // Compute the neighbourhood index of each (slave, ghost process) pair by
+  // binary search in the sorted destination ranks
+  std::vector<std::int32_t> offsets(slaves.size() + 1, 0);
+  for (std::size_t i = 0; i < slaves.size(); ++i)
+  {
+    const std::int32_t block = slaves[i] / bs;
+    assert(block < imap.size_local());
+    offsets[i + 1] = offsets[i] + shared_indices.num_links(block);
+  }
+  std::vector<std::int32_t> neighbors(offsets.back());
+  for (std::size_t i = 0; i < slaves.size(); ++i)
+  {
+    auto procs = shared_indices.links(slaves[i] / bs);
+    std::transform(procs.begin(), procs.end(),
+                   std::next(neighbors.begin(), offsets[i]),
+                   [&dest_ranks](auto proc)
+                   {
+                     auto it = std::lower_bound(dest_ranks.begin(),
+                                                dest_ranks.end(), proc);
+                     assert(it != dest_ranks.end() and *it == proc);
+                     return (std::int32_t)std::distance(dest_ranks.begin(),
+                                                        it);
+                   });
+  }
+  return dolfinx::graph::AdjacencyList<std::int32_t>(std::move(neighbors),
+                                                     std::move(offsets));
+}
+//-----------------------------------------------------------------------------
 MPI_Comm dolfinx_mpc::create_owner_to_ghost_comm(
     std::vector<std::int32_t>& local_blocks,
     std::vector<std::int32_t>& ghost_blocks,
@@ -647,6 +815,523 @@ dolfinx::la::SparsityPattern dolfinx_mpc::create_sparsity_pattern(
   return pattern;
 }
 
+//-----------------------------------------------------------------------------
+dolfinx_mpc::sparsity_estimate dolfinx_mpc::estimate_sparsity(
+    const dolfinx::fem::Form<PetscScalar>& a,
+    const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc0,
+    const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc1)
+{
+  dolfinx::common::Timer timer("~MPC: Estimate sparsity pattern");
+  if (a.rank() != 2)
+  {
+    throw std::runtime_error(
+        "Cannot estimate sparsity pattern. Form is not a bilinear form");
+  }
+
+  std::shared_ptr<const dolfinx::fem::DofMap> dofmap0
+      = mpc0->function_space()->dofmap();
+  std::shared_ptr<const dolfinx::fem::DofMap> dofmap1
+      = mpc1->function_space()->dofmap();
+  const dolfinx::graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
+  const dolfinx::graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
+  std::shared_ptr<const dolfinx::common::IndexMap> map0 = dofmap0->index_map;
+  std::shared_ptr<const dolfinx::common::IndexMap> map1 = dofmap1->index_map;
+  const std::int32_t num_rows = map0->size_local() + map0->num_ghosts();
+  const std::int32_t num_cols = map1->size_local() + map1->num_ghosts();
+  const std::int32_t num_cells = dofs0.num_nodes();
+
+  // Compute the master blocks of the slaves in each cell
+  auto compute_cell_masters
+      = [num_cells](const dolfinx_mpc::MultiPointConstraint<PetscScalar>& mpc)
+  {
+    const int bs = mpc.function_space()->dofmap()->index_map_bs();
+    std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
+        cell_to_slaves = mpc.cell_to_slaves();
+    std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
+        masters = mpc.masters();
+    std::vector<std::int32_t> offsets(num_cells + 1, 0);
+    std::vector<std::int32_t> data;
+    for (std::int32_t c = 0; c < num_cells; ++c)
+    {
+      if (c < cell_to_slaves->num_nodes())
+      {
+        for (auto slave : cell_to_slaves->links(c))
+          for (auto master : masters->links(slave))
+            data.push_back(master / bs);
+      }
+      std::sort(std::next(data.begin(), offsets[c]), data.end());
+      data.erase(std::unique(std::next(data.begin(), offsets[c]), data.end()),
+                 data.end());
+      offsets[c + 1] = data.size();
+    }
+    return dolfinx::graph::AdjacencyList<std::int32_t>(std::move(data),
+                                                       std::move(offsets));
+  };
+  const dolfinx::graph::AdjacencyList<std::int32_t> cell_masters0
+      = compute_cell_masters(*mpc0);
+  const dolfinx::graph::AdjacencyList<std::int32_t> cell_masters1
+      = mpc0 == mpc1 ? cell_masters0 : compute_cell_masters(*mpc1);
+
+  // Invert a map from cells to row blocks
+  auto invert = [num_rows](const dolfinx::graph::AdjacencyList<std::int32_t>&
+                               cell_to_rows)
+  {
+    std::vector<std::int32_t> offsets(num_rows + 1, 0);
+    for (auto row : cell_to_rows.array())
+      offsets[row + 1]++;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<std::int32_t> data(offsets.back());
+    std::vector<std::int32_t> pos(offsets.begin(), std::prev(offsets.end()));
+    for (std::int32_t c = 0; c < cell_to_rows.num_nodes(); ++c)
+      for (auto row : cell_to_rows.links(c))
+        data[pos[row]++] = c;
+    return dolfinx::graph::AdjacencyList<std::int32_t>(std::move(data),
+                                                       std::move(offsets));
+  };
+  const dolfinx::graph::AdjacencyList<std::int32_t> row_to_cells
+      = invert(dofs0);
+  const dolfinx::graph::AdjacencyList<std::int32_t> master_to_cells
+      = invert(cell_masters0);
+
+  // Cells whose column dofs are coupled to the rows of each cell in the
+  // standard pattern. Cell and exterior facet integrals couple a cell to
+  // itself, and interior facet integrals couple the two cells of each
+  // interior facet to each other
+  std::vector<std::int32_t> coupled_offsets(num_cells + 1, 0);
+  std::vector<std::int32_t> coupled_cells;
+  {
+    const dolfinx::mesh::Mesh& mesh = *(a.mesh());
+    const int tdim = mesh.topology().dim();
+    const bool interior_facets
+        = a.integral_ids(dolfinx::fem::IntegralType::interior_facet).size()
+          > 0;
+    const bool self_coupling
+        = a.integral_ids(dolfinx::fem::IntegralType::cell).size() > 0
+          or a.integral_ids(dolfinx::fem::IntegralType::exterior_facet).size()
+                 > 0
+          or interior_facets;
+
+    // Flattened list of (cell, coupled cell) pairs
+    std::vector<std::int32_t> pairs;
+    if (self_coupling)
+    {
+      pairs.reserve(2 * num_cells);
+      for (std::int32_t c = 0; c < num_cells; ++c)
+        pairs.insert(pairs.end(), {c, c});
+    }
+    if (interior_facets)
+    {
+      mesh.topology_mutable().create_entities(tdim - 1);
+      mesh.topology_mutable().create_connectivity(tdim - 1, tdim);
+      std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
+          facet_to_cell = mesh.topology().connectivity(tdim - 1, tdim);
+      for (std::int32_t f = 0; f < facet_to_cell->num_nodes(); ++f)
+      {
+        std::span<const std::int32_t> cells = facet_to_cell->links(f);
+        if (cells.size() == 2)
+          pairs.insert(pairs.end(), {cells[0], cells[1], cells[1], cells[0]});
+      }
+    }
+
+    for (std::size_t i = 0; i < pairs.size(); i += 2)
+      coupled_offsets[pairs[i] + 1]++;
+    std::partial_sum(coupled_offsets.begin(), coupled_offsets.end(),
+                     coupled_offsets.begin());
+    coupled_cells.resize(coupled_offsets.back());
+    std::vector<std::int32_t> pos(coupled_offsets.begin(),
+                                  std::prev(coupled_offsets.end()));
+    for (std::size_t i = 0; i < pairs.size(); i += 2)
+      coupled_cells[pos[pairs[i]]++] = pairs[i + 1];
+  }
+
+  // Count the distinct column blocks of each row (owned and ghost), where
+  // the columns of the standard pattern are marked before the ones added by
+  // the constraints. The constraints add the cell columns to the rows of the
+  // masters in the cell, the masters to the rows of the cell, and (for a
+  // single constraint) the masters in a cell to each other
+  dolfinx::la::Vector<std::int32_t> standard_count(map0, 1);
+  dolfinx::la::Vector<std::int32_t> master_count(map0, 1);
+  std::span<std::int32_t> _standard_count = standard_count.mutable_array();
+  std::span<std::int32_t> _master_count = master_count.mutable_array();
+  std::vector<std::int32_t> marker(num_cols, -1);
+  for (std::int32_t row = 0; row < num_rows; ++row)
+  {
+    std::int32_t count = 0;
+    for (auto cell : row_to_cells.links(row))
+    {
+      for (std::int32_t i = coupled_offsets[cell];
+           i < coupled_offsets[cell + 1]; ++i)
+      {
+        for (auto col : dofs1.links(coupled_cells[i]))
+        {
+          if (marker[col] != row)
+          {
+            marker[col] = row;
+            ++count;
+          }
+        }
+      }
+    }
+    _standard_count[row] = count;
+
+    count = 0;
+    auto mark = [&marker, &count, row](std::span<const std::int32_t> cols)
+    {
+      for (auto col : cols)
+      {
+        if (marker[col] != row)
+        {
+          marker[col] = row;
+          ++count;
+        }
+      }
+    };
+    for (auto cell : row_to_cells.links(row))
+      mark(cell_masters1.links(cell));
+    for (auto cell : master_to_cells.links(row))
+    {
+      mark(dofs1.links(cell));
+      if (mpc0 == mpc1)
+        mark(cell_masters0.links(cell));
+    }
+    _master_count[row] = count;
+  }
+
+  // Count ghost rows with entries before they are sent to the owners
+  const std::int32_t num_owned = map0->size_local();
+  std::int32_t num_off_process_rows = 0;
+  for (std::int32_t row = num_owned; row < num_rows; ++row)
+    if (_standard_count[row] + _master_count[row] > 0)
+      ++num_off_process_rows;
+
+  // Add the counts of the ghost rows to the owned rows
+  standard_count.scatter_rev(std::plus<std::int32_t>());
+  master_count.scatter_rev(std::plus<std::int32_t>());
+
+  sparsity_estimate estimate;
+  estimate.row_nonzeros.resize(num_owned);
+  estimate.standard_nonzeros = 0;
+  estimate.master_nonzeros = 0;
+  estimate.num_off_process_rows = num_off_process_rows;
+  const std::int64_t num_global_cols = map1->size_global();
+  for (std::int32_t row = 0; row < num_owned; ++row)
+  {
+    const std::int64_t standard
+        = std::min<std::int64_t>(_standard_count[row], num_global_cols);
+    const std::int64_t total = std::min<std::int64_t>(
+        _standard_count[row] + _master_count[row], num_global_cols);
+    estimate.row_nonzeros[row] = total;
+    estimate.standard_nonzeros += standard;
+    estimate.master_nonzeros += total - standard;
+  }
+  return estimate;
+}
+//-----------------------------------------------------------------------------
+dolfinx::la::SparsityPattern dolfinx_mpc::create_symmetric_sparsity_pattern(
+    const dolfinx::fem::Form<PetscScalar>& a,
+    const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc)
+{
+  LOG(INFO) << "Generating symmetric MPC sparsity pattern";
+  dolfinx::common::Timer timer("~MPC: Create symmetric sparsity pattern");
+  if (a.rank() != 2)
+  {
+    throw std::runtime_error(
+        "Cannot create sparsity pattern. Form is not a bilinear form");
+  }
+  if (*a.function_spaces()[0] != *a.function_spaces()[1])
+  {
+    throw std::runtime_error("Cannot create symmetric sparsity pattern. Test "
+                             "and trial spaces are not the same.");
+  }
+
+  std::shared_ptr<const dolfinx::fem::DofMap> dofmap
+      = mpc->function_space()->dofmap();
+  std::shared_ptr<const dolfinx::common::IndexMap> map = dofmap->index_map;
+  const int bs = dofmap->index_map_bs();
+  const dolfinx::mesh::Mesh& mesh = *(a.mesh());
+  dolfinx::la::SparsityPattern pattern(mesh.comm(), {map, map}, {bs, bs});
+
+  // Global index of each block (local + ghost)
+  const std::int32_t num_blocks = map->size_local() + map->num_ghosts();
+  std::vector<std::int32_t> blocks(num_blocks);
+  std::iota(blocks.begin(), blocks.end(), 0);
+  std::vector<std::int64_t> global_blocks(num_blocks);
+  map->local_to_global(blocks, global_blocks);
+
+  // Insert the entries (i, j) of rows x cols where the global index of i is
+  // less than or equal to the global index of j
+  std::vector<std::int32_t> upper_cols;
+  auto insert_upper
+      = [&pattern, &global_blocks,
+         &upper_cols](std::span<const std::int32_t> rows,
+                      std::span<const std::int32_t> cols)
+  {
+    for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+      const std::int64_t row = global_blocks[rows[i]];
+      upper_cols.clear();
+      std::copy_if(cols.begin(), cols.end(), std::back_inserter(upper_cols),
+                   [&global_blocks, row](auto col)
+                   { return row <= global_blocks[col]; });
+      pattern.insert(rows.subspan(i, 1), upper_cols);
+    }
+  };
+
+  // Standard pattern of the form
+  const int tdim = mesh.topology().dim();
+  if (a.integral_ids(dolfinx::fem::IntegralType::cell).size() > 0)
+  {
+    std::shared_ptr<const dolfinx::common::IndexMap> cell_map
+        = mesh.topology().index_map(tdim);
+    const std::int32_t num_cells
+        = cell_map->size_local() + cell_map->num_ghosts();
+    for (std::int32_t c = 0; c < num_cells; ++c)
+    {
+      std::span<const std::int32_t> dofs = dofmap->cell_dofs(c);
+      insert_upper(dofs, dofs);
+    }
+  }
+  const bool interior_facets
+      = a.integral_ids(dolfinx::fem::IntegralType::interior_facet).size() > 0;
+  const bool exterior_facets
+      = a.integral_ids(dolfinx::fem::IntegralType::exterior_facet).size() > 0;
+  if (interior_facets or exterior_facets)
+  {
+    mesh.topology_mutable().create_entities(tdim - 1);
+    mesh.topology_mutable().create_connectivity(tdim - 1, tdim);
+    std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
+        facet_to_cell = mesh.topology().connectivity(tdim - 1, tdim);
+    std::vector<std::int32_t> macro_dofs;
+    for (std::int32_t f = 0; f < facet_to_cell->num_nodes(); ++f)
+    {
+      std::span<const std::int32_t> cells = facet_to_cell->links(f);
+      if (cells.size() == 2 and interior_facets)
+      {
+        std::span<const std::int32_t> dofs0 = dofmap->cell_dofs(cells[0]);
+        std::span<const std::int32_t> dofs1 = dofmap->cell_dofs(cells[1]);
+        macro_dofs.assign(dofs0.begin(), dofs0.end());
+        macro_dofs.insert(macro_dofs.end(), dofs1.begin(), dofs1.end());
+        insert_upper(macro_dofs, macro_dofs);
+      }
+      else if (cells.size() == 1 and exterior_facets)
+      {
+        std::span<const std::int32_t> dofs = dofmap->cell_dofs(cells[0]);
+        insert_upper(dofs, dofs);
+      }
+    }
+  }
+
+  // Couple the masters of each cell with the cell dofs and each other
+  const std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
+      cell_to_slaves = mpc->cell_to_slaves();
+  const std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
+      masters = mpc->masters();
+  std::vector<std::int32_t> master_blocks;
+  for (std::int32_t i = 0; i < cell_to_slaves->num_nodes(); ++i)
+  {
+    std::span<const std::int32_t> slaves = cell_to_slaves->links(i);
+    if (slaves.empty())
+      continue;
+
+    master_blocks.clear();
+    for (auto slave : slaves)
+      for (auto master : masters->links(slave))
+        master_blocks.push_back(master / bs);
+
+    std::span<const std::int32_t> cell_dofs = dofmap->cell_dofs(i);
+    for (std::size_t j = 0; j < master_blocks.size(); ++j)
+    {
+      std::span<const std::int32_t> master_block(master_blocks.data() + j, 1);
+      insert_upper(master_block, cell_dofs);
+      insert_upper(cell_dofs, master_block);
+    }
+    insert_upper(master_blocks, master_blocks);
+  }
+
+  return pattern;
+}
+//-----------------------------------------------------------------------------
+dolfinx::la::petsc::Matrix dolfinx_mpc::create_symmetric_matrix(
+    const dolfinx::fem::Form<PetscScalar>& a,
+    const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc)
+{
+  dolfinx::common::Timer timer("~MPC: Create symmetric Matrix");
+
+  // Build sparsity pattern of the upper triangular part
+  dolfinx::la::SparsityPattern pattern
+      = create_symmetric_sparsity_pattern(a, mpc);
+  dolfinx::common::Timer timer_s("~MPC: Assemble sparsity pattern");
+  pattern.assemble();
+  timer_s.stop();
+
+  std::shared_ptr<const dolfinx::common::IndexMap> map = pattern.index_map(0);
+  const int bs = pattern.block_size(0);
+  const std::int32_t size_local = map->size_local();
+
+  Mat A;
+  MatCreate(a.mesh()->comm(), &A);
+  MatSetSizes(A, bs * size_local, bs * size_local, PETSC_DETERMINE,
+              PETSC_DETERMINE);
+  MatSetType(A, MATSBAIJ);
+
+  // The pattern only holds the upper triangular part, which is what SBAIJ
+  // preallocates for
+  std::vector<PetscInt> nnz_diag(size_local);
+  std::vector<PetscInt> nnz_offdiag(size_local);
+  for (std::int32_t i = 0; i < size_local; ++i)
+  {
+    nnz_diag[i] = pattern.nnz_diag(i);
+    nnz_offdiag[i] = pattern.nnz_off_diag(i);
+  }
+  MatXAIJSetPreallocation(A, bs, nnz_diag.data(), nnz_offdiag.data(),
+                          nnz_diag.data(), nnz_offdiag.data());
+
+  // Local-to-global map for insertion with indices local to process
+  const std::vector<std::int64_t> global_indices = map->global_indices();
+  std::vector<PetscInt> _global_indices(global_indices.begin(),
+                                        global_indices.end());
+  ISLocalToGlobalMapping local_to_global;
+  ISLocalToGlobalMappingCreate(MPI_COMM_SELF, bs, _global_indices.size(),
+                               _global_indices.data(), PETSC_COPY_VALUES,
+                               &local_to_global);
+  MatSetLocalToGlobalMapping(A, local_to_global, local_to_global);
+  ISLocalToGlobalMappingDestroy(&local_to_global);
+
+  MatSetOption(A, MAT_KEEP_NONZERO_PATTERN, PETSC_TRUE);
+  MatSetOption(A, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_TRUE);
+  MatSetOption(A, MAT_IGNORE_LOWER_TRIANGULAR, PETSC_TRUE);
+  MatSetOption(A, MAT_SYMMETRIC, PETSC_TRUE);
+  MatSetOption(A, MAT_SYMMETRY_ETERNAL, PETSC_TRUE);
+
+  return dolfinx::la::petsc::Matrix(A, false);
+}
+//-----------------------------------------------------------------------------
+dolfinx::la::petsc::Matrix dolfinx_mpc::create_unassembled_matrix(
+    const dolfinx::fem::Form<PetscScalar>& a,
+    const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc)
+{
+  dolfinx::common::Timer timer("~MPC: Create unassembled matrix");
+  if (a.rank() != 2)
+  {
+    throw std::runtime_error(
+        "Cannot create matrix. Form is not a bilinear form");
+  }
+  if (*a.function_spaces()[0] != *a.function_spaces()[1])
+  {
+    throw std::runtime_error("Cannot create unassembled matrix. Test and "
+                             "trial spaces are not the same.");
+  }
+
+  std::shared_ptr<const dolfinx::fem::DofMap> dofmap
+      = mpc->function_space()->dofmap();
+  std::shared_ptr<const dolfinx::common::IndexMap> map = dofmap->index_map;
+  const int bs = dofmap->index_map_bs();
+  const std::int32_t size_local = map->size_local();
+  const std::int32_t num_blocks = size_local + map->num_ghosts();
+
+  // Cells assembled on this process
+  std::vector<std::int32_t> cells;
+  for (int i : a.integral_ids(dolfinx::fem::IntegralType::cell))
+  {
+    const std::vector<std::int32_t>& active_cells = a.cell_domains(i);
+    cells.insert(cells.end(), active_cells.begin(), active_cells.end());
+  }
+  for (int i : a.integral_ids(dolfinx::fem::IntegralType::exterior_facet))
+  {
+    const std::vector<std::int32_t>& facets = a.exterior_facet_domains(i);
+    for (std::size_t j = 0; j < facets.size(); j += 2)
+      cells.push_back(facets[j]);
+  }
+  dolfinx::radix_sort(std::span<std::int32_t>(cells));
+  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+  // Pattern of the subdomain matrix (in blocks local to process). The
+  // diagonal is always included, for slave and Dirichlet rows
+  std::vector<std::vector<std::int32_t>> pattern(num_blocks);
+  for (std::int32_t i = 0; i < num_blocks; ++i)
+    pattern[i].push_back(i);
+  const std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
+      cell_to_slaves = mpc->cell_to_slaves();
+  const std::shared_ptr<const dolfinx::graph::AdjacencyList<std::int32_t>>
+      masters = mpc->masters();
+
+  // Couple the dofs of an element (a cell, or the two cells of an interior
+  // facet) with each other, and with the masters of the slaves in its cells
+  std::vector<std::int32_t> master_blocks;
+  auto insert_element
+      = [&pattern, &master_blocks, &cell_to_slaves, &masters,
+         bs](std::span<const std::int32_t> dofs,
+             std::span<const std::int32_t> element_cells)
+  {
+    for (auto row : dofs)
+      pattern[row].insert(pattern[row].end(), dofs.begin(), dofs.end());
+
+    master_blocks.clear();
+    for (auto cell : element_cells)
+      for (auto slave : cell_to_slaves->links(cell))
+        for (auto master : masters->links(slave))
+          master_blocks.push_back(master / bs);
+    for (auto master : master_blocks)
+    {
+      pattern[master].insert(pattern[master].end(), dofs.begin(), dofs.end());
+      pattern[master].insert(pattern[master].end(), master_blocks.begin(),
+                             master_blocks.end());
+      for (auto row : dofs)
+        pattern[row].push_back(master);
+    }
+  };
+  for (auto cell : cells)
+    insert_element(dofmap->cell_dofs(cell), std::span(&cell, 1));
+
+  // Interior facets couple the dofs of the two adjacent cells
+  std::vector<std::int32_t> macro_dofs;
+  for (int i : a.integral_ids(dolfinx::fem::IntegralType::interior_facet))
+  {
+    const std::vector<std::int32_t>& facets = a.interior_facet_domains(i);
+    for (std::size_t j = 0; j < facets.size(); j += 4)
+    {
+      const std::array<std::int32_t, 2> facet_cells
+          = {facets[j], facets[j + 2]};
+      std::span<const std::int32_t> dofs0 = dofmap->cell_dofs(facet_cells[0]);
+      std::span<const std::int32_t> dofs1 = dofmap->cell_dofs(facet_cells[1]);
+      macro_dofs.assign(dofs0.begin(), dofs0.end());
+      macro_dofs.insert(macro_dofs.end(), dofs1.begin(), dofs1.end());
+      insert_element(macro_dofs, facet_cells);
+    }
+  }
+
+  std::vector<PetscInt> nnz(num_blocks);
+  for (std::int32_t i = 0; i < num_blocks; ++i)
+  {
+    dolfinx::radix_sort(std::span<std::int32_t>(pattern[i]));
+    nnz[i] = std::distance(
+        pattern[i].begin(), std::unique(pattern[i].begin(), pattern[i].end()));
+  }
+
+  // Local-to-global map of the subdomain
+  const std::vector<std::int64_t> global_indices = map->global_indices();
+  std::vector<PetscInt> _global_indices(global_indices.begin(),
+                                        global_indices.end());
+  ISLocalToGlobalMapping local_to_global;
+  ISLocalToGlobalMappingCreate(MPI_COMM_SELF, bs, _global_indices.size(),
+                               _global_indices.data(), PETSC_COPY_VALUES,
+                               &local_to_global);
+  Mat A;
+  MatCreateIS(a.mesh()->comm(), bs, bs * size_local, bs * size_local,
+              PETSC_DETERMINE, PETSC_DETERMINE, local_to_global,
+              local_to_global, &A);
+  ISLocalToGlobalMappingDestroy(&local_to_global);
+
+  // Preallocate the subdomain matrix
+  Mat A_local;
+  MatISGetLocalMat(A, &A_local);
+  MatXAIJSetPreallocation(A_local, bs, nnz.data(), nullptr, nullptr, nullptr);
+  MatSetOption(A_local, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_TRUE);
+  MatISRestoreLocalMat(A, &A_local);
+
+  return dolfinx::la::petsc::Matrix(A, false);
+}
+//-----------------------------------------------------------------------------
 xt::xtensor<double, 3> dolfinx_mpc::evaluate_basis_functions(
     const dolfinx::fem::FunctionSpace& V, const xt::xtensor<double, 2>& x,
     const std::span<const std::int32_t>& cells)
@@ -862,6 +1547,106 @@ xt::xtensor<double, 3> dolfinx_mpc::evaluate_basis_functions(
   return basis_derivatives_reference_values_b;
 }
 
+//-----------------------------------------------------------------------------
+xt::xtensor<double, 3> dolfinx_mpc::evaluate_vertex_basis_functions(
+    const dolfinx::fem::FunctionSpace& V, const xt::xtensor<double, 2>& x,
+    const std::span<const std::int32_t>& cells)
+{
+  if (x.shape(0) != cells.size())
+  {
+    throw std::runtime_error(
+        "Number of points and number of cells must be equal.");
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = V.mesh();
+  assert(mesh);
+  const int tdim = mesh->topology().dim();
+  const mesh::CellType cell_type = mesh->topology().cell_type();
+  if (!mesh::is_simplex(cell_type))
+  {
+    throw std::runtime_error(
+        "Vertex interpolation is only supported on simplex meshes.");
+  }
+
+  std::shared_ptr<const dolfinx::fem::FiniteElement> element = V.element();
+  assert(element);
+  const int bs_element = element->block_size();
+  const std::size_t value_size = element->value_size() / bs_element;
+  const std::size_t space_dimension = element->space_dimension() / bs_element;
+  if (value_size != 1
+      or element->basix_element().family() != basix::element::family::P)
+  {
+    throw std::runtime_error("Vertex interpolation is only supported for "
+                             "(blocked) scalar Lagrange spaces.");
+  }
+
+  // Find the local dof associated with each vertex of the reference cell
+  const int num_vertices = tdim + 1;
+  const dolfinx::fem::ElementDofLayout& layout
+      = V.dofmap()->element_dof_layout();
+  std::vector<std::int32_t> vertex_dofs(num_vertices);
+  for (int v = 0; v < num_vertices; ++v)
+  {
+    const std::vector<int>& dofs = layout.entity_dofs(0, v);
+    if (dofs.size() != 1)
+    {
+      throw std::runtime_error(
+          "Vertex interpolation requires exactly one dof per vertex.");
+    }
+    vertex_dofs[v] = dofs.front();
+  }
+
+  xt::xtensor<double, 3> basis_values
+      = xt::zeros<double>({x.shape(0), space_dimension, value_size});
+
+  // Get geometry data. The first tdim + 1 nodes of a cell are its vertices,
+  // ordered as the vertices of the reference cell.
+  const graph::AdjacencyList<std::int32_t>& x_dofmap
+      = mesh->geometry().dofmap();
+  std::span<const double> x_g = mesh->geometry().x();
+  std::vector<double> coordinate_dofs(3 * num_vertices);
+  std::array<double, 18> work;
+  std::array<double, 3> lambda;
+  std::array<double, 3> point;
+  std::size_t num_points = 0;
+  for (std::size_t p = 0; p < cells.size(); ++p)
+  {
+    // Skip negative cell indices
+    if (cells[p] < 0)
+      continue;
+    ++num_points;
+
+    auto x_dofs = x_dofmap.links(cells[p]);
+    for (int v = 0; v < num_vertices; ++v)
+    {
+      std::copy_n(std::next(x_g.begin(), 3 * x_dofs[v]), 3,
+                  std::next(coordinate_dofs.begin(), 3 * v));
+    }
+    for (std::size_t i = 0; i < 3; ++i)
+      point[i] = i < x.shape(1) ? x(p, i) : 0;
+    if (!compute_barycentric_coordinates(coordinate_dofs, tdim, point, work,
+                                         lambda))
+    {
+      throw std::runtime_error("Degenerate cell in vertex interpolation.");
+    }
+    double lambda_0 = 1;
+    for (int k = 0; k < tdim; ++k)
+    {
+      basis_values(p, vertex_dofs[k + 1], 0) = lambda[k];
+      lambda_0 -= lambda[k];
+    }
+    basis_values(p, vertex_dofs[0], 0) = lambda_0;
+  }
+
+  if (num_points > 0)
+  {
+    LOG(INFO) << "Vertex interpolation: " << num_points * num_vertices
+              << " of " << num_points * space_dimension
+              << " basis values used (fill reduced by a factor "
+              << double(space_dimension) / num_vertices << ")";
+  }
+  return basis_values;
+}
 //-----------------------------------------------------------------------------
 xt::xtensor<double, 2>
 dolfinx_mpc::tabulate_dof_coordinates(const dolfinx::fem::FunctionSpace& V,
@@ -995,7 +1780,19 @@ dolfinx_mpc::compute_colliding_cells(
   offsets.reserve(candidate_cells.num_nodes() + 1);
   std::vector<std::int32_t> colliding_cells;
   const int tdim = mesh.topology().dim();
-  std::vector<std::int32_t> result;
+
+  // Use barycentric coordinates for affine simplices
+  const bool affine_simplex
+      = mesh.geometry().cmap().is_affine()
+        and dolfinx::mesh::is_simplex(mesh.topology().cell_type());
+  const dolfinx::graph::AdjacencyList<std::int32_t>& x_dofmap
+      = mesh.geometry().dofmap();
+  std::span<const double> x_g = mesh.geometry().x();
+  std::array<double, 12> coordinate_dofs;
+  std::array<double, 18> work;
+
+  // Buffer for the fallback GJK distance computation
+  xt::xtensor<double, 2> _point({0, 3});
   for (std::int32_t i = 0; i < candidate_cells.num_nodes(); i++)
   {
     auto cells = candidate_cells.links(i);
@@ -1004,7 +1801,34 @@ dolfinx_mpc::compute_colliding_cells(
       offsets.push_back((std::int32_t)colliding_cells.size());
       continue;
     }
-    xt::xtensor<double, 2> _point({cells.size(), 3});
+
+    // Return the first cell within the tolerance
+    if (affine_simplex)
+    {
+      std::span<const double, 3> point(points.data() + 3 * i, 3);
+      auto it = std::find_if(
+          cells.begin(), cells.end(),
+          [&](auto cell)
+          {
+            auto x_dofs = x_dofmap.links(cell);
+            for (int j = 0; j < tdim + 1; ++j)
+              std::copy_n(std::next(x_g.begin(), 3 * x_dofs[j]), 3,
+                          std::next(coordinate_dofs.begin(), 3 * j));
+            const double d2 = simplex_squared_distance_bound(
+                coordinate_dofs, tdim, point, work);
+            return d2 >= 0 and d2 < eps2;
+          });
+      if (it != cells.end())
+      {
+        colliding_cells.push_back(*it);
+        offsets.push_back((std::int32_t)colliding_cells.size());
+        continue;
+      }
+    }
+
+    // Compute exact distance to all candidates with GJK
+    if (_point.shape(0) != cells.size())
+      _point.resize({cells.size(), 3});
     for (std::size_t j = 0; j < cells.size(); j++)
       xt::row(_point, j) = xt::row(points, i);
 
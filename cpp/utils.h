@@ -42,6 +42,21 @@ struct mpc_data
   std::vector<std::int32_t> owners;
 };
 
+/// Predicted size of the sparsity pattern of a bilinear form with multi
+/// point constraints, see estimate_sparsity
+struct sparsity_estimate
+{
+  /// Predicted number of nonzero blocks in each owned block row
+  std::vector<std::int32_t> row_nonzeros;
+  /// Number of nonzero blocks in the owned rows without the constraints
+  std::int64_t standard_nonzeros;
+  /// Number of nonzero blocks in the owned rows added by the constraints
+  std::int64_t master_nonzeros;
+  /// Number of ghost block rows receiving entries, which are sent to the
+  /// owning process
+  std::int32_t num_off_process_rows;
+};
+
 template <typename T>
 class MultiPointConstraint;
 
@@ -86,6 +101,17 @@ MPI_Comm create_owner_to_ghost_comm(
     std::vector<std::int32_t>& ghost_blocks,
     std::shared_ptr<const dolfinx::common::IndexMap> index_map);
 
+/// Map each (owned) slave to the processes ghosting it, given by their index
+/// in the destination ranks of the index map, i.e. the neighbourhood of
+/// the communicator from `create_owner_to_ghost_comm(imap)`
+/// @param[in] slaves List of local slave indices (unrolled)
+/// @param[in] imap The index map
+/// @param[in] bs The index map block size
+/// @returns The neighbourhood indices of the ghosting processes of each slave
+dolfinx::graph::AdjacencyList<std::int32_t>
+compute_slave_to_neighbor(std::span<const std::int32_t> slaves,
+                          const dolfinx::common::IndexMap& imap, int bs);
+
 /// Creates a normal approximation for the dofs in the closure of the attached
 /// facets, where the normal is an average if a dof belongs to multiple facets
 dolfinx::fem::Function<PetscScalar>
@@ -158,6 +184,59 @@ dolfinx::la::SparsityPattern create_sparsity_pattern(
     const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc0,
     const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc1);
 
+/// Predict the number of nonzeros in the sparsity pattern of a bilinear form
+/// with multi point constraints, without creating the pattern. The cell
+/// couplings are counted row by row with a single marker array, and the
+/// couplings added by the constraints are found from the cells containing
+/// slaves only. Interior facet integrals couple the dofs of the two cells of
+/// each interior facet, and forms with exterior facet integrals are counted
+/// as if every cell had an exterior facet. Rows shared between processes are
+/// summed over the processes, so the prediction is an upper bound for these
+/// rows.
+/// @param[in] a bi-linear form for the current variational problem
+/// @param[in] mpc0 The multi point constraint to apply to the rows of the
+/// matrix.
+/// @param[in] mpc1 The multi point constraint to apply to the columns of the
+/// matrix.
+/// @returns The predicted number of nonzero blocks
+sparsity_estimate estimate_sparsity(
+    const dolfinx::fem::Form<PetscScalar>& a,
+    const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc0,
+    const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc1);
+
+/// Create the upper triangular part (in the global numbering of the blocks)
+/// of the sparsity pattern with multi point constraint additions, for a
+/// symmetric bilinear form where the same constraint is applied to the rows
+/// and the columns
+/// @param[in] a bi-linear form for the current variational problem
+/// @param[in] mpc The multi point constraint
+dolfinx::la::SparsityPattern create_symmetric_sparsity_pattern(
+    const dolfinx::fem::Form<PetscScalar>& a,
+    const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc);
+
+/// Create a symmetric block matrix (MATSBAIJ) storing the upper triangular
+/// part of K^T A K, for a symmetric bilinear form where the same constraint
+/// is applied to the rows and the columns. Values inserted in the lower
+/// triangular part are ignored.
+/// @param[in] a bi-linear form for the current variational problem
+/// @param[in] mpc The multi point constraint
+dolfinx::la::petsc::Matrix create_symmetric_matrix(
+    const dolfinx::fem::Form<PetscScalar>& a,
+    const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc);
+
+/// Create an unassembled PETSc matrix (MATIS) for the constrained system,
+/// where each process holds the matrix of its own subdomain (the cells it
+/// assembles, and the cell pairs of its interior facets). The
+/// local-to-global map is the index map of the constraint, which
+/// includes the masters of all slaves in the subdomain as ghosts, such that
+/// slave contributions are added to the master rows and columns of the
+/// subdomain matrix. Intended for BDDC and FETI-DP preconditioners.
+/// @param[in] a bi-linear form for the current variational problem
+/// @param[in] mpc The multi point constraint applied to the rows and columns
+dolfinx::la::petsc::Matrix create_unassembled_matrix(
+    const dolfinx::fem::Form<PetscScalar>& a,
+    const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>> mpc);
+
 /// Compute the dot product u . vs
 /// @param u The first vector. It must has size 3.
 /// @param v The second vector. It must has size 3.
@@ -348,6 +427,7 @@ void append_master_data(recv_data<T> in_data,
 }
 
 /// Distribute local slave->master data from owning process to ghost processes
+/// over an existing owner->ghost communicator
 /// @param[in] slaves List of local slaves indices (local to process, unrolled)
 /// @param[in] masters The corresponding master dofs (global indices, unrolled)
 /// @param[in] coeffs The master coefficients
@@ -355,6 +435,10 @@ void append_master_data(recv_data<T> in_data,
 /// @param[in] num_masters_per_slave The number of masters owned by each slave
 /// @param[in] imap The index map
 /// @param[in] bs The index map block size
+/// @param[in] local_to_ghost The communicator from
+/// `create_owner_to_ghost_comm(*imap)`
+/// @param[in] slave_to_neighbor The neighbourhood indices of the processes
+/// ghosting each slave, see `compute_slave_to_neighbor`
 /// @returns Data structure holding the received slave->master data
 template <typename T>
 dolfinx_mpc::mpc_data distribute_ghost_data(
@@ -362,63 +446,27 @@ dolfinx_mpc::mpc_data distribute_ghost_data(
     const std::vector<std::int64_t>& masters, const std::vector<T>& coeffs,
     const std::vector<std::int32_t>& owners,
     const std::vector<std::int32_t>& num_masters_per_slave,
-    std::shared_ptr<const dolfinx::common::IndexMap> imap, const int bs)
+    std::shared_ptr<const dolfinx::common::IndexMap> imap, const int bs,
+    MPI_Comm local_to_ghost,
+    const dolfinx::graph::AdjacencyList<std::int32_t>& slave_to_neighbor)
 {
-  std::shared_ptr<const dolfinx::common::IndexMap> slave_to_ghost;
-  std::vector<int> parent_to_sub;
-  parent_to_sub.reserve(slaves.size());
-  std::vector<std::int32_t> slave_blocks;
-  slave_blocks.reserve(slaves.size());
-  std::vector<std::int32_t> slave_rems;
-  slave_rems.reserve(slaves.size());
-
-  // Create new index map for each slave block
-  {
-    std::vector<std::int32_t> blocks;
-    blocks.reserve(slaves.size());
-    std::transform(slaves.cbegin(), slaves.cend(), std::back_inserter(blocks),
-                   [bs](auto& dof) { return dof / bs; });
-    std::sort(blocks.begin(), blocks.end());
-    blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
-
-    std::pair<dolfinx::common::IndexMap, std::vector<int32_t>> compressed_map
-        = imap->create_submap(blocks);
-    slave_to_ghost = std::make_shared<const dolfinx::common::IndexMap>(
-        std::move(compressed_map.first));
-
-    // Build map from new index map to slave indices (unrolled)
-    for (std::size_t i = 0; i < slaves.size(); i++)
-    {
-      std::div_t div = std::div(slaves[i], bs);
-      slave_blocks[i] = div.quot;
-      slave_rems[i] = div.rem;
-      auto it = std::find(blocks.begin(), blocks.end(), div.quot);
-      assert(it != blocks.end());
-      auto index = std::distance(blocks.begin(), it);
-      parent_to_sub.push_back((int)index);
-    }
-  }
-
-  // Get communicator for owner->ghost
-  MPI_Comm local_to_ghost = create_owner_to_ghost_comm(*slave_to_ghost);
-  const std::vector<std::int32_t>& src_ranks_ghosts = slave_to_ghost->src();
-  const std::vector<std::int32_t>& dest_ranks_ghosts = slave_to_ghost->dest();
+  assert(slave_to_neighbor.num_nodes() == (std::int32_t)slaves.size());
+  const std::vector<std::int32_t>& slave_to_neighbor_offsets
+      = slave_to_neighbor.offsets();
+  const std::vector<std::int32_t>& src_ranks_ghosts = imap->src();
+  const std::vector<std::int32_t>& dest_ranks_ghosts = imap->dest();
 
   // Compute number of outgoing slaves and masters for each process
-  dolfinx::graph::AdjacencyList<int> shared_indices
-      = slave_to_ghost->index_to_dest_ranks();
   const std::size_t num_inc_proc = src_ranks_ghosts.size();
   const std::size_t num_out_proc = dest_ranks_ghosts.size();
   std::vector<std::int32_t> out_num_slaves(num_out_proc + 1, 0);
   std::vector<std::int32_t> out_num_masters(num_out_proc + 1, 0);
   for (std::size_t i = 0; i < slaves.size(); ++i)
   {
-    for (auto proc : shared_indices.links(parent_to_sub[i]))
+    for (std::int32_t j = slave_to_neighbor_offsets[i];
+         j < slave_to_neighbor_offsets[i + 1]; ++j)
     {
-      // Find index of process in local MPI communicator
-      auto it
-          = std::find(dest_ranks_ghosts.begin(), dest_ranks_ghosts.end(), proc);
-      const auto index = std::distance(dest_ranks_ghosts.begin(), it);
+      const std::int32_t index = slave_to_neighbor.array()[j];
       out_num_masters[index] += num_masters_per_slave[i];
       out_num_slaves[index]++;
     }
@@ -468,12 +516,10 @@ dolfinx_mpc::mpc_data distribute_ghost_data(
     // Find ghost processes for the ith local slave
     const std::int32_t master_start = local_offsets[i];
     const std::int32_t master_end = local_offsets[i + 1];
-    for (auto proc : shared_indices.links(parent_to_sub[i]))
+    for (std::int32_t j = slave_to_neighbor_offsets[i];
+         j < slave_to_neighbor_offsets[i + 1]; ++j)
     {
-      // Find index of process in local MPI communicator
-      auto it
-          = std::find(dest_ranks_ghosts.begin(), dest_ranks_ghosts.end(), proc);
-      const auto index = std::distance(dest_ranks_ghosts.begin(), it);
+      const std::int32_t index = slave_to_neighbor.array()[j];
 
       // Insert slave and num masters per slave
       slaves_out_loc[disp_out_slaves[index] + insert_slaves[index]] = slaves[i];
@@ -601,6 +647,35 @@ dolfinx_mpc::mpc_data distribute_ghost_data(
   return ghost_data;
 }
 
+/// Distribute local slave->master data from owning process to ghost processes
+/// @param[in] slaves List of local slaves indices (local to process, unrolled)
+/// @param[in] masters The corresponding master dofs (global indices, unrolled)
+/// @param[in] coeffs The master coefficients
+/// @param[in] owners The owners of the corresponding master dof
+/// @param[in] num_masters_per_slave The number of masters owned by each slave
+/// @param[in] imap The index map
+/// @param[in] bs The index map block size
+/// @returns Data structure holding the received slave->master data
+template <typename T>
+dolfinx_mpc::mpc_data distribute_ghost_data(
+    const std::vector<std::int32_t>& slaves,
+    const std::vector<std::int64_t>& masters, const std::vector<T>& coeffs,
+    const std::vector<std::int32_t>& owners,
+    const std::vector<std::int32_t>& num_masters_per_slave,
+    std::shared_ptr<const dolfinx::common::IndexMap> imap, const int bs)
+{
+  // Get communicator for owner->ghost. Neighbours that do not ghost any
+  // slave receive zero slaves
+  MPI_Comm local_to_ghost = create_owner_to_ghost_comm(*imap);
+  const dolfinx::graph::AdjacencyList<std::int32_t> slave_to_neighbor
+      = compute_slave_to_neighbor(slaves, *imap, bs);
+  dolfinx_mpc::mpc_data ghost_data = distribute_ghost_data(
+      slaves, masters, coeffs, owners, num_masters_per_slave, imap, bs,
+      local_to_ghost, slave_to_neighbor);
+  MPI_Comm_free(&local_to_ghost);
+  return ghost_data;
+}
+
 //-----------------------------------------------------------------------------
 /// Get basis values (not unrolled for block size) for a set of points and
 /// corresponding cells.
@@ -620,6 +695,30 @@ evaluate_basis_functions(const dolfinx::fem::FunctionSpace& V,
                          const xt::xtensor<double, 2>& x,
                          const std::span<const std::int32_t>& cells);
 
+//-----------------------------------------------------------------------------
+/// Get low-fill basis values (not unrolled for block size) for a set of
+/// points and corresponding cells, where only the degrees of freedom
+/// associated with the vertices of each cell are used. The value at a vertex
+/// dof is the barycentric coordinate of the point with respect to the
+/// corresponding vertex of the (straight-sided) cell, while all edge, facet
+/// and interior dofs get the value zero. For a high-order Lagrange space, this
+/// reduces the number of masters per slave from the space dimension to the
+/// number of vertices of the cell, at the cost of a first order accurate
+/// interpolation. The reduction in fill is reported at INFO log level.
+/// @param[in] V The function space. Has to be a (blocked) scalar Lagrange
+/// space on a simplex mesh
+/// @param[in] x The coordinates of the points. It has shape
+/// (num_points, 3).
+/// @param[in] cells An array of cell indices. cells[i] is the index
+/// of the cell that contains the point x(i). Negative cell indices
+/// can be passed, and the corresponding point will be ignored.
+/// @returns basis values (not unrolled for block size) for each point. shape
+/// (num_points, number_of_dofs, value_size)
+xt::xtensor<double, 3>
+evaluate_vertex_basis_functions(const dolfinx::fem::FunctionSpace& V,
+                                const xt::xtensor<double, 2>& x,
+                                const std::span<const std::int32_t>& cells);
+
 //-----------------------------------------------------------------------------
 /// Tabuilate dof coordinates (not unrolled for block size) for a set of points
 /// and corresponding cells.
@@ -634,8 +733,9 @@ tabulate_dof_coordinates(const dolfinx::fem::FunctionSpace& V,
                          std::span<const std::int32_t> cells);
 
 /// From a Mesh, find which cells collide with a set of points.
-/// @note Uses the GJK algorithm, see dolfinx::geometry::compute_distance_gjk
-/// for details
+/// @note For affine simplex cells, the first candidate within the tolerance
+/// is found using barycentric coordinates. Otherwise, uses the GJK algorithm,
+/// see dolfinx::geometry::compute_distance_gjk for details
 /// @param[in] mesh The mesh
 /// @param[in] candidate_cells List of candidate colliding cells for the
 /// ith point in `points`
@@ -643,8 +743,8 @@ tabulate_dof_coordinates(const dolfinx::fem::FunctionSpace& V,
 /// (shape=(num_points, 3))
 /// @param[in] eps2 The tolerance for the squared distance to be considered a
 /// collision
-/// @return Adjacency list where the ith node is the closest entity whose
-/// squared distance is within eps2
+/// @return Adjacency list where the ith node is an entity (the closest if
+/// found with GJK) whose squared distance is within eps2
 /// @note There may be nodes with no entries in the adjacency list
 dolfinx::graph::AdjacencyList<int> compute_colliding_cells(
     const dolfinx::mesh::Mesh& mesh,
@@ -0,0 +1,98 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+#
+# Benchmark of the matrix assembly loop with a multi point constraint. A
+# periodic Poisson or elasticity problem on the unit cube is assembled
+# repeatedly into the same matrix, with and without the constraint, such that
+# the cost of modifying the element matrices of the slave cells can be
+# measured. The time per slave cell is the difference of the two assembly
+# times divided by the number of cells with a slave dof.
+#
+# Example:
+#     mpirun -n 4 python3 bench_assembly.py --N 24 --degree 2 --repeats 10
+
+from argparse import ArgumentDefaultsHelpFormatter, ArgumentParser
+
+import numpy as np
+from dolfinx.common import Timer
+from dolfinx.fem import (FunctionSpace, VectorFunctionSpace, dirichletbc, form,
+                         locate_dofs_geometrical)
+from dolfinx.fem.petsc import assemble_matrix as assemble_matrix_dolfinx
+from dolfinx.mesh import CellType, create_unit_cube, locate_entities_boundary, meshtags
+from dolfinx_mpc import MultiPointConstraint, assemble_matrix
+from mpi4py import MPI
+from petsc4py import PETSc
+from ufl import TestFunction, TrialFunction, dx, grad, inner, sym
+
+
+def run(N: int, degree: int, vector: bool, repeats: int):
+    comm = MPI.COMM_WORLD
+    mesh = create_unit_cube(comm, N, N, N, CellType.tetrahedron)
+    fdim = mesh.topology.dim - 1
+    if vector:
+        V = VectorFunctionSpace(mesh, ("Lagrange", degree))
+        u, v = TrialFunction(V), TestFunction(V)
+        a = inner(sym(grad(u)), sym(grad(v))) * dx
+        zero = np.zeros(3, dtype=PETSc.ScalarType)
+    else:
+        V = FunctionSpace(mesh, ("Lagrange", degree))
+        u, v = TrialFunction(V), TestFunction(V)
+        a = inner(grad(u), grad(v)) * dx
+        zero = PETSc.ScalarType(0)
+    bc_dofs = locate_dofs_geometrical(V, lambda x: np.logical_or(np.isclose(x[1], 0), np.isclose(x[1], 1)))
+    bcs = [dirichletbc(zero, bc_dofs, V)]
+
+    facets = locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[0], 1))
+    mt = meshtags(mesh, fdim, np.sort(facets), np.full(len(facets), 2, dtype=np.int32))
+
+    def relation(x):
+        out_x = np.copy(x)
+        out_x[0] = 1 - x[0]
+        return out_x
+    mpc = MultiPointConstraint(V)
+    mpc.create_periodic_constraint_topological(V, mt, 2, relation, bcs)
+    mpc.finalize()
+    bilinear_form = form(a)
+
+    # Assemble once to create the matrices, then time the assembly into them
+    A_mpc = assemble_matrix(bilinear_form, mpc, bcs=bcs)
+    A_ref = assemble_matrix_dolfinx(bilinear_form, bcs=bcs)
+    A_ref.assemble()
+    t_mpc = np.zeros(repeats)
+    t_ref = np.zeros(repeats)
+    for i in range(repeats):
+        with Timer("~Assembly: MPC") as timer:
+            assemble_matrix(bilinear_form, mpc, bcs=bcs, A=A_mpc)
+            t_mpc[i] = timer.elapsed()[0]
+        A_ref.zeroEntries()
+        with Timer("~Assembly: DOLFINx") as timer:
+            assemble_matrix_dolfinx(A_ref, bilinear_form, bcs=bcs)
+            A_ref.assemble()
+            t_ref[i] = timer.elapsed()[0]
+
+    num_cells = mesh.topology.index_map(mesh.topology.dim).size_local
+    num_slave_cells = np.count_nonzero(np.diff(mpc.cell_to_slaves.offsets)[:num_cells])
+    A_mpc.destroy()
+    A_ref.destroy()
+    return (comm.allreduce(np.min(t_mpc), op=MPI.MAX), comm.allreduce(np.min(t_ref), op=MPI.MAX),
+            comm.allreduce(num_slave_cells, op=MPI.SUM), comm.allreduce(num_cells, op=MPI.SUM))
+
+
+if __name__ == "__main__":
+    parser = ArgumentParser(formatter_class=ArgumentDefaultsHelpFormatter)
+    parser.add_argument("--N", default=16, type=int, help="Number of cells in each direction of the unit cube")
+    parser.add_argument("--degree", default=2, type=int, help="Degree of Lagrange space")
+    parser.add_argument("--vector", action="store_true", help="Assemble linear elasticity instead of Poisson")
+    parser.add_argument("--repeats", default=5, type=int, help="Number of timed assemblies")
+    args = parser.parse_args()
+
+    t_mpc, t_ref, num_slave_cells, num_cells = run(args.N, args.degree, args.vector, args.repeats)
+    if MPI.COMM_WORLD.rank == 0:
+        print(f"Cells: {num_cells}, cells with slaves: {num_slave_cells}")
+        print(f"Assembly (min over {args.repeats} runs, max over processes): MPC {t_mpc:.4e}s, "
+              + f"DOLFINx {t_ref:.4e}s")
+        if num_slave_cells > 0:
+            print(f"Overhead per slave cell: {(t_mpc - t_ref) / num_slave_cells:.4e}s")
@@ -0,0 +1,113 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+#
+# Strong and weak scaling benchmark for the constraint setup and assembly of
+# multi point constraints. For each constraint type, rank count and problem
+# size, scaling_case.py is run with mpirun, and the per-phase timings are
+# collected in an efficiency table and a JSON file.
+#
+# Example (on a single workstation):
+#     python3 bench_scaling.py --ranks 1 2 4 --sizes 8 16 --mode strong weak
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+from argparse import ArgumentDefaultsHelpFormatter, ArgumentParser
+from typing import Dict, List
+
+from scaling_case import CONSTRAINTS, PHASES
+
+CASE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "scaling_case.py")
+
+
+def run_case(mpirun: List[str], num_processes: int, constraint: str, N: int, degree: int,
+             num_general: int) -> Dict:
+    """Run a single case with mpirun and return its timings"""
+    with tempfile.TemporaryDirectory() as tmpdir:
+        out = os.path.join(tmpdir, "case.json")
+        command = mpirun + ["-n", str(num_processes), sys.executable, CASE, "--constraint", constraint,
+                            "--N", str(N), "--degree", str(degree), "--num-general", str(num_general),
+                            "--out", out]
+        print(" ".join(command), flush=True)
+        subprocess.run(command, check=True)
+        with open(out, "r") as f:
+            return json.load(f)
+
+
+def efficiencies(series: List[Dict], mode: str) -> None:
+    """Add the parallel efficiency of each phase (relative to the run with the fewest processes) to a series of
+    results. The strong scaling efficiency is T_0 P_0 / (T P), the weak scaling efficiency T_0 / T"""
+    reference = series[0]
+    P_0 = reference["num_processes"]
+    for result in series:
+        P = result["num_processes"]
+        result["efficiency"] = {}
+        for phase, t in result["timings"].items():
+            if phase not in reference["timings"] or t["max"] == 0:
+                continue
+            t_0 = reference["timings"][phase]["max"]
+            result["efficiency"][phase] = t_0 * P_0 / (t["max"] * P) if mode == "strong" else t_0 / t["max"]
+
+
+def print_table(title: str, series: List[Dict]) -> None:
+    """Print the max time (over processes) and the efficiency of each phase"""
+    names = [phase.split(": ")[1] for phase in PHASES]
+    print(f"\n{title}")
+    header = f"{'ranks':>6} {'dofs':>10} {'slaves':>8} " + " ".join(f"{name:>24}" for name in names)
+    print(header)
+    print("-" * len(header))
+    for result in series:
+        row = f"{result['num_processes']:>6d} {result['num_dofs']:>10d} {result['num_slaves']:>8d} "
+        entries = []
+        for phase in PHASES:
+            if phase in result["timings"]:
+                time = result["timings"][phase]["max"]
+                eff = result["efficiency"].get(phase, float("nan"))
+                entries.append(f"{time:>12.3e}s ({100 * eff:5.1f}%)")
+            else:
+                entries.append(f"{'-':>24}")
+        print(row + " ".join(entries))
+
+
+if __name__ == "__main__":
+    parser = ArgumentParser(formatter_class=ArgumentDefaultsHelpFormatter)
+    parser.add_argument("--ranks", nargs="+", default=[1, 2, 4], type=int, help="Numbers of MPI processes")
+    parser.add_argument("--sizes", nargs="+", default=[8, 16], type=int,
+                        help="Number of cells in each direction of the unit cube. For weak scaling, this is the "
+                        "size for the smallest number of processes")
+    parser.add_argument("--constraints", nargs="+", default=list(CONSTRAINTS), choices=CONSTRAINTS,
+                        help="Constraint types")
+    parser.add_argument("--mode", nargs="+", default=["strong"], choices=["strong", "weak"], help="Scaling modes")
+    parser.add_argument("--degree", default=1, type=int, help="Degree of Lagrange space")
+    parser.add_argument("--num-general", default=16, type=int, dest="num_general",
+                        help="Number of slaves for the general (dictionary) constraint")
+    parser.add_argument("--mpirun", default="mpirun", type=str,
+                        help="MPI launcher, including extra arguments (e.g. 'mpirun --oversubscribe')")
+    parser.add_argument("--out", default="scaling.json", type=str, help="JSON output file")
+    args = parser.parse_args()
+
+    mpirun = args.mpirun.split()
+    ranks = sorted(args.ranks)
+    results = []
+    for mode in args.mode:
+        for constraint in args.constraints:
+            for size in args.sizes:
+                series = []
+                for P in ranks:
+                    # Keep the number of cells per process fixed for weak scaling
+                    N = size if mode == "strong" else int(round(size * (P / ranks[0])**(1 / 3)))
+                    series.append(run_case(mpirun, P, constraint, N, args.degree, args.num_general))
+                efficiencies(series, mode)
+                title = f"{mode.capitalize()} scaling: {constraint}, N={size}, degree={args.degree}"
+                print_table(title, series)
+                results.append({"mode": mode, "constraint": constraint, "size": size, "degree": args.degree,
+                                "runs": series})
+
+    with open(args.out, "w") as f:
+        json.dump({"ranks": ranks, "results": results}, f, indent=2)
+    print(f"\nResults written to {args.out}")
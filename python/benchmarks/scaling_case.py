@@ -0,0 +1,186 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+#
+# A single run of the scaling benchmark (see bench_scaling.py). Sets up a
+# synthetic workload on the unit cube for a given constraint type, times
+# each phase with DOLFINx timers and writes the timings (max and mean over
+# all processes) to a JSON file.
+
+import json
+from argparse import ArgumentDefaultsHelpFormatter, ArgumentParser
+
+import numpy as np
+from dolfinx.common import Timer, TimingType, list_timings, timing
+from dolfinx.cpp.mesh import entities_to_geometry
+from dolfinx.fem import (FunctionSpace, VectorFunctionSpace, dirichletbc, form,
+                         locate_dofs_geometrical, locate_dofs_topological)
+from dolfinx.mesh import (CellType, compute_midpoints, create_mesh,
+                          create_unit_cube, locate_entities_boundary, meshtags)
+from dolfinx_mpc import MultiPointConstraint, assemble_matrix, assemble_vector
+from dolfinx_mpc.utils import create_normal_approximation
+from mpi4py import MPI
+from petsc4py import PETSc
+from ufl import (Cell, Mesh, SpatialCoordinate, TestFunction, TrialFunction,
+                 VectorElement, as_vector, dx, grad, inner, sin, sym)
+
+CONSTRAINTS = ("periodic", "slip", "contact", "general")
+
+# Phases timed by the benchmark, and timers inside DOLFINx_MPC that are
+# reported if they were used
+PHASES = ("~Scaling: Create mesh", "~Scaling: Create constraint",
+          "~Scaling: Finalize constraint", "~Scaling: Assemble matrix",
+          "~Scaling: Assemble vector")
+MPC_TIMERS = ("~MPC: Create slip constraint", "~MPC: Inelastic condition",
+              "~MPC: Facet normal projection", "~MPC: Create sparsity pattern",
+              "~MPC: Create Matrix", "~MPC: Assemble matrix (C++)",
+              "~MPC: Assemble vector (C++)")
+
+
+def stacked_cubes(comm: MPI.Intracomm, N: int):
+    """Create the cubes [0,1]^3 and [0,1]^2x[1,2] with non-matching resolution
+    (N and N + 1 cells per direction) as a single (disconnected) mesh, and
+    tag the bottom (1), the lower (2) and upper (3) side of the interface"""
+    if comm.rank == 0:
+        mesh0 = create_unit_cube(MPI.COMM_SELF, N, N, N)
+        mesh1 = create_unit_cube(MPI.COMM_SELF, N + 1, N + 1, N + 1)
+        mesh1.geometry.x[:, 2] += 1
+        cells = []
+        for mesh in (mesh0, mesh1):
+            num_cells = mesh.topology.index_map(3).size_local
+            cells.append(entities_to_geometry(mesh, 3, np.arange(num_cells, dtype=np.int32), False))
+        cells[1] += mesh0.geometry.x.shape[0]
+        cells = np.vstack(cells).astype(np.int64)
+        points = np.vstack([mesh0.geometry.x, mesh1.geometry.x])
+    else:
+        cells = np.empty((0, 4), dtype=np.int64)
+        points = np.empty((0, 3), dtype=np.float64)
+    domain = Mesh(VectorElement("Lagrange", Cell("tetrahedron", geometric_dimension=3), 1))
+    mesh = create_mesh(comm, cells, points, domain)
+
+    tdim = mesh.topology.dim
+    fdim = tdim - 1
+    mesh.topology.create_connectivity(fdim, tdim)
+    facet_to_cell = mesh.topology.connectivity(fdim, tdim)
+    num_cells = mesh.topology.index_map(tdim).size_local + mesh.topology.index_map(tdim).num_ghosts
+    midpoints = compute_midpoints(mesh, tdim, np.arange(num_cells, dtype=np.int32))
+    bottom = locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[2], 0))
+    interface = locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[2], 1))
+    upper = np.array([midpoints[facet_to_cell.links(f)[0], 2] > 1 for f in interface], dtype=bool)
+    indices = np.hstack([bottom, interface])
+    values = np.hstack([np.full(len(bottom), 1, dtype=np.int32),
+                        np.where(upper, 3, 2).astype(np.int32)])
+    perm = np.argsort(indices)
+    return mesh, meshtags(mesh, fdim, indices[perm].astype(np.int32), values[perm])
+
+
+def run(constraint: str, N: int, degree: int, num_general: int):
+    comm = MPI.COMM_WORLD
+
+    with Timer(PHASES[0]):
+        if constraint == "contact":
+            mesh, mt = stacked_cubes(comm, N)
+        else:
+            mesh = create_unit_cube(comm, N, N, N, CellType.tetrahedron)
+    fdim = mesh.topology.dim - 1
+
+    if constraint in ("periodic", "general"):
+        V = FunctionSpace(mesh, ("Lagrange", degree))
+        bc_dofs = locate_dofs_geometrical(V, lambda x: np.logical_or(np.isclose(x[1], 0), np.isclose(x[1], 1)))
+        bcs = [dirichletbc(PETSc.ScalarType(0), bc_dofs, V)]
+        u, v = TrialFunction(V), TestFunction(V)
+        x = SpatialCoordinate(mesh)
+        a = inner(grad(u), grad(v)) * dx + inner(u, v) * dx
+        L = inner(sin(x[0]) * x[1], v) * dx
+    else:
+        V = VectorFunctionSpace(mesh, ("Lagrange", degree))
+        facets = mt.find(1) if constraint == "contact" else \
+            locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[2], 0))
+        bc_dofs = locate_dofs_topological(V, fdim, facets)
+        bcs = [dirichletbc(np.zeros(3, dtype=PETSc.ScalarType), bc_dofs, V)]
+        u, v = TrialFunction(V), TestFunction(V)
+        a = inner(sym(grad(u)), sym(grad(v))) * dx
+        L = inner(as_vector((0, 0, -1)), v) * dx
+
+    mpc = MultiPointConstraint(V)
+    with Timer(PHASES[1]):
+        if constraint == "periodic":
+            facets = locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[0], 1))
+            mt_p = meshtags(mesh, fdim, np.sort(facets), np.full(len(facets), 2, dtype=np.int32))
+
+            def relation(x):
+                out_x = np.copy(x)
+                out_x[0] = 1 - x[0]
+                return out_x
+            mpc.create_periodic_constraint_topological(V, mt_p, 2, relation, bcs)
+        elif constraint == "slip":
+            facets = locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[0], 0))
+            mt_s = meshtags(mesh, fdim, np.sort(facets), np.full(len(facets), 2, dtype=np.int32))
+            n = create_normal_approximation(V, mt_s, 2)
+            mpc.create_slip_constraint(V, (mt_s, 2), n, bcs=bcs)
+        elif constraint == "contact":
+            mpc.create_contact_inelastic_condition(mt, 2, 3)
+        else:
+            # Slaves on a grid of vertices on the face x=1, each tied to two
+            # vertices on the face x=0
+            def l2b(li):
+                return np.array(li, dtype=np.float64).tobytes()
+            num_points = max(int(np.sqrt(num_general)), 1)
+            grid = np.unique(np.linspace(1, N - 2, num_points).astype(np.int32)) / N
+            slave_master_dict = {l2b([1, y, z]): {l2b([0, y, z]): 0.5, l2b([0, y, z + 1 / N]): 0.5}
+                                 for y in grid for z in grid}
+            mpc.create_general_constraint(slave_master_dict)
+    with Timer(PHASES[2]):
+        mpc.finalize()
+
+    bilinear_form = form(a)
+    linear_form = form(L)
+    with Timer(PHASES[3]):
+        A = assemble_matrix(bilinear_form, mpc, bcs=bcs)
+    with Timer(PHASES[4]):
+        b = assemble_vector(linear_form, mpc)
+
+    num_dofs = V.dofmap.index_map.size_global * V.dofmap.index_map_bs
+    num_slaves = comm.allreduce(mpc.num_local_slaves, op=MPI.SUM)
+    A.destroy()
+    b.destroy()
+    return num_dofs, num_slaves
+
+
+if __name__ == "__main__":
+    parser = ArgumentParser(formatter_class=ArgumentDefaultsHelpFormatter)
+    parser.add_argument("--constraint", default="periodic", choices=CONSTRAINTS, help="Constraint type")
+    parser.add_argument("--N", default=8, type=int, help="Number of cells in each direction of the unit cube")
+    parser.add_argument("--degree", default=1, type=int, help="Degree of Lagrange space")
+    parser.add_argument("--num-general", default=16, type=int, dest="num_general",
+                        help="Number of slaves for the general (dictionary) constraint")
+    parser.add_argument("--out", default=None, type=str, help="JSON output file")
+    parser.add_argument("--timings", action="store_true", help="List DOLFINx timings")
+    args = parser.parse_args()
+
+    comm = MPI.COMM_WORLD
+    num_dofs, num_slaves = run(args.constraint, args.N, args.degree, args.num_general)
+
+    timings = {}
+    for name in PHASES + MPC_TIMERS:
+        try:
+            wall = timing(name)[1]
+        except RuntimeError:
+            # Timer not used in this run
+            continue
+        timings[name] = {"max": comm.allreduce(wall, op=MPI.MAX),
+                         "mean": comm.allreduce(wall, op=MPI.SUM) / comm.size}
+    if args.timings:
+        list_timings(comm, [TimingType.wall])
+
+    if comm.rank == 0:
+        result = {"constraint": args.constraint, "N": args.N, "degree": args.degree,
+                  "num_processes": comm.size, "num_dofs": num_dofs, "num_slaves": num_slaves,
+                  "timings": timings}
+        if args.out is None:
+            print(json.dumps(result, indent=2))
+        else:
+            with open(args.out, "w") as f:
+                json.dump(result, f, indent=2)
@@ -11,8 +11,14 @@ import dolfinx_mpc.cpp
 
 # New local assemblies
 from .assemble_matrix import assemble_matrix, create_matrix_nest, \
-    assemble_matrix_nest
+    assemble_matrix_nest, assemble_matrix_transformation, create_unassembled_matrix
 from .assemble_vector import assemble_vector, apply_lifting, \
     assemble_vector_nest, create_vector_nest
 from .multipointconstraint import MultiPointConstraint
+from .multigrid import create_transformation_matrix, create_mpc_prolongation, \
+    setup_mpc_multigrid
 from .problem import LinearProblem
+from .sliding_interface import SlidingInterface
+from .reductions import assemble_residual, inner_product, norm
+from .planner import (AssemblyPlan, ConstraintStatistics, SparsityEstimate, assemble_matrix_from_plan,
+                      compute_constraint_statistics, estimate_sparsity, plan_assembly)
@@ -8,6 +8,7 @@ from typing import Sequence, Union
 
 import dolfinx.fem as _fem
 import dolfinx.cpp as _cpp
+import numpy
 
 from dolfinx_mpc import cpp
 from petsc4py import PETSc as _PETSc
@@ -19,7 +20,8 @@ def assemble_matrix(form: _fem.FormMetaClass,
                                       Sequence[MultiPointConstraint]],
                     bcs: Sequence[_fem.DirichletBCMetaClass] = [],
                     diagval: _PETSc.ScalarType = 1,
-                    A: _PETSc.Mat = None) -> _PETSc.Mat:
+                    A: _PETSc.Mat = None, symmetric: bool = False,
+                    classification=None) -> _PETSc.Mat:
     """
     Assemble a compiled DOLFINx bilinear form into a PETSc matrix with corresponding multi point constraints
     and Dirichlet boundary conditions.
@@ -35,7 +37,16 @@ def assemble_matrix(form: _fem.FormMetaClass,
     diagval
         Value to set on the diagonal of the matrix (Default 1)
     A
-        PETSc matrix to assemble into (optional)
+        PETSc matrix to assemble into (optional). Can be an unassembled matrix (MATIS) from
+        :func:`dolfinx_mpc.create_unassembled_matrix`
+    symmetric
+        If True, the form is assumed to be symmetric and only the upper triangular part of the constrained
+        matrix is assembled into a symmetric block matrix (SBAIJ), for use with Cholesky factorizations or CG.
+        Requires a single constraint for the rows and columns.
+    classification
+        Dof classification (see :meth:`dolfinx_mpc.MultiPointConstraint.create_dof_classification`) used
+        instead of `bcs`, or a pair of classifications of the row and column dofs for rectangular forms.
+        Reusing a classification avoids marking the Dirichlet dofs in every assembly.
 
     Returns
     -------
@@ -45,27 +56,120 @@ def assemble_matrix(form: _fem.FormMetaClass,
     if not isinstance(constraint, Sequence):
         assert form.function_spaces[0] == form.function_spaces[1]
         constraint = (constraint, constraint)
+    if symmetric and constraint[0] is not constraint[1]:
+        raise ValueError("Symmetric assembly requires the same constraint for rows and columns")
 
     # Generate matrix with MPC sparsity pattern
     if A is None:
-        A = cpp.mpc.create_matrix(form, constraint[0]._cpp_object,
-                                  constraint[1]._cpp_object)
+        if symmetric:
+            A = cpp.mpc.create_symmetric_matrix(form, constraint[0]._cpp_object)
+        else:
+            A = cpp.mpc.create_matrix(form, constraint[0]._cpp_object,
+                                      constraint[1]._cpp_object)
     A.zeroEntries()
 
     # Assemble matrix in C++
-    cpp.mpc.assemble_matrix(A, form, constraint[0]._cpp_object,
-                            constraint[1]._cpp_object, bcs, diagval)
+    if classification is None:
+        cpp.mpc.assemble_matrix(A, form, constraint[0]._cpp_object,
+                                constraint[1]._cpp_object, bcs, diagval, symmetric)
+    else:
+        if not isinstance(classification, Sequence):
+            classification = (classification, classification)
+        cpp.mpc.assemble_matrix(A, form, classification[0], classification[1], diagval, symmetric)
 
     # Add one on diagonal for Dirichlet boundary conditions
     if form.function_spaces[0] is form.function_spaces[1]:
         A.assemblyBegin(_PETSc.Mat.AssemblyType.FLUSH)
         A.assemblyEnd(_PETSc.Mat.AssemblyType.FLUSH)
-        _cpp.fem.petsc.insert_diagonal(A, form.function_spaces[0], bcs, diagval)
+        if classification is None:
+            _cpp.fem.petsc.insert_diagonal(A, form.function_spaces[0], bcs, diagval)
+        else:
+            cpp.mpc.insert_diagonal(A, classification[0], diagval)
 
     A.assemble()
     return A
 
 
+def assemble_matrix_transformation(form: _fem.FormMetaClass, constraint: MultiPointConstraint,
+                                   bcs: Sequence[_fem.DirichletBCMetaClass] = [],
+                                   diagval: _PETSc.ScalarType = 1) -> _PETSc.Mat:
+    """
+    Assemble a compiled DOLFINx bilinear form with a multi point constraint as the explicit product
+    K^T A K, where A is the matrix assembled without the constraint and K is the transformation matrix of
+    the constraint (see `dolfinx_mpc.create_transformation_matrix`). The resulting matrix is equal to
+    the one from `assemble_matrix`, but the work is moved from the element kernels to a single sparse
+    matrix triple product, which can be faster for constraints affecting most of the cells.
+
+    Parameters
+    ----------
+    form
+        The compiled bilinear variational form
+    constraint
+        The multi point constraint
+    bcs
+        Sequence of Dirichlet boundary conditions
+    diagval
+        Value to set on the diagonal of the matrix for slaves and Dirichlet dofs (Default 1)
+
+    Returns
+    -------
+    _PETSc.Mat
+        The assembled bi-linear form
+    """
+    assert form.function_spaces[0] == form.function_spaces[1]
+    # Assemble without Dirichlet conditions, as a Dirichlet dof can be a master, where the slave
+    # contributions have to be added before the row and column are zeroed
+    A = _fem.petsc.assemble_matrix(form)
+    A.assemble()
+    K = cpp.mpc.create_transformation_matrix(constraint._cpp_object)
+    A_mpc = A.PtAP(K)
+    A.destroy()
+    K.destroy()
+
+    # Rows and columns of slaves are zero in K^T A K. Add the diagonal value
+    A_mpc.setOption(_PETSc.Mat.Option.NEW_NONZERO_ALLOCATION_ERR, False)
+    d = A_mpc.createVecLeft()
+    d.set(0)
+    d.array_w[constraint.slaves[:constraint.num_local_slaves]] = diagval
+    A_mpc.setDiagonal(d, addv=_PETSc.InsertMode.ADD)
+    d.destroy()
+
+    # Zero the rows and columns of the Dirichlet dofs, and set the diagonal value
+    V = constraint.function_space
+    offset = V.dofmap.index_map.local_range[0] * V.dofmap.index_map_bs
+    bc_rows = []
+    for bc in bcs:
+        dofs, num_owned = bc.dof_indices()
+        bc_rows.append(dofs[:num_owned] + offset)
+    bc_rows = numpy.unique(numpy.hstack(bc_rows)) if len(bc_rows) > 0 else numpy.empty(0)
+    A_mpc.zeroRowsColumns(bc_rows.astype(_PETSc.IntType), diag=diagval)
+    return A_mpc
+
+
+def create_unassembled_matrix(form: _fem.FormMetaClass, constraint: MultiPointConstraint) -> _PETSc.Mat:
+    """
+    Create an unassembled PETSc matrix (MATIS) for a square form with a multi point constraint, where each
+    process holds the matrix of the cells it owns. Slave contributions are added to the master rows and columns
+    of the subdomain matrix, with the index map of the constraint as local-to-global map. Assemble into it with
+    :func:`dolfinx_mpc.assemble_matrix`, and use it with the BDDC preconditioner (`-pc_type bddc`).
+
+    Parameters
+    ----------
+    form
+        The compiled bilinear variational form
+    constraint
+        The multi point constraint
+
+    Returns
+    -------
+    _PETSc.Mat
+        The unassembled matrix
+    """
+    assert form.function_spaces[0] == form.function_spaces[1]
+    constraint._not_finalized()
+    return cpp.mpc.create_unassembled_matrix(form, constraint._cpp_object)
+
+
 def create_sparsity_pattern(form: _fem.FormMetaClass,
                             mpc: Union[MultiPointConstraint,
                                        Sequence[MultiPointConstraint]]):
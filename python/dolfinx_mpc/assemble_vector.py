@@ -19,7 +19,8 @@ from .multipointconstraint import MultiPointConstraint
 
 
 def apply_lifting(b: _PETSc.Vec, form: List[_fem.FormMetaClass], bcs: List[List[_fem.DirichletBCMetaClass]],
-                  constraint: MultiPointConstraint, x0: List[_PETSc.Vec] = [], scale: float = 1.0):
+                  constraint: MultiPointConstraint, x0: List[_PETSc.Vec] = [], scale: float = 1.0,
+                  classifications: List = None):
     """
     Apply lifting to vector b, i.e.
 
@@ -40,6 +41,10 @@ def apply_lifting(b: _PETSc.Vec, form: List[_fem.FormMetaClass], bcs: List[List[
         List of vectors
     scale
         Scaling for lifting
+    classifications
+        Dof classifications of the trial space of each form with respect to its Dirichlet conditions (see
+        :meth:`dolfinx_mpc.MultiPointConstraint.create_dof_classification`). The conditions in `bcs` are then
+        only used for their values.
 
     Returns
     -------
@@ -51,13 +56,17 @@ def apply_lifting(b: _PETSc.Vec, form: List[_fem.FormMetaClass], bcs: List[List[
         x0 = [stack.enter_context(x.localForm()) for x in x0]
         x0_r = [x.array_r for x in x0]
         b_local = stack.enter_context(b.localForm())
-        dolfinx_mpc.cpp.mpc.apply_lifting(b_local.array_w, form,
-                                          bcs, x0_r, scale, constraint._cpp_object)
+        if classifications is None:
+            dolfinx_mpc.cpp.mpc.apply_lifting(b_local.array_w, form,
+                                              bcs, x0_r, scale, constraint._cpp_object)
+        else:
+            dolfinx_mpc.cpp.mpc.apply_lifting(b_local.array_w, form, bcs, classifications,
+                                              x0_r, scale, constraint._cpp_object)
     t.stop()
 
 
 def assemble_vector(form: ufl.form.Form, constraint: MultiPointConstraint,
-                    b: _PETSc.Vec = None) -> _PETSc.Vec:
+                    b: _PETSc.Vec = None, accumulate_ghosts: bool = False) -> _PETSc.Vec:
     """
     Assemble a linear form into vector b with corresponding multi point constraint
 
@@ -69,6 +78,10 @@ def assemble_vector(form: ufl.form.Form, constraint: MultiPointConstraint,
         The multi point constraint
     b
         PETSc vector to assemble into (optional)
+    accumulate_ghosts
+        If True, the ghost contributions are added to the owning processes, i.e. a reverse ghost update with
+        `PETSc.InsertMode.ADD` is performed. The cells with slaves or ghost dofs are assembled first, and the
+        remaining cells are assembled while the ghost contributions are communicated.
 
     Returns
     -------
@@ -82,7 +95,10 @@ def assemble_vector(form: ufl.form.Form, constraint: MultiPointConstraint,
     t = Timer("~MPC: Assemble vector (C++)")
     with b.localForm() as b_local:
         b_local.set(0.0)
-        dolfinx_mpc.cpp.mpc.assemble_vector(b_local, form, constraint._cpp_object)
+        if not accumulate_ghosts:
+            dolfinx_mpc.cpp.mpc.assemble_vector(b_local, form, constraint._cpp_object)
+    if accumulate_ghosts:
+        dolfinx_mpc.cpp.mpc.assemble_vector_ghosted(b, form, constraint._cpp_object)
     t.stop()
     return b
 
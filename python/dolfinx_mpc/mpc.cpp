@@ -9,18 +9,27 @@
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/fem/DirichletBC.h>
 #include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/Function.h>
 #include <dolfinx/fem/FunctionSpace.h>
 #include <dolfinx/geometry/BoundingBoxTree.h>
 #include <dolfinx/geometry/utils.h>
 #include <dolfinx/la/petsc.h>
 #include <dolfinx/mesh/MeshTags.h>
 #include <dolfinx_mpc/ContactConstraint.h>
+#include <dolfinx_mpc/DofClassification.h>
+#include <dolfinx_mpc/DofIdentification.h>
+#include <dolfinx_mpc/EquationReader.h>
+#include <dolfinx_mpc/HangingNodeConstraint.h>
+#include <dolfinx_mpc/LinearProblem.h>
 #include <dolfinx_mpc/MultiPointConstraint.h>
 #include <dolfinx_mpc/PeriodicConstraint.h>
+#include <dolfinx_mpc/SlidingInterface.h>
 #include <dolfinx_mpc/SlipConstraint.h>
 #include <dolfinx_mpc/assemble_matrix.h>
 #include <dolfinx_mpc/assemble_vector.h>
 #include <dolfinx_mpc/lifting.h>
+#include <dolfinx_mpc/multigrid.h>
+#include <dolfinx_mpc/reductions.h>
 #include <dolfinx_mpc/utils.h>
 #include <memory>
 #include <petscmat.h>
@@ -143,7 +152,43 @@ void mpc(py::module& m)
              py::array_t<PetscScalar, py::array::c_style> u) {
             self.homogenize(std::span<PetscScalar>(u.mutable_data(), u.size()));
           },
-          py::arg("u"), "Homogenize (set to zero) values at slave DoF indices");
+          py::arg("u"), "Homogenize (set to zero) values at slave DoF indices")
+      .def(
+          "set_phase_groups",
+          [](dolfinx_mpc::MultiPointConstraint<PetscScalar>& self,
+             const py::array_t<std::int32_t, py::array::c_style>& slaves,
+             const py::array_t<std::int32_t, py::array::c_style>& offsets,
+             const py::array_t<std::int32_t, py::array::c_style>& groups)
+          {
+            self.set_phase_groups(
+                std::span<const std::int32_t>(slaves.data(), slaves.size()),
+                std::span<const std::int32_t>(offsets.data(), offsets.size()),
+                std::span<const std::int32_t>(groups.data(), groups.size()));
+          },
+          py::arg("slaves"), py::arg("offsets"), py::arg("groups"),
+          "Assign each slave to phase groups")
+      .def(
+          "update_phases",
+          [](dolfinx_mpc::MultiPointConstraint<PetscScalar>& self,
+             const py::array_t<PetscScalar, py::array::c_style>& phases)
+          {
+            self.update_phases(
+                std::span<const PetscScalar>(phases.data(), phases.size()));
+          },
+          py::arg("phases"),
+          "Scale reference coefficients of each phase group by its phase")
+      .def(
+          "clone",
+          [](const dolfinx_mpc::MultiPointConstraint<PetscScalar>& self,
+             std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+             const py::array_t<PetscScalar, py::array::c_style>& coeffs)
+          {
+            return std::make_shared<
+                dolfinx_mpc::MultiPointConstraint<PetscScalar>>(self.clone(
+                V, std::span<const PetscScalar>(coeffs.data(), coeffs.size())));
+          },
+          py::arg("V"), py::arg("coeffs"),
+          "Copy the constraint to a function space with an identical dofmap");
 
   py::class_<dolfinx_mpc::mpc_data, std::shared_ptr<dolfinx_mpc::mpc_data>>
       mpc_data(m, "mpc_data", "Object with data arrays for mpc");
@@ -192,6 +237,26 @@ void mpc(py::module& m)
   //   .def("ghost_masters", &dolfinx_mpc::mpc_data::ghost_masters);
   m.def("create_sparsity_pattern", &dolfinx_mpc::create_sparsity_pattern);
 
+  py::class_<dolfinx_mpc::sparsity_estimate,
+             std::shared_ptr<dolfinx_mpc::sparsity_estimate>>(
+      m, "sparsity_estimate",
+      "Predicted number of nonzeros of a matrix with multi point constraints")
+      .def_property_readonly(
+          "row_nonzeros",
+          [](dolfinx_mpc::sparsity_estimate& self)
+          {
+            const std::vector<std::int32_t>& nnz = self.row_nonzeros;
+            return py::array_t<std::int32_t>(nnz.size(), nnz.data(),
+                                             py::cast(self));
+          })
+      .def_readonly("standard_nonzeros",
+                    &dolfinx_mpc::sparsity_estimate::standard_nonzeros)
+      .def_readonly("master_nonzeros",
+                    &dolfinx_mpc::sparsity_estimate::master_nonzeros)
+      .def_readonly("num_off_process_rows",
+                    &dolfinx_mpc::sparsity_estimate::num_off_process_rows);
+  m.def("estimate_sparsity", &dolfinx_mpc::estimate_sparsity);
+
   m.def("assemble_matrix",
         [](Mat A, const dolfinx::fem::Form<PetscScalar>& a,
            const std::shared_ptr<
@@ -200,13 +265,78 @@ void mpc(py::module& m)
                const dolfinx_mpc::MultiPointConstraint<PetscScalar>>& mpc1,
            const std::vector<std::shared_ptr<
                const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
-           const PetscScalar diagval)
+           const PetscScalar diagval, bool symmetric)
         {
-          dolfinx_mpc::assemble_matrix(
-              dolfinx::la::petsc::Matrix::set_block_fn(A, ADD_VALUES),
-              dolfinx::la::petsc::Matrix::set_fn(A, ADD_VALUES), a, mpc0, mpc1,
-              bcs, diagval);
-        });
+          auto set_block_fn
+              = dolfinx::la::petsc::Matrix::set_block_fn(A, ADD_VALUES);
+          auto set_fn = dolfinx::la::petsc::Matrix::set_fn(A, ADD_VALUES);
+          if (symmetric)
+          {
+            if (mpc0 != mpc1)
+            {
+              throw std::runtime_error("Symmetric assembly requires the same "
+                                       "constraint for rows and columns.");
+            }
+            std::shared_ptr<const dolfinx::fem::DofMap> dofmap
+                = mpc0->function_space()->dofmap();
+            const int bs = dofmap->index_map_bs();
+            set_block_fn = dolfinx_mpc::upper_triangular_fn<PetscScalar>(
+                set_block_fn, *dofmap->index_map, bs, true);
+            set_fn = dolfinx_mpc::upper_triangular_fn<PetscScalar>(
+                set_fn, *dofmap->index_map, bs, false);
+          }
+          dolfinx_mpc::assemble_matrix(set_block_fn, set_fn, a, mpc0, mpc1,
+                                       bcs, diagval);
+        },
+        py::arg("A"), py::arg("a"), py::arg("mpc0"), py::arg("mpc1"),
+        py::arg("bcs"), py::arg("diagval"), py::arg("symmetric") = false);
+  m.def(
+      "assemble_matrix",
+      [](Mat A, const dolfinx::fem::Form<PetscScalar>& a,
+         const dolfinx_mpc::DofClassification<PetscScalar>& classification0,
+         const dolfinx_mpc::DofClassification<PetscScalar>& classification1,
+         const PetscScalar diagval, bool symmetric)
+      {
+        auto set_block_fn
+            = dolfinx::la::petsc::Matrix::set_block_fn(A, ADD_VALUES);
+        auto set_fn = dolfinx::la::petsc::Matrix::set_fn(A, ADD_VALUES);
+        if (symmetric)
+        {
+          if (classification0.constraint() != classification1.constraint())
+          {
+            throw std::runtime_error("Symmetric assembly requires the same "
+                                     "constraint for rows and columns.");
+          }
+          std::shared_ptr<const dolfinx::fem::DofMap> dofmap
+              = classification0.constraint()->function_space()->dofmap();
+          const int bs = dofmap->index_map_bs();
+          set_block_fn = dolfinx_mpc::upper_triangular_fn<PetscScalar>(
+              set_block_fn, *dofmap->index_map, bs, true);
+          set_fn = dolfinx_mpc::upper_triangular_fn<PetscScalar>(
+              set_fn, *dofmap->index_map, bs, false);
+        }
+        dolfinx_mpc::assemble_matrix(set_block_fn, set_fn, a, classification0,
+                                     classification1, diagval);
+      },
+      py::arg("A"), py::arg("a"), py::arg("classification0"),
+      py::arg("classification1"), py::arg("diagval"),
+      py::arg("symmetric") = false,
+      "Assemble bilinear form into a matrix using precomputed dof "
+      "classifications");
+  m.def(
+      "insert_diagonal",
+      [](Mat A,
+         const dolfinx_mpc::DofClassification<PetscScalar>& classification,
+         const PetscScalar diagval)
+      {
+        const std::vector<std::int32_t>& bc_dofs = classification.bc_dofs();
+        dolfinx::fem::set_diagonal<PetscScalar>(
+            dolfinx::la::petsc::Matrix::set_fn(A, INSERT_VALUES),
+            std::span(bc_dofs.data(), classification.num_owned_bc_dofs()),
+            diagval);
+      },
+      py::arg("A"), py::arg("classification"), py::arg("diagval"),
+      "Insert a value on the diagonal of the owned Dirichlet rows");
   m.def(
       "assemble_vector",
       [](py::array_t<PetscScalar, py::array::c_style> b,
@@ -219,6 +349,44 @@ void mpc(py::module& m)
       },
       py::arg("b"), py::arg("L"), py::arg("mpc"),
       "Assemble linear form into an existing vector");
+  m.def(
+      "assemble_vector_ghosted",
+      [](Vec b, const dolfinx::fem::Form<PetscScalar>& L,
+         const std::shared_ptr<
+             const dolfinx_mpc::MultiPointConstraint<PetscScalar>>& mpc)
+      { dolfinx_mpc::assemble_vector(b, L, mpc); },
+      py::arg("b"), py::arg("L"), py::arg("mpc"),
+      "Assemble linear form into an existing ghosted PETSc vector, and "
+      "accumulate the ghost contributions on the owning processes");
+  m.def(
+      "inner_product",
+      [](const py::array_t<PetscScalar, py::array::c_style>& x,
+         const py::array_t<PetscScalar, py::array::c_style>& y,
+         const dolfinx_mpc::MultiPointConstraint<PetscScalar>& mpc,
+         bool condense)
+      {
+        return dolfinx_mpc::inner_product<PetscScalar>(
+            std::span(x.data(), x.size()), std::span(y.data(), y.size()), mpc,
+            condense);
+      },
+      py::arg("x"), py::arg("y"), py::arg("mpc"), py::arg("condense"),
+      "Inner product of two vectors on the constrained space");
+  m.def(
+      "norm",
+      [](const py::array_t<PetscScalar, py::array::c_style>& x,
+         const dolfinx_mpc::MultiPointConstraint<PetscScalar>& mpc,
+         dolfinx::la::Norm type, bool condense)
+      {
+        return dolfinx_mpc::norm<PetscScalar>(std::span(x.data(), x.size()),
+                                              mpc, type, condense);
+      },
+      py::arg("x"), py::arg("mpc"), py::arg("type"), py::arg("condense"),
+      "Norm of a vector on the constrained space");
+  m.def("assemble_residual", &dolfinx_mpc::assemble_residual, py::arg("b"),
+        py::arg("L"), py::arg("a"), py::arg("bcs"), py::arg("x"),
+        py::arg("mpc"), py::arg("type"),
+        "Assemble the residual of a nonlinear problem and compute its norm on "
+        "the constrained space");
 
   m.def(
       "apply_lifting",
@@ -241,6 +409,31 @@ void mpc(py::module& m)
       py::arg("b"), py::arg("a"), py::arg("bcs"), py::arg("x0"),
       py::arg("scale"), py::arg("mpc"),
       "Assemble apply lifting from form a on vector b");
+  m.def(
+      "apply_lifting",
+      [](py::array_t<PetscScalar, py::array::c_style> b,
+         std::vector<std::shared_ptr<const dolfinx::fem::Form<PetscScalar>>>& a,
+         const std::vector<std::vector<std::shared_ptr<
+             const dolfinx::fem::DirichletBC<PetscScalar>>>>& bcs1,
+         const std::vector<std::shared_ptr<
+             const dolfinx_mpc::DofClassification<PetscScalar>>>&
+             classifications1,
+         const std::vector<py::array_t<PetscScalar, py::array::c_style>>& x0,
+         double scale,
+         std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<PetscScalar>>&
+             mpc)
+      {
+        std::vector<std::span<const PetscScalar>> _x0;
+        for (const auto& x : x0)
+          _x0.emplace_back(x.data(), x.size());
+
+        dolfinx_mpc::apply_lifting(std::span(b.mutable_data(), b.size()), a,
+                                   bcs1, classifications1, _x0, scale, mpc);
+      },
+      py::arg("b"), py::arg("a"), py::arg("bcs"), py::arg("classifications"),
+      py::arg("x0"), py::arg("scale"), py::arg("mpc"),
+      "Apply lifting from form a on vector b using precomputed dof "
+      "classifications");
 
   m.def(
       "create_matrix",
@@ -270,11 +463,157 @@ void mpc(py::module& m)
       },
       py::return_value_policy::take_ownership,
       "Create a PETSc Mat for bilinear form.");
+  m.def(
+      "create_symmetric_matrix",
+      [](const dolfinx::fem::Form<PetscScalar>& a,
+         const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>>&
+             mpc)
+      {
+        auto A = dolfinx_mpc::create_symmetric_matrix(a, mpc);
+        Mat _A = A.mat();
+        PetscObjectReference((PetscObject)_A);
+        return _A;
+      },
+      py::return_value_policy::take_ownership,
+      "Create a symmetric PETSc Mat (SBAIJ) storing the upper triangular part "
+      "for a symmetric bilinear form.");
+  m.def(
+      "create_unassembled_matrix",
+      [](const dolfinx::fem::Form<PetscScalar>& a,
+         const std::shared_ptr<dolfinx_mpc::MultiPointConstraint<PetscScalar>>&
+             mpc)
+      {
+        auto A = dolfinx_mpc::create_unassembled_matrix(a, mpc);
+        Mat _A = A.mat();
+        PetscObjectReference((PetscObject)_A);
+        return _A;
+      },
+      py::return_value_policy::take_ownership,
+      "Create an unassembled PETSc Mat (MATIS) with one subdomain matrix per "
+      "process.");
+  m.def("create_symmetric_sparsity_pattern",
+        &dolfinx_mpc::create_symmetric_sparsity_pattern);
+  m.def(
+      "create_transformation_matrix",
+      [](const std::shared_ptr<
+          const dolfinx_mpc::MultiPointConstraint<PetscScalar>>& mpc)
+      {
+        auto K = dolfinx_mpc::create_transformation_matrix(*mpc);
+        Mat _K = K.mat();
+        PetscObjectReference((PetscObject)_K);
+        return _K;
+      },
+      py::return_value_policy::take_ownership,
+      "Create the transformation matrix K of a multi point constraint.");
+  m.def(
+      "create_mpc_prolongation",
+      [](Mat P,
+         const std::shared_ptr<
+             const dolfinx_mpc::MultiPointConstraint<PetscScalar>>& mpc_coarse,
+         const std::shared_ptr<
+             const dolfinx_mpc::MultiPointConstraint<PetscScalar>>& mpc_fine)
+      {
+        auto P_mpc
+            = dolfinx_mpc::create_mpc_prolongation(P, *mpc_coarse, *mpc_fine);
+        Mat _P = P_mpc.mat();
+        PetscObjectReference((PetscObject)_P);
+        return _P;
+      },
+      py::return_value_policy::take_ownership,
+      "Create a prolongation matrix consistent with multi point constraints.");
   m.def("create_contact_slip_condition",
         &dolfinx_mpc::create_contact_slip_condition);
   m.def("create_slip_condition", &dolfinx_mpc::create_slip_condition);
+  m.def("create_slip_condition_with_dirichlet",
+        &dolfinx_mpc::create_slip_condition_with_dirichlet);
   m.def("create_contact_inelastic_condition",
         &dolfinx_mpc::create_contact_inelastic_condition);
+
+  py::class_<dolfinx_mpc::SlidingInterface,
+             std::shared_ptr<dolfinx_mpc::SlidingInterface>>(
+      m, "SlidingInterface",
+      "Sliding interface between a rotating and a fixed part of a mesh")
+      .def(py::init<std::shared_ptr<const dolfinx::fem::FunctionSpace>,
+                    const dolfinx::mesh::MeshTags<std::int32_t>&, std::int32_t,
+                    std::int32_t, std::array<double, 3>, std::array<double, 3>,
+                    double>(),
+           py::arg("V"), py::arg("meshtags"), py::arg("slave_marker"),
+           py::arg("master_marker"), py::arg("origin"), py::arg("axis"),
+           py::arg("tol"))
+      .def("create_constraint",
+           &dolfinx_mpc::SlidingInterface::create_constraint, py::arg("angle"),
+           "Create the constraint data for a rotation angle")
+      .def_property_readonly("function_space",
+                             &dolfinx_mpc::SlidingInterface::function_space)
+      .def_property_readonly("num_slave_blocks",
+                             &dolfinx_mpc::SlidingInterface::num_slave_blocks)
+      .def_property_readonly(
+          "num_master_facets",
+          &dolfinx_mpc::SlidingInterface::num_master_facets);
+
+  py::class_<dolfinx_mpc::DofClassification<PetscScalar>,
+             std::shared_ptr<dolfinx_mpc::DofClassification<PetscScalar>>>(
+      m, "DofClassification",
+      "Classification of dofs with respect to Dirichlet conditions and a "
+      "multi-point constraint")
+      .def(py::init<std::shared_ptr<const dolfinx::fem::FunctionSpace>,
+                    const std::vector<std::shared_ptr<
+                        const dolfinx::fem::DirichletBC<PetscScalar>>>&,
+                    std::shared_ptr<const dolfinx_mpc::MultiPointConstraint<
+                        PetscScalar>>>(),
+           py::arg("V"), py::arg("bcs"), py::arg("mpc"))
+      .def_property_readonly(
+          "function_space",
+          &dolfinx_mpc::DofClassification<PetscScalar>::function_space)
+      .def_property_readonly(
+          "bc_dofs",
+          [](dolfinx_mpc::DofClassification<PetscScalar>& self)
+          {
+            const std::vector<std::int32_t>& dofs = self.bc_dofs();
+            return py::array_t<std::int32_t>(dofs.size(), dofs.data(),
+                                             py::cast(self));
+          })
+      .def_property_readonly(
+          "num_owned_bc_dofs",
+          &dolfinx_mpc::DofClassification<PetscScalar>::num_owned_bc_dofs)
+      .def_property_readonly(
+          "cell_flags",
+          [](dolfinx_mpc::DofClassification<PetscScalar>& self)
+          {
+            const std::vector<std::int8_t>& flags = self.cell_flags();
+            return py::array_t<std::int8_t>(flags.size(), flags.data(),
+                                            py::cast(self));
+          });
+
+  py::class_<dolfinx_mpc::LinearProblem,
+             std::shared_ptr<dolfinx_mpc::LinearProblem>>(
+      m, "LinearProblem",
+      "Linear problem with a multi-point constraint, with persistent matrix, "
+      "vectors and Krylov solver")
+      .def(py::init<std::shared_ptr<const dolfinx::fem::Form<PetscScalar>>,
+                    std::shared_ptr<const dolfinx::fem::Form<PetscScalar>>,
+                    std::shared_ptr<
+                        dolfinx_mpc::MultiPointConstraint<PetscScalar>>,
+                    const std::vector<std::shared_ptr<
+                        const dolfinx::fem::DirichletBC<PetscScalar>>>&,
+                    std::shared_ptr<dolfinx::fem::Function<PetscScalar>>,
+                    const std::map<std::string, std::string>&,
+                    const std::string&>(),
+           py::arg("a"), py::arg("L"), py::arg("mpc"), py::arg("bcs"),
+           py::arg("u") = py::none(),
+           py::arg("petsc_options") = std::map<std::string, std::string>(),
+           py::arg("prefix") = std::string())
+      .def("assemble_matrix", &dolfinx_mpc::LinearProblem::assemble_matrix)
+      .def("assemble_vector", &dolfinx_mpc::LinearProblem::assemble_vector)
+      .def("assemble", &dolfinx_mpc::LinearProblem::assemble)
+      .def("solve", &dolfinx_mpc::LinearProblem::solve)
+      .def_property_readonly("A", &dolfinx_mpc::LinearProblem::A)
+      .def_property_readonly("b", &dolfinx_mpc::LinearProblem::b)
+      .def_property_readonly("ksp", &dolfinx_mpc::LinearProblem::ksp)
+      .def_property_readonly("u", &dolfinx_mpc::LinearProblem::u)
+      .def_property_readonly("options_prefix",
+                             &dolfinx_mpc::LinearProblem::options_prefix);
+
   m.def("create_normal_approximation",
         [](std::shared_ptr<dolfinx::fem::FunctionSpace> V, std::int32_t dim,
            const py::array_t<std::int32_t, py::array::c_style>& entities)
@@ -284,6 +623,49 @@ void mpc(py::module& m)
               std::span<const std::int32_t>(entities.data(), entities.size()));
         });
 
+  m.def(
+      "create_hanging_node_constraint",
+      [](std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+         const py::array_t<std::int32_t, py::array::c_style>& parent_facets,
+         const py::array_t<std::int32_t, py::array::c_style>& child_facets,
+         const std::vector<
+             std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>&
+             bcs)
+      {
+        return dolfinx_mpc::create_hanging_node_constraint(
+            V,
+            std::span<const std::int32_t>(parent_facets.data(),
+                                          parent_facets.size()),
+            std::span<const std::int32_t>(child_facets.data(),
+                                          child_facets.size()),
+            bcs);
+      },
+      py::arg("V"), py::arg("parent_facets"), py::arg("child_facets"),
+      py::arg("bcs"),
+      "Create the constraints of the hanging nodes of a non-conforming mesh");
+
+  py::enum_<dolfinx_mpc::EquationFormat>(m, "EquationFormat")
+      .value("csv", dolfinx_mpc::EquationFormat::csv)
+      .value("binary", dolfinx_mpc::EquationFormat::binary);
+  m.def("read_constraint_equations", &dolfinx_mpc::read_constraint_equations,
+        py::arg("V"), py::arg("filename"), py::arg("format"),
+        "Read linear constraint equations from a file.");
+
+  m.def(
+      "compute_periodic_coefficients",
+      [](const dolfinx_mpc::MultiPointConstraint<PetscScalar>& mpc,
+         std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
+         const py::array_t<double, py::array::c_style>& points, double scale)
+      {
+        std::vector<PetscScalar> coeffs
+            = dolfinx_mpc::compute_periodic_coefficients(
+                mpc, V, std::span<const double>(points.data(), points.size()),
+                scale);
+        return as_pyarray(std::move(coeffs));
+      },
+      py::arg("mpc"), py::arg("V"), py::arg("points"), py::arg("scale"),
+      "Recompute the coefficients of a periodic constraint on a new mesh");
+
   m.def("create_periodic_constraint_geometrical",
         [](const std::shared_ptr<const dolfinx::fem::FunctionSpace> V,
            const std::function<py::array_t<bool>(const py::array_t<double>&)>&
@@ -292,7 +674,7 @@ void mpc(py::module& m)
                relation,
            const std::vector<std::shared_ptr<
                const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
-           double scale, bool collapse)
+           double scale, bool collapse, bool vertex_masters)
         {
           auto _indicator
               = [&indicator](
@@ -320,7 +702,7 @@ void mpc(py::module& m)
             return xt::adapt(v.data(), shape);
           };
           return dolfinx_mpc::create_periodic_condition_geometrical(
-              V, _indicator, _relation, bcs, scale, collapse);
+              V, _indicator, _relation, bcs, scale, collapse, vertex_masters);
         });
 
   m.def("create_periodic_constraint_topological",
@@ -332,7 +714,7 @@ void mpc(py::module& m)
                relation,
            const std::vector<std::shared_ptr<
                const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
-           double scale, bool collapse)
+           double scale, bool collapse, bool vertex_masters)
         {
           auto _relation =
               [&relation](const xt::xtensor<double, 2>& x) -> xt::xarray<double>
@@ -347,7 +729,73 @@ void mpc(py::module& m)
             return xt::adapt(v.data(), shape);
           };
           return dolfinx_mpc::create_periodic_condition_topological(
-              V, meshtags, dim, _relation, bcs, scale, collapse);
+              V, meshtags, dim, _relation, bcs, scale, collapse,
+              vertex_masters);
         });
+
+  m.def("create_periodic_constraint_refined",
+        [](const std::shared_ptr<const dolfinx::fem::FunctionSpace>& V,
+           const std::shared_ptr<const dolfinx::mesh::MeshTags<std::int32_t>>&
+               meshtags,
+           const int dim,
+           const std::function<py::array_t<double>(const py::array_t<double>&)>&
+               relation,
+           const std::vector<std::shared_ptr<
+               const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
+           double scale, bool collapse,
+           const std::shared_ptr<
+               const dolfinx_mpc::MultiPointConstraint<PetscScalar>>&
+               parent_mpc,
+           const py::array_t<std::int32_t, py::array::c_style>& parent_cells)
+        {
+          auto _relation =
+              [&relation](const xt::xtensor<double, 2>& x) -> xt::xarray<double>
+          {
+            auto strides = x.strides();
+            std::transform(strides.begin(), strides.end(), strides.begin(),
+                           [](auto s) { return s * sizeof(double); });
+            py::array_t _x(x.shape(), strides, x.data(), py::none());
+            py::array_t v = relation(_x);
+            std::vector<std::size_t> shape;
+            std::copy_n(v.shape(), v.ndim(), std::back_inserter(shape));
+            return xt::adapt(v.data(), shape);
+          };
+          return dolfinx_mpc::create_periodic_condition_refined(
+              V, meshtags, dim, _relation, bcs, scale, collapse, parent_mpc,
+              std::span<const std::int32_t>(parent_cells.data(),
+                                            parent_cells.size()));
+        });
+
+  m.def(
+      "is_dof_identification",
+      [](const std::shared_ptr<const dolfinx::fem::FunctionSpace>& V,
+         const py::array_t<PetscScalar, py::array::c_style>& coeffs,
+         const py::array_t<std::int32_t, py::array::c_style>& offsets,
+         double tol)
+      {
+        return dolfinx_mpc::is_dof_identification<PetscScalar>(
+            V->mesh()->comm(), std::span(coeffs.data(), coeffs.size()),
+            std::span(offsets.data(), offsets.size()), tol);
+      },
+      py::arg("V"), py::arg("coeffs"), py::arg("offsets"),
+      py::arg("tol") = 1e-13,
+      "Check if every slave has a single master with unit coefficient");
+  m.def(
+      "create_identified_functionspace",
+      [](const std::shared_ptr<const dolfinx::fem::FunctionSpace>& V,
+         const py::array_t<std::int32_t, py::array::c_style>& slaves,
+         const py::array_t<std::int64_t, py::array::c_style>& masters,
+         const py::array_t<std::int32_t, py::array::c_style>& owners)
+      {
+        auto [W, block_map] = dolfinx_mpc::create_identified_functionspace(
+            V, std::span(slaves.data(), slaves.size()),
+            std::span(masters.data(), masters.size()),
+            std::span(owners.data(), owners.size()));
+        return std::pair(
+            std::make_shared<dolfinx::fem::FunctionSpace>(std::move(W)),
+            as_pyarray(std::move(block_map)));
+      },
+      py::arg("V"), py::arg("slaves"), py::arg("masters"), py::arg("owners"),
+      "Create function space where slaves are identified with their master");
 }
 } // namespace dolfinx_mpc_wrappers
@@ -0,0 +1,119 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+from typing import Optional, Sequence
+
+from petsc4py import PETSc as _PETSc
+
+import dolfinx_mpc.cpp
+
+from .multipointconstraint import MultiPointConstraint
+
+__all__ = ["create_transformation_matrix", "create_mpc_prolongation", "setup_mpc_multigrid"]
+
+
+def create_transformation_matrix(constraint: MultiPointConstraint) -> _PETSc.Mat:
+    """
+    Create the transformation matrix K of a multi point constraint, such that the solution
+    satisfying the constraint is given by u = K u_reduced.
+    The rows of non-slave degrees of freedom are identity rows, and the row of a slave degree of
+    freedom contains the coefficients at its masters.
+
+    Parameters
+    ----------
+    constraint
+        The multi point constraint
+
+    Returns
+    -------
+    PETSc.Mat
+        The transformation matrix
+    """
+    return dolfinx_mpc.cpp.mpc.create_transformation_matrix(constraint._cpp_object)
+
+
+def create_mpc_prolongation(P: _PETSc.Mat, constraint_coarse: MultiPointConstraint,
+                            constraint_fine: MultiPointConstraint) -> _PETSc.Mat:
+    """
+    Create a prolongation matrix between two levels with multi point constraints, P_mpc = Z_f P K_c,
+    where K_c is the transformation matrix of the coarse constraint and Z_f zeros the rows
+    of the slave degrees of freedom of the fine constraint. The corresponding restriction
+    is the transpose of P_mpc.
+
+    Parameters
+    ----------
+    P
+        Interpolation matrix from the coarse to the fine function space (without constraints)
+    constraint_coarse
+        The multi point constraint on the coarse level
+    constraint_fine
+        The multi point constraint on the fine level
+
+    Returns
+    -------
+    PETSc.Mat
+        The prolongation matrix
+    """
+    return dolfinx_mpc.cpp.mpc.create_mpc_prolongation(P, constraint_coarse._cpp_object,
+                                                       constraint_fine._cpp_object)
+
+
+def _set_slave_diagonal(A: _PETSc.Mat, constraint: MultiPointConstraint, diagval: _PETSc.ScalarType = 1):
+    """
+    Set the diagonal entries of the rows of the slave degrees of freedom owned by the process
+    """
+    # The rows and columns of the slaves are zero in P^T A P, so adding to the diagonal sets it
+    A.setOption(_PETSc.Mat.Option.NEW_NONZERO_ALLOCATION_ERR, False)
+    d = A.createVecLeft()
+    d.set(0)
+    d.array_w[constraint.slaves[:constraint.num_local_slaves]] = diagval
+    A.setDiagonal(d, addv=_PETSc.InsertMode.ADD)
+    d.destroy()
+
+
+def setup_mpc_multigrid(ksp: _PETSc.KSP, prolongations: Sequence[_PETSc.Mat],
+                        operators: Optional[Sequence[_PETSc.Mat]] = None,
+                        constraints: Optional[Sequence[MultiPointConstraint]] = None):
+    """
+    Set up geometric multigrid (PCMG) for a Krylov solver with constraint consistent transfer operators.
+
+    Parameters
+    ----------
+    ksp
+        The Krylov solver, with operators set to the (MPC-assembled) matrix on the finest level
+    prolongations
+        Prolongation matrices (see `create_mpc_prolongation`), where the ith matrix maps
+        from level i to level i+1 (level 0 is the coarsest level)
+    operators
+        The (MPC-assembled) matrices on each level, ordered from the coarsest to the finest level.
+        If not supplied, the coarse operators are computed by Galerkin projection, A_c = P^T A_f P.
+        As the prolongations have zero columns for the coarse slave degrees of freedom, the diagonal
+        of these rows is set to one (as in `assemble_matrix`).
+    constraints
+        The multi point constraints on each level, ordered from the coarsest to the finest level.
+        Required if the operators are not supplied.
+    """
+    num_levels = len(prolongations) + 1
+    if operators is None:
+        if constraints is None:
+            raise ValueError("The constraints are required to compute the Galerkin coarse operators")
+        if len(constraints) != num_levels:
+            raise ValueError("Number of constraints has to match the number of levels")
+        operators = [ksp.getOperators()[0]]
+        for i in reversed(range(num_levels - 1)):
+            A_c = operators[0].PtAP(prolongations[i])
+            _set_slave_diagonal(A_c, constraints[i])
+            operators.insert(0, A_c)
+    elif len(operators) != num_levels:
+        raise ValueError("Number of operators has to match the number of levels")
+
+    pc = ksp.getPC()
+    pc.setType(_PETSc.PC.Type.MG)
+    pc.setMGLevels(num_levels)
+    for i, P in enumerate(prolongations):
+        pc.setMGInterpolation(i + 1, P)
+    for i, A in enumerate(operators):
+        pc.getMGSmoother(i).setOperators(A)
@@ -4,7 +4,7 @@
 #
 # SPDX-License-Identifier:    MIT
 
-from typing import Callable, Dict, List
+from typing import Callable, Dict, List, Optional, Sequence, Tuple
 
 import dolfinx.cpp as _cpp
 import dolfinx.fem as _fem
@@ -33,6 +33,10 @@ class MultiPointConstraint():
         self._coeffs = numpy.array([], dtype=_PETSc.ScalarType)
         self._owners = numpy.array([], dtype=numpy.int32)
         self._offsets = numpy.array([0], dtype=numpy.int32)
+        self._groups = numpy.array([], dtype=numpy.int32)
+        self._num_groups = 0
+        self._combined_groups: Dict[int, List[int]] = {}
+        self._phase_data = None
         self.V = V
         self.finalized = False
 
@@ -68,6 +72,8 @@ class MultiPointConstraint():
             self._masters = numpy.append(self._masters, masters)
             self._coeffs = numpy.append(self._coeffs, coeffs)
             self._owners = numpy.append(self._owners, owners)
+            self._groups = numpy.append(self._groups, numpy.full(len(slaves), self._num_groups, dtype=numpy.int32))
+        self._num_groups += 1
 
     def add_constraint_from_mpc_data(self, V: _fem.FunctionSpace, mpc_data: dolfinx_mpc.cpp.mpc.mpc_data):
         """
@@ -87,16 +93,214 @@ class MultiPointConstraint():
         # Initialize C++ object and create slave->cell maps
         self._cpp_object = dolfinx_mpc.cpp.mpc.MultiPointConstraint(
             self.V._cpp_object, self._slaves, self._masters, self._coeffs, self._owners, self._offsets)
+        # Keep the constraint of each slave for phase updates. The reference coefficients are only stored on
+        # the first call to `update_phases`
+        self._phase_data = (self._slaves, self._groups)
         # Replace function space
         self.V = _fem.FunctionSpace(None, self.V.ufl_element(), self._cpp_object.function_space)
 
         self.finalized = True
         # Delete variables that are no longer required
-        del (self._slaves, self._masters, self._coeffs, self._owners, self._offsets)
+        del (self._slaves, self._masters, self._coeffs, self._owners, self._offsets, self._groups)
+
+    def combine_phase_groups(self, constraint: int, groups: Sequence[int]) -> None:
+        """
+        Scale the coefficients of the `constraint`-th added constraint by the product of the phases of the
+        constraints in `groups` in `update_phases`, instead of by its own phase. This is used for slaves that
+        are mapped over several periods, such as the corners of a constraint that is periodic in several
+        directions.
+
+        Parameters
+        ----------
+        constraint
+            The index of the constraint (in order of creation)
+        groups
+            The indices of the constraints whose phases are multiplied
+
+        Example
+        -------
+        Periodic constraints in x and y direction, where the corner (1, 1) is mapped to (0, 0) in a separate
+        constraint
+            mpc.create_periodic_constraint_topological(V, mt, 1, relation_x, bcs)
+            mpc.create_periodic_constraint_topological(V, mt, 2, relation_y, bcs)
+            mpc.create_periodic_constraint_geometrical(V, is_corner, relation_corner, bcs)
+            mpc.combine_phase_groups(2, [0, 1])
+        """
+        self._already_finalized()
+        if constraint < 0 or any(group < 0 for group in groups):
+            raise ValueError("Constraint and group indices have to be non-negative")
+        self._combined_groups[constraint] = list(groups)
+
+    def update_phases(self, phases: Sequence[_PETSc.ScalarType]) -> None:
+        """
+        Scale the coefficients of each constraint added to the multi point constraint by a phase factor, i.e.
+        the coefficients of the i-th added constraint (in order of creation) are set to
+        `phases[i] * coeffs_i`, where `coeffs_i` are the coefficients when `update_phases` is first called
+        (the coefficients used at creation). Constraints passed to `combine_phase_groups` are scaled by the
+        product of the phases of their groups instead.
+        As the masters are unchanged, the index map, sparsity pattern and matrix of the
+        constraint can be reused. This is for instance used in Bloch-Floquet sweeps, where
+        periodic constraints are created with `scale=1` once for each direction.
+
+        Parameters
+        ----------
+        phases
+            The phase factor for each constraint
+
+        Example
+        -------
+        Sweep over wave vectors `k` for a periodic constraint in x and y direction with period `a`
+            mpc.create_periodic_constraint_topological(V, mt, 1, relation_x, bcs)
+            mpc.create_periodic_constraint_topological(V, mt, 2, relation_y, bcs)
+            mpc.finalize()
+            A = dolfinx_mpc.assemble_matrix(a, mpc, bcs=bcs)
+            for k in k_path:
+                mpc.update_phases(numpy.exp(1j * k * a))
+                A.zeroEntries()
+                dolfinx_mpc.assemble_matrix(a, mpc, bcs=bcs, A=A)
+        """
+        self._not_finalized()
+        if len(phases) != self._num_groups:
+            raise ValueError(f"Expected {self._num_groups} phases, got {len(phases)}")
+        if self._phase_data is not None:
+            # Expand the constraint of each slave to its phase groups
+            slaves, constraints = self._phase_data
+            group_lists = [self._combined_groups.get(c, [c]) for c in range(self._num_groups)]
+            if any(group >= self._num_groups for groups in group_lists for group in groups):
+                raise ValueError(f"Phase groups have to be smaller than {self._num_groups}")
+            num_groups = numpy.array([len(groups) for groups in group_lists], dtype=numpy.int32)
+            offsets = numpy.zeros(len(slaves) + 1, dtype=numpy.int32)
+            numpy.cumsum(num_groups[constraints], out=offsets[1:])
+            if len(self._combined_groups) == 0:
+                groups = numpy.asarray(constraints, dtype=numpy.int32)
+            else:
+                groups = numpy.array([g for c in constraints for g in group_lists[c]], dtype=numpy.int32)
+            self._cpp_object.set_phase_groups(slaves, offsets, groups)
+            self._phase_data = None
+        self._cpp_object.update_phases(numpy.asarray(phases, dtype=_PETSc.ScalarType))
+
+    def clone(self, V: _fem.FunctionSpace, relation: Optional[Callable[[numpy.ndarray], numpy.ndarray]] = None,
+              scale: float = 1) -> "MultiPointConstraint":
+        """
+        Create a copy of a finalized constraint on a function space with an identical dofmap, for instance the
+        same space on a mesh with the same topology but other coordinates. The masters, owners, cell to slave
+        map and dofmap are shared with this constraint and the slave arrays are copied, so no searches or
+        parallel communication are required.
+        If no relation is given (for constraints whose coefficients do not depend on the coordinates, such as
+        translational periodicity between boundaries that stay matching), the coefficients are copied.
+        Otherwise, the coefficients of the periodic constraint `u(x) = scale * u(relation(x))` are
+        re-evaluated on the new mesh, keeping the masters of each slave.
+        This requires all masters to be on the process, which is the case for meshes on `MPI.COMM_SELF`.
+
+        Parameters
+        ----------
+        V
+            The function space on the new mesh. Its dofmap has to be identical to the dofmap of the function
+            space used to create the constraint
+        relation
+            The map from the slave coordinates to the master coordinates used to create the periodic
+            constraint (input and output of shape (3, num_points)). If None, the coefficients are copied
+        scale
+            Scaling of the periodic constraint
+
+        Example
+        -------
+        Reuse a periodic constraint for a batch of meshes with the same topology
+            mpc_ref = dolfinx_mpc.MultiPointConstraint(V_ref)
+            mpc_ref.create_periodic_constraint_topological(V_ref, mt, 1, relation, bcs)
+            mpc_ref.finalize()
+            for mesh in meshes:
+                V = dolfinx.fem.FunctionSpace(mesh, V_ref.ufl_element())
+                mpc = mpc_ref.clone(V, relation)
+        """
+        self._not_finalized()
+        coeffs = numpy.array([], dtype=_PETSc.ScalarType)
+        if relation is not None:
+            bs = V.dofmap.index_map_bs
+            x = V.tabulate_dof_coordinates()[self.slaves // bs]
+            points = numpy.ascontiguousarray(numpy.asarray(relation(x.T), dtype=numpy.float64).T)
+            coeffs = dolfinx_mpc.cpp.mpc.compute_periodic_coefficients(self._cpp_object, V._cpp_object, points, scale)
+
+        mpc = MultiPointConstraint(V)
+        mpc._cpp_object = self._cpp_object.clone(V._cpp_object, coeffs)
+        mpc.V = _fem.FunctionSpace(None, V.ufl_element(), mpc._cpp_object.function_space)
+        mpc._num_groups = self._num_groups
+        mpc._combined_groups = dict(self._combined_groups)
+        mpc._phase_data = self._phase_data
+        mpc.finalized = True
+        del (mpc._slaves, mpc._masters, mpc._coeffs, mpc._owners, mpc._offsets, mpc._groups)
+        return mpc
+
+    def create_dof_classification(self, V: _fem.FunctionSpace,
+                                  bcs: Sequence[_fem.DirichletBCMetaClass] = []):
+        """
+        Classify the degrees of freedom of a function space with respect to a set of Dirichlet conditions
+        and the constraint. The classification holds the sorted Dirichlet dofs, and flags every cell
+        containing Dirichlet or slave dofs, such that the assembly only has to classify the dofs of these
+        cells. Create it once and pass it to :func:`dolfinx_mpc.assemble_matrix` and
+        :func:`dolfinx_mpc.apply_lifting` to avoid marking the Dirichlet dofs in each assembly, e.g. in
+        every step of a transient problem.
+
+        Parameters
+        ----------
+        V
+            The function space of the forms (the test or trial space)
+        bcs
+            List of Dirichlet boundary conditions. Conditions that are not applied to V are ignored
+
+        Returns
+        -------
+        dolfinx_mpc.cpp.mpc.DofClassification
+            The classification of the dofs
+        """
+        self._not_finalized()
+        return dolfinx_mpc.cpp.mpc.DofClassification(V._cpp_object, bcs, self._cpp_object)
+
+    def is_dof_identification(self, tol: float = 1e-13) -> bool:
+        """
+        Check if the constraint is a pure identification of degrees of freedom, i.e. every slave has a
+        single master with coefficient one. This is for instance the case for topological periodic
+        constraints on matching meshes. Has to be called before the constraint is finalized.
+
+        Parameters
+        ----------
+        tol
+            Tolerance for the comparison of the coefficients with one
+        """
+        self._already_finalized()
+        return dolfinx_mpc.cpp.mpc.is_dof_identification(self.V._cpp_object, self._coeffs, self._offsets, tol)
+
+    def create_identified_space(self) -> Tuple[_fem.FunctionSpace, npt.NDArray[numpy.int32]]:
+        """
+        For a constraint that is a pure identification of degrees of freedom (see `is_dof_identification`),
+        create a function space where each slave block is merged with its master block in the dofmap.
+        The constrained problem can then be solved with the standard DOLFINx assemblers and solvers, without
+        finalizing the multi point constraint. Has to be called before the constraint is finalized.
+
+        Returns
+        -------
+        Tuple[dolfinx.fem.FunctionSpace, numpy.ndarray]
+            The identified function space and a map from each block (local to process) of the original space
+            to its block (local to process) in the identified space.
+
+        Example
+        -------
+        Transfer a solution `w` in the identified space `W` to a function `u` in the original space
+            W, block_map = mpc.create_identified_space()
+            bs = W.dofmap.index_map_bs
+            u.x.array.reshape(-1, bs)[:] = w.x.array.reshape(-1, bs)[block_map]
+        """
+        self._already_finalized()
+        if not self.is_dof_identification():
+            raise RuntimeError("Constraint is not a pure identification of degrees of freedom")
+        cpp_space, block_map = dolfinx_mpc.cpp.mpc.create_identified_functionspace(
+            self.V._cpp_object, self._slaves, self._masters, self._owners)
+        return _fem.FunctionSpace(None, self.V.ufl_element(), cpp_space), block_map
 
     def create_periodic_constraint_topological(self, V: _fem.FunctionSpace, meshtag: _cpp.mesh.MeshTags_int32, tag: int,
                                                relation: Callable[[numpy.ndarray], numpy.ndarray],
-                                               bcs: list[_fem.DirichletBCMetaClass], scale: _PETSc.ScalarType = 1):
+                                               bcs: list[_fem.DirichletBCMetaClass], scale: _PETSc.ScalarType = 1,
+                                               vertex_masters: bool = False):
         """
         Create periodic condition for all dofs in MeshTag with given marker:
         u(x_i) = scale * u(relation(x_i))
@@ -117,13 +321,64 @@ class MultiPointConstraint():
             (Periodic constraints will be ignored for these dofs)
         scale
             Float for scaling bc
+        vertex_masters
+            If True, only the degrees of freedom at the vertices of the master cell are used as masters,
+            with the (linear) barycentric coordinates of the mapped slave coordinate as coefficients.
+            This reduces the fill of high order spaces, at the cost of a first order accurate
+            interpolation. Only supported for scalar (or blocked scalar) Lagrange spaces on simplices.
         """
         if (V is self.V):
             mpc_data = dolfinx_mpc.cpp.mpc.create_periodic_constraint_topological(
-                self.V._cpp_object, meshtag, tag, relation, bcs, scale, False)
+                self.V._cpp_object, meshtag, tag, relation, bcs, scale, False, vertex_masters)
         elif self.V.contains(V):
             mpc_data = dolfinx_mpc.cpp.mpc.create_periodic_constraint_topological(
-                V._cpp_object, meshtag, tag, relation, bcs, scale, True)
+                V._cpp_object, meshtag, tag, relation, bcs, scale, True, vertex_masters)
+        else:
+            raise RuntimeError("The input space has to be a sub space (or the full space) of the MPC")
+        self.add_constraint_from_mpc_data(self.V, mpc_data=mpc_data)
+
+    def create_periodic_constraint_refined(self, V: _fem.FunctionSpace, meshtag: _cpp.mesh.MeshTags_int32, tag: int,
+                                           relation: Callable[[numpy.ndarray], numpy.ndarray],
+                                           bcs: list[_fem.DirichletBCMetaClass],
+                                           parent_constraint: "MultiPointConstraint",
+                                           parent_cells: npt.NDArray[numpy.int32],
+                                           scale: _PETSc.ScalarType = 1):
+        """
+        Create a periodic condition on a refined mesh, given the periodic condition on its parent mesh.
+        The masters of each slave are first searched for among the children of the master cells of
+        its parent cell, and only slaves not found there are searched for on all cells.
+        Applying this recursively builds constraints on a hierarchy of refined meshes.
+
+        Parameters
+        ----------
+        V
+            The function space to assign the condition to. Should either be the space of the MPC or a sub space.
+        meshtag
+            MeshTag (on the refined mesh) for entity to apply the periodic condition on
+        tag
+            Tag indicating which entities should be slaves
+        relation
+            Lambda-function describing the geometrical relation
+        bcs
+            Dirichlet boundary conditions for the problem
+            (Periodic constraints will be ignored for these dofs)
+        parent_constraint
+            The finalized multi point constraint on the parent mesh
+        parent_cells
+            Map from each cell (local to process) of the refined mesh to its parent cell,
+            as returned by `dolfinx.cpp.refinement.refine_plaza` (without redistribution)
+        scale
+            Float for scaling bc
+        """
+        parent_cells = numpy.asarray(parent_cells, dtype=numpy.int32)
+        if (V is self.V):
+            mpc_data = dolfinx_mpc.cpp.mpc.create_periodic_constraint_refined(
+                self.V._cpp_object, meshtag, tag, relation, bcs, scale, False,
+                parent_constraint._cpp_object, parent_cells)
+        elif self.V.contains(V):
+            mpc_data = dolfinx_mpc.cpp.mpc.create_periodic_constraint_refined(
+                V._cpp_object, meshtag, tag, relation, bcs, scale, True,
+                parent_constraint._cpp_object, parent_cells)
         else:
             raise RuntimeError("The input space has to be a sub space (or the full space) of the MPC")
         self.add_constraint_from_mpc_data(self.V, mpc_data=mpc_data)
@@ -131,7 +386,8 @@ class MultiPointConstraint():
     def create_periodic_constraint_geometrical(self, V: _fem.FunctionSpace,
                                                indicator: Callable[[numpy.ndarray], numpy.ndarray],
                                                relation: Callable[[numpy.ndarray], numpy.ndarray],
-                                               bcs: List[_fem.DirichletBCMetaClass], scale: _PETSc.ScalarType = 1):
+                                               bcs: List[_fem.DirichletBCMetaClass], scale: _PETSc.ScalarType = 1,
+                                               vertex_masters: bool = False):
         """
         Create a periodic condition for all degrees of freedom whose physical location satisfies indicator(x)
         u(x_i) = scale * u(relation(x_i)) for all x_i where indicator(x_i) == True
@@ -149,23 +405,33 @@ class MultiPointConstraint():
             (Periodic constraints will be ignored for these dofs)
         scale
             Float for scaling bc
+        vertex_masters
+            If True, only the degrees of freedom at the vertices of the master cell are used as masters,
+            with the (linear) barycentric coordinates of the mapped slave coordinate as coefficients.
+            This reduces the fill of high order spaces, at the cost of a first order accurate
+            interpolation. Only supported for scalar (or blocked scalar) Lagrange spaces on simplices.
         """
 
         if (V is self.V):
             mpc_data = dolfinx_mpc.cpp.mpc.create_periodic_constraint_geometrical(
-                self.V._cpp_object, indicator, relation, bcs, scale, False)
+                self.V._cpp_object, indicator, relation, bcs, scale, False, vertex_masters)
         elif self.V.contains(V):
             mpc_data = dolfinx_mpc.cpp.mpc.create_periodic_constraint_geometrical(
-                V._cpp_object, indicator, relation, bcs, scale, True)
+                V._cpp_object, indicator, relation, bcs, scale, True, vertex_masters)
         else:
             raise RuntimeError("The input space has to be a sub space (or the full space) of the MPC")
         self.add_constraint_from_mpc_data(self.V, mpc_data=mpc_data)
 
     def create_slip_constraint(self, space: _fem.FunctionSpace, facet_marker: tuple[_cpp.mesh.MeshTags_int32, int],
-                               v: _fem.Function, bcs: list[_fem.DirichletBCMetaClass] = []):
+                               v: _fem.Function, bcs: list[_fem.DirichletBCMetaClass] = [],
+                               dirichlet_tol: Optional[float] = None) -> List[_fem.DirichletBCMetaClass]:
         """
         Create a slip constraint dot(u, v)=0 over the entities defined in a `dolfinx.cpp.mesh.MeshTags_int32`
         marked with index i. normal is the normal vector defined as a vector function.
+        If `dirichlet_tol` is supplied, degrees of freedom where v is aligned with a coordinate axis are
+        not added to the constraint, but returned as homogeneous Dirichlet conditions on the corresponding
+        component. These conditions has to be supplied to the problem together with the other
+        Dirichlet conditions.
 
         Parameters
         ----------
@@ -177,6 +443,14 @@ class MultiPointConstraint():
             Dolfin function containing the directional vector to dot your slip condition (most commonly a normal vector)
         bcs
            List of Dirichlet BCs (slip conditions will be ignored on these dofs)
+        dirichlet_tol
+            If supplied, a block is considered axis-aligned if all but one component of v is smaller than
+            `dirichlet_tol` times the largest component
+
+        Returns
+        -------
+        List[dolfinx.fem.DirichletBCMetaClass]
+            Dirichlet conditions for the axis-aligned degrees of freedom (empty if `dirichlet_tol` is not supplied)
 
         Example
         -------
@@ -210,9 +484,18 @@ class MultiPointConstraint():
             sub_space = True
         else:
             raise ValueError("Input space has to be a sub space of the MPC space")
-        mpc_data = dolfinx_mpc.cpp.mpc.create_slip_condition(
-            space._cpp_object, facet_marker[0], facet_marker[1], v._cpp_object, bcs, sub_space)
+        if dirichlet_tol is None:
+            mpc_data = dolfinx_mpc.cpp.mpc.create_slip_condition(
+                space._cpp_object, facet_marker[0], facet_marker[1], v._cpp_object, bcs, sub_space)
+            self.add_constraint_from_mpc_data(self.V, mpc_data=mpc_data)
+            return []
+
+        mpc_data, dirichlet_dofs = dolfinx_mpc.cpp.mpc.create_slip_condition_with_dirichlet(
+            space._cpp_object, facet_marker[0], facet_marker[1], v._cpp_object, bcs, sub_space, dirichlet_tol)
         self.add_constraint_from_mpc_data(self.V, mpc_data=mpc_data)
+        zero = _PETSc.ScalarType(0)
+        return [_fem.dirichletbc(zero, numpy.asarray(dofs, dtype=numpy.int32), space.sub(i))
+                for i, dofs in enumerate(dirichlet_dofs)]
 
     def create_general_constraint(self, slave_master_dict: Dict[bytes, Dict[bytes, float]],
                                   subspace_slave: int = None, subspace_master: int = None):
@@ -244,8 +527,33 @@ class MultiPointConstraint():
             self.V, slave_master_dict, subspace_slave, subspace_master)
         self.add_constraint(self.V, slaves, masters, coeffs, owners, offsets)
 
+    def create_constraint_from_file(self, filename: str, file_format: str = "csv"):
+        """
+        Create a constraint from a file of linear constraint equations u_s = sum_i c_i u_{m_i}, where
+        the slave and masters are given as (node, component) pairs. The node is the input (file) index
+        of the geometry node of the mesh, and the component the index in the block of the function space.
+        The file is read in parallel, and requires that the degree of the function space and the mesh
+        geometry is the same.
+
+        Parameters
+        ----------
+        filename
+            The name of the file
+        file_format
+            "csv" for a text file with one equation per line,
+            `slave_node, slave_component, master_node_0, master_component_0, coefficient_0, ...`,
+            or "binary" for the format written by :func:`dolfinx_mpc.utils.write_constraint_equations`
+        """
+        formats = {"csv": dolfinx_mpc.cpp.mpc.EquationFormat.csv,
+                   "binary": dolfinx_mpc.cpp.mpc.EquationFormat.binary}
+        if file_format not in formats:
+            raise ValueError(f"Unknown file format {file_format}, expected one of {list(formats.keys())}")
+        mpc_data = dolfinx_mpc.cpp.mpc.read_constraint_equations(self.V._cpp_object, filename, formats[file_format])
+        self.add_constraint_from_mpc_data(self.V, mpc_data)
+
     def create_contact_slip_condition(self, meshtags: _cpp.mesh.MeshTags_int32, slave_marker: int, master_marker: int,
-                                      normal: _fem.Function, eps2: float = 1e-20):
+                                      normal: _fem.Function, eps2: float = 1e-20, shared_memory: bool = False,
+                                      vertex_masters: bool = False):
         """
         Create a slip condition between two sets of facets marker with individual markers.
         The interfaces should be within machine precision of eachother, but the vertices does not need to align.
@@ -264,13 +572,23 @@ class MultiPointConstraint():
             The function used in the dot-product of the constraint
         eps2
             The tolerance for the squared distance between cells to be considered as a collision
+        shared_memory
+            If True, the slave data sent to the processes with master facets is stored once per
+            shared-memory node (using MPI-3 shared memory windows) instead of once per process
+        vertex_masters
+            If True, only the degrees of freedom at the vertices of the master cell are used as masters,
+            with the (linear) barycentric coordinates of the slave coordinate as coefficients.
+            This reduces the fill of high order spaces, at the cost of a first order accurate
+            interpolation. Only supported for scalar (or blocked scalar) Lagrange spaces on simplices.
         """
         mpc_data = dolfinx_mpc.cpp.mpc.create_contact_slip_condition(
-            self.V._cpp_object, meshtags, slave_marker, master_marker, normal._cpp_object, eps2)
+            self.V._cpp_object, meshtags, slave_marker, master_marker, normal._cpp_object, eps2, shared_memory,
+            vertex_masters)
         self.add_constraint_from_mpc_data(self.V, mpc_data)
 
     def create_contact_inelastic_condition(self, meshtags: _cpp.mesh.MeshTags_int32,
-                                           slave_marker: int, master_marker: int, eps2: float = 1e-20):
+                                           slave_marker: int, master_marker: int, eps2: float = 1e-20,
+                                           shared_memory: bool = False, vertex_masters: bool = False):
         """
         Create a contact inelastic condition between two sets of facets marker with individual markers.
         The interfaces should be within machine precision of eachother, but the vertices does not need to align.
@@ -287,9 +605,70 @@ class MultiPointConstraint():
             The marker of the master facets
         eps2
             The tolerance for the squared distance between cells to be considered as a collision
+        shared_memory
+            If True, the slave data sent to the processes with master facets is stored once per
+            shared-memory node (using MPI-3 shared memory windows) instead of once per process
+        vertex_masters
+            If True, only the degrees of freedom at the vertices of the master cell are used as masters,
+            with the (linear) barycentric coordinates of the slave coordinate as coefficients.
+            This reduces the fill of high order spaces, at the cost of a first order accurate
+            interpolation. Only supported for scalar (or blocked scalar) Lagrange spaces on simplices.
         """
         mpc_data = dolfinx_mpc.cpp.mpc.create_contact_inelastic_condition(
-            self.V._cpp_object, meshtags, slave_marker, master_marker, eps2)
+            self.V._cpp_object, meshtags, slave_marker, master_marker, eps2, shared_memory, vertex_masters)
+        self.add_constraint_from_mpc_data(self.V, mpc_data)
+
+    def create_hanging_node_constraint(self, parent_facets: npt.NDArray[numpy.int32],
+                                       child_facets: npt.NDArray[numpy.int32],
+                                       bcs: Sequence[_fem.DirichletBCMetaClass] = []):
+        """
+        Create the constraints for the hanging nodes of a non-conforming mesh, where a coarse (parent) facet
+        is geometrically split into finer (child) facets that only share vertices with it.
+        The degrees of freedom on the closure of a child facet that are not on the closure of its parent facet
+        are constrained to the trace of the parent cell, i.e. u_s = sum_i phi_i(x_s) u_i, where phi_i are the
+        basis functions of the degrees of freedom on the parent facet.
+        As the parent cell of each hanging node is known from the facet pairs, no point location is required.
+        Supports Lagrange spaces of any degree (and blocked Lagrange spaces).
+
+        Parameters
+        ----------
+        parent_facets
+            The parent facets (local to process)
+        child_facets
+            The child facets (local to process), where `child_facets[i]` is contained in `parent_facets[i]`.
+            The pairs have to be given on the processes owning the hanging degrees of freedom
+        bcs
+            List of Dirichlet boundary conditions. Hanging nodes in these are not constrained
+        """
+        mpc_data = dolfinx_mpc.cpp.mpc.create_hanging_node_constraint(
+            self.V._cpp_object, numpy.asarray(parent_facets, dtype=numpy.int32),
+            numpy.asarray(child_facets, dtype=numpy.int32), bcs)
+        self.add_constraint_from_mpc_data(self.V, mpc_data)
+
+    def create_sliding_interface_constraint(self, interface, angle: float):
+        """
+        Create the constraint u_s = u_m of a sliding interface, where s stands for the restriction to the
+        slave (rotating) facets rotated by a given angle, and m to the master (fixed) facets.
+        The interface is parametrized once, so the constraint for a new angle is created without searching
+        the mesh.
+
+        Parameters
+        ----------
+        interface
+            The sliding interface (:class:`dolfinx_mpc.SlidingInterface`)
+        angle
+            The rotation angle (in radians)
+
+        Example
+        -------
+        Tie the rotor (tag 1) to the stator (tag 2) at each time step
+            interface = dolfinx_mpc.SlidingInterface(V, mt, 1, 2, origin=(0, 0, 0), axis=(0, 0, 1))
+            for t in times:
+                mpc = dolfinx_mpc.MultiPointConstraint(V)
+                mpc.create_sliding_interface_constraint(interface, omega * t)
+                mpc.finalize()
+        """
+        mpc_data = interface.create_constraint(angle)
         self.add_constraint_from_mpc_data(self.V, mpc_data)
 
     @property
@@ -0,0 +1,373 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+"""Selection of the assembly strategy for a multi point constraint based on constraint statistics"""
+
+import dataclasses
+import hashlib
+import json
+import os
+import time
+from typing import Dict, List, Optional, Sequence
+
+import cffi
+import dolfinx.fem as _fem
+import numpy
+from mpi4py import MPI
+from petsc4py import PETSc as _PETSc
+
+from dolfinx_mpc import cpp
+
+from .assemble_matrix import assemble_matrix, assemble_matrix_transformation
+from .multipointconstraint import MultiPointConstraint
+
+__all__ = ["ConstraintStatistics", "AssemblyPlan", "SparsityEstimate", "compute_constraint_statistics",
+           "estimate_sparsity", "plan_assembly", "assemble_matrix_from_plan"]
+
+#: Strategies that can be selected by the planner
+STRATEGIES = ("cellwise", "transformation")
+
+#: If more than this fraction of the cells contains a slave, the explicit K^T A K product is preferred
+SLAVE_CELL_FRACTION_THRESHOLD = 0.25
+
+#: If the slaves have more masters than this on average, the explicit K^T A K product is preferred
+MASTERS_PER_SLAVE_THRESHOLD = 8.0
+
+#: If more than this fraction of the masters is owned by another process, the explicit K^T A K product
+#: is preferred, as the cellwise assembly has to extend the ghost layer with every off-process master
+OFF_PROCESS_MASTER_THRESHOLD = 0.5
+
+
+@dataclasses.dataclass
+class ConstraintStatistics:
+    """Global statistics of a (finalized) multi point constraint"""
+    num_dofs: int
+    num_slaves: int
+    num_masters: int
+    num_cells: int
+    num_slave_cells: int
+    num_processes: int
+    slave_fraction: float
+    slave_cell_fraction: float
+    off_process_master_fraction: float
+    masters_per_slave_min: int
+    masters_per_slave_max: int
+    masters_per_slave_mean: float
+    masters_per_slave_histogram: List[int]
+    is_dof_identification: bool
+
+
+@dataclasses.dataclass
+class SparsityEstimate:
+    """Predicted size of the matrix of a bilinear form with multi point constraints
+
+    Attributes
+    ----------
+    num_rows
+        Global number of (block) rows
+    block_size
+        Block size of the rows and columns
+    nonzeros
+        Global number of nonzero blocks
+    master_nonzeros
+        Global number of nonzero blocks added by the couplings to the masters
+    nonzeros_per_row_min
+        Minimal number of nonzero blocks in a row
+    nonzeros_per_row_max
+        Maximal number of nonzero blocks in a row
+    nonzeros_per_row_mean
+        Average number of nonzero blocks in a row
+    num_off_process_rows
+        Global number of rows with entries that are sent to the owning process during assembly
+    memory
+        Memory (in bytes) of the values, column indices and row offsets of a PETSc AIJ matrix
+    """
+    num_rows: int
+    block_size: List[int]
+    nonzeros: int
+    master_nonzeros: int
+    nonzeros_per_row_min: int
+    nonzeros_per_row_max: int
+    nonzeros_per_row_mean: float
+    num_off_process_rows: int
+    memory: int
+
+
+@dataclasses.dataclass
+class AssemblyPlan:
+    """The assembly strategy selected for a form and multi point constraint
+
+    Attributes
+    ----------
+    strategy
+        One of "cellwise" (modification of the element matrices of cells with slaves) or "transformation"
+        (explicit product K^T A K of the unconstrained matrix with the transformation matrix)
+    statistics
+        The constraint statistics the choice is based on
+    timings
+        Assembly time (max over processes, min over probes) for each probed strategy
+    signature
+        Description of the problem the plan was made for. A cached plan is only reused if the signature matches.
+    """
+    strategy: str
+    statistics: ConstraintStatistics
+    timings: Dict[str, float]
+    signature: Dict[str, object]
+
+    def save(self, filename: str, comm: MPI.Intracomm = MPI.COMM_WORLD):
+        """Write the plan to a JSON file (on the root process)"""
+        if comm.rank == 0:
+            with open(filename, "w") as f:
+                json.dump(dataclasses.asdict(self), f, indent=2)
+        comm.barrier()
+
+    @classmethod
+    def load(cls, filename: str, comm: MPI.Intracomm = MPI.COMM_WORLD) -> "AssemblyPlan":
+        """Read a plan from a JSON file (on the root process) and distribute it to all processes"""
+        data = None
+        if comm.rank == 0:
+            with open(filename, "r") as f:
+                data = json.load(f)
+        data = comm.bcast(data, root=0)
+        data["statistics"] = ConstraintStatistics(**data["statistics"])
+        return cls(**data)
+
+
+def compute_constraint_statistics(constraint: MultiPointConstraint) -> ConstraintStatistics:
+    """
+    Compute global statistics of a finalized multi point constraint.
+
+    Parameters
+    ----------
+    constraint
+        The multi point constraint
+
+    Returns
+    -------
+    ConstraintStatistics
+        The slave fraction, the distribution of the number of masters per slave, the fraction of masters
+        owned by other processes and the fraction of cells containing a slave
+    """
+    V = constraint.function_space
+    comm = V.mesh.comm
+    bs = V.dofmap.index_map_bs
+    num_owned = V.dofmap.index_map.size_local * bs
+
+    # Masters and coefficients of the slaves owned by the process
+    slaves = numpy.asarray(constraint.slaves[:constraint.num_local_slaves], dtype=numpy.int32)
+    masters = constraint.masters
+    coeffs, _ = constraint.coefficients()
+    starts = masters.offsets[slaves]
+    num_masters = masters.offsets[slaves + 1] - starts
+    positions = numpy.repeat(starts - numpy.cumsum(num_masters) + num_masters, num_masters) \
+        + numpy.arange(num_masters.sum())
+    local_masters = masters.array[positions]
+    num_off_process = numpy.count_nonzero(local_masters >= num_owned)
+    identification = bool(numpy.all(num_masters == 1) and numpy.allclose(coeffs[positions], 1))
+
+    # Cells (owned by the process) with at least one slave
+    tdim = V.mesh.topology.dim
+    num_cells = V.mesh.topology.index_map(tdim).size_local
+    num_slave_cells = numpy.count_nonzero(numpy.diff(constraint.cell_to_slaves.offsets)[:num_cells])
+
+    sums = comm.allreduce(numpy.array([len(slaves), num_masters.sum(), num_off_process, num_cells,
+                                       num_slave_cells], dtype=numpy.int64), op=MPI.SUM)
+    min_masters = comm.allreduce(num_masters.min() if len(slaves) > 0 else numpy.iinfo(numpy.int32).max,
+                                 op=MPI.MIN)
+    max_masters = comm.allreduce(num_masters.max() if len(slaves) > 0 else 0, op=MPI.MAX)
+    histogram = numpy.bincount(num_masters, minlength=max_masters + 1)
+    histogram = comm.allreduce(histogram, op=MPI.SUM)
+    identification = comm.allreduce(identification, op=MPI.LAND)
+
+    num_slaves, num_masters_global, num_off_process, num_cells, num_slave_cells = (int(s) for s in sums)
+    num_dofs = V.dofmap.index_map.size_global * bs
+    return ConstraintStatistics(
+        num_dofs=num_dofs, num_slaves=num_slaves, num_masters=num_masters_global, num_cells=num_cells,
+        num_slave_cells=num_slave_cells, num_processes=comm.size,
+        slave_fraction=num_slaves / max(num_dofs, 1),
+        slave_cell_fraction=num_slave_cells / max(num_cells, 1),
+        off_process_master_fraction=num_off_process / max(num_masters_global, 1),
+        masters_per_slave_min=int(min_masters) if num_slaves > 0 else 0,
+        masters_per_slave_max=int(max_masters),
+        masters_per_slave_mean=num_masters_global / max(num_slaves, 1),
+        masters_per_slave_histogram=[int(h) for h in histogram],
+        is_dof_identification=identification and num_slaves > 0)
+
+
+def estimate_sparsity(form: _fem.FormMetaClass, constraint: MultiPointConstraint) -> SparsityEstimate:
+    """
+    Predict the size of the matrix of a bilinear form with a multi point constraint, without creating
+    the sparsity pattern.
+
+    The couplings added by the constraint are found from the cells containing slaves only. Interior facet
+    integrals couple the dofs of the two cells of each interior facet. Forms with exterior facet integrals
+    are counted as if every cell had an exterior facet, and rows shared between processes are counted on each
+    process, so the estimate is an upper bound in these cases.
+
+    Parameters
+    ----------
+    form
+        The compiled bilinear form
+    constraint
+        The (finalized) multi point constraint
+
+    Returns
+    -------
+    SparsityEstimate
+        The predicted number of nonzeros and memory usage
+    """
+    estimate = cpp.mpc.estimate_sparsity(form, constraint._cpp_object, constraint._cpp_object)
+    V = constraint.function_space
+    comm = V.mesh.comm
+    bs = [space.dofmap.index_map_bs for space in form.function_spaces]
+    nnz = numpy.asarray(estimate.row_nonzeros, dtype=numpy.int64)
+
+    sums = comm.allreduce(numpy.array([len(nnz), estimate.standard_nonzeros, estimate.master_nonzeros,
+                                       estimate.num_off_process_rows], dtype=numpy.int64), op=MPI.SUM)
+    num_rows, standard_nonzeros, master_nonzeros, num_off_process_rows = (int(s) for s in sums)
+    nnz_min = comm.allreduce(nnz.min() if len(nnz) > 0 else numpy.iinfo(numpy.int32).max, op=MPI.MIN)
+    nnz_max = comm.allreduce(nnz.max() if len(nnz) > 0 else 0, op=MPI.MAX)
+    nonzeros = standard_nonzeros + master_nonzeros
+
+    # Values and column indices of each unrolled entry, and the row offsets
+    int_size = numpy.dtype(_PETSc.IntType).itemsize
+    scalar_size = numpy.dtype(_PETSc.ScalarType).itemsize
+    memory = nonzeros * bs[0] * bs[1] * (scalar_size + int_size) + (num_rows * bs[0] + 1) * int_size
+
+    return SparsityEstimate(
+        num_rows=num_rows, block_size=bs, nonzeros=nonzeros, master_nonzeros=master_nonzeros,
+        nonzeros_per_row_min=int(nnz_min) if num_rows > 0 else 0, nonzeros_per_row_max=int(nnz_max),
+        nonzeros_per_row_mean=nonzeros / max(num_rows, 1), num_off_process_rows=num_off_process_rows,
+        memory=memory)
+
+
+def _select_strategy(statistics: ConstraintStatistics) -> str:
+    """Select a strategy from the constraint statistics"""
+    if (statistics.slave_cell_fraction > SLAVE_CELL_FRACTION_THRESHOLD
+            or statistics.masters_per_slave_mean > MASTERS_PER_SLAVE_THRESHOLD
+            or statistics.off_process_master_fraction > OFF_PROCESS_MASTER_THRESHOLD):
+        return "transformation"
+    return "cellwise"
+
+
+def _form_signature(form: _fem.FormMetaClass) -> Dict[str, object]:
+    """Return the integral types and ids of a compiled form, and a hash of its UFL signature"""
+    integrals = {integral_type.name: sorted(int(i) for i in form.integral_ids(integral_type))
+                 for integral_type in sorted(form.integral_types, key=lambda t: t.name)}
+    ufl_signature = cffi.FFI().string(form.ufcx_form.signature)
+    return {"integrals": integrals, "ufl_signature": hashlib.sha256(ufl_signature).hexdigest()}
+
+
+def _time_assembly(comm: MPI.Intracomm, assemble, num_probes: int) -> float:
+    """Return the minimum over the probes of the maximum assembly time over all processes"""
+    timings = []
+    for _ in range(num_probes):
+        comm.barrier()
+        start = time.perf_counter()
+        A = assemble()
+        end = time.perf_counter()
+        A.destroy()
+        timings.append(comm.allreduce(end - start, op=MPI.MAX))
+    return min(timings)
+
+
+def plan_assembly(form: _fem.FormMetaClass, constraint: MultiPointConstraint,
+                  bcs: Sequence[_fem.DirichletBCMetaClass] = [], probe: bool = False, num_probes: int = 3,
+                  cache: Optional[str] = None) -> AssemblyPlan:
+    """
+    Select the assembly strategy for a bilinear form with a multi point constraint.
+
+    The choice is made from the statistics of the constraint (see `compute_constraint_statistics`).
+    The explicit product K^T A K ("transformation") is selected if many cells contain slaves, if the
+    slaves have many masters or if most masters are owned by other processes, and the cellwise
+    modification of the element matrices ("cellwise") is selected else.
+
+    Pure identifications of degrees of freedom (`ConstraintStatistics.is_dof_identification`) are better
+    handled without a constraint, see `MultiPointConstraint.create_identified_space`. As the identified
+    space has to be created before the constraint is finalized, this is not a strategy of the plan.
+    If `probe` is True, the "cellwise" and "transformation" assemblies are timed, and the fastest is
+    selected.
+
+    Parameters
+    ----------
+    form
+        The compiled bilinear form
+    constraint
+        The (finalized) multi point constraint
+    bcs
+        The Dirichlet boundary conditions
+    probe
+        If True, time the assembly with each strategy
+    num_probes
+        Number of timed assemblies per strategy
+    cache
+        JSON file where the plan is stored. If the file exists and was written for a problem with the same
+        signature (number of dofs, slaves, masters, cells and processes, element, and the integral types
+        and ids and UFL signature of the form), the stored plan is returned. Otherwise a new plan is made
+        and written to the file.
+
+    Returns
+    -------
+    AssemblyPlan
+        The selected strategy
+    """
+    V = constraint.function_space
+    comm = V.mesh.comm
+    statistics = compute_constraint_statistics(constraint)
+    signature = {"num_dofs": statistics.num_dofs, "num_slaves": statistics.num_slaves,
+                 "num_masters": statistics.num_masters, "num_cells": statistics.num_cells,
+                 "num_processes": statistics.num_processes, "element": str(V.ufl_element()),
+                 "form": _form_signature(form)}
+
+    if cache is not None and comm.bcast(os.path.isfile(cache) if comm.rank == 0 else None, root=0):
+        plan = AssemblyPlan.load(cache, comm)
+        if plan.signature == signature:
+            return plan
+
+    strategy = _select_strategy(statistics)
+    timings: Dict[str, float] = {}
+    if probe:
+        timings["cellwise"] = _time_assembly(
+            comm, lambda: assemble_matrix(form, constraint, bcs=bcs), num_probes)
+        timings["transformation"] = _time_assembly(
+            comm, lambda: assemble_matrix_transformation(form, constraint, bcs=bcs), num_probes)
+        strategy = min(timings, key=timings.get)
+
+    plan = AssemblyPlan(strategy=strategy, statistics=statistics, timings=timings, signature=signature)
+    if cache is not None:
+        plan.save(cache, comm)
+    return plan
+
+
+def assemble_matrix_from_plan(plan: AssemblyPlan, form: _fem.FormMetaClass, constraint: MultiPointConstraint,
+                              bcs: Sequence[_fem.DirichletBCMetaClass] = [],
+                              diagval: _PETSc.ScalarType = 1) -> _PETSc.Mat:
+    """
+    Assemble a bilinear form with a multi point constraint using the strategy of a plan.
+
+    Parameters
+    ----------
+    plan
+        The assembly plan
+    form
+        The compiled bilinear form
+    constraint
+        The (finalized) multi point constraint
+    bcs
+        The Dirichlet boundary conditions
+    diagval
+        Value to set on the diagonal of the matrix for slaves and Dirichlet dofs
+
+    Returns
+    -------
+    PETSc.Mat
+        The assembled matrix
+    """
+    if plan.strategy == "cellwise":
+        return assemble_matrix(form, constraint, bcs=bcs, diagval=diagval)
+    elif plan.strategy == "transformation":
+        return assemble_matrix_transformation(form, constraint, bcs=bcs, diagval=diagval)
+    else:
+        raise ValueError(f"Unknown strategy {plan.strategy}, expected one of {STRATEGIES}")
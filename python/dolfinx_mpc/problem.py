@@ -95,6 +95,7 @@ class LinearProblem(_fem.petsc.LinearProblem):
         self._b = _cpp.la.petsc.create_vector(self._mpc.function_space.dofmap.index_map,
                                               self._mpc.function_space.dofmap.index_map_bs)
         self.bcs = [] if bcs is None else bcs
+        self._classification = self._mpc.create_dof_classification(self._a.function_spaces[0], self.bcs)
 
         self._solver = PETSc.KSP().create(self.u.function_space.mesh.comm)
         self._solver.setOperators(self._A)
@@ -117,7 +118,7 @@ class LinearProblem(_fem.petsc.LinearProblem):
 
         # Assemble lhs
         self._A.zeroEntries()
-        assemble_matrix(self._a, self._mpc, bcs=self.bcs, A=self._A)
+        assemble_matrix(self._a, self._mpc, A=self._A, classification=self._classification)
         self._A.assemble()
         assert self._A.assembled
 
@@ -127,7 +128,7 @@ class LinearProblem(_fem.petsc.LinearProblem):
         assemble_vector(self._L, self._mpc, b=self._b)
 
         # Apply boundary conditions to the rhs
-        apply_lifting(self._b, [self._a], [self.bcs], self._mpc)
+        apply_lifting(self._b, [self._a], [self.bcs], self._mpc, classifications=[self._classification])
         self._b.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
         _fem.petsc.set_bc(self._b, self.bcs)
 
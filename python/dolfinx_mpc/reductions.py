@@ -0,0 +1,114 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+"""Inner products and norms of vectors on the space constrained by a multi point constraint"""
+
+from typing import Sequence
+
+import dolfinx.cpp as _cpp
+import dolfinx.fem as _fem
+from dolfinx.common import Timer
+from petsc4py import PETSc as _PETSc
+
+import dolfinx_mpc.cpp
+
+from .multipointconstraint import MultiPointConstraint
+
+__all__ = ["inner_product", "norm", "assemble_residual"]
+
+
+def inner_product(x: _PETSc.Vec, y: _PETSc.Vec, constraint: MultiPointConstraint,
+                  condense: bool = False) -> _PETSc.ScalarType:
+    """
+    Compute the inner product of two vectors on the constrained space.
+
+    Parameters
+    ----------
+    x
+        The first vector
+    y
+        The second vector
+    constraint
+        The multi point constraint
+    condense
+        If False, the slave entries are skipped, which is the inner product of vectors assembled with the
+        constraint. If True, the slave entries are moved to their masters, i.e. the inner product of
+        :math:`K^T x` and :math:`K^T y` is computed, which is the restriction of unconstrained (dual) vectors
+        to the constrained space.
+
+    Returns
+    -------
+    PETSc.ScalarType
+        The inner product :math:`\\sum_i \\overline{x_i} y_i`
+    """
+    with x.localForm() as x_local, y.localForm() as y_local:
+        return dolfinx_mpc.cpp.mpc.inner_product(x_local.array_r, y_local.array_r, constraint._cpp_object,
+                                                 condense)
+
+
+def norm(x: _PETSc.Vec, constraint: MultiPointConstraint, norm_type: _cpp.la.Norm = _cpp.la.Norm.l2,
+         condense: bool = False) -> float:
+    """
+    Compute the norm of a vector on the constrained space.
+
+    Parameters
+    ----------
+    x
+        The vector
+    constraint
+        The multi point constraint
+    norm_type
+        The norm type (l1, l2 or linf)
+    condense
+        If False, the slave entries are skipped. If True, the norm of :math:`K^T x` is computed, see
+        :func:`inner_product`.
+
+    Returns
+    -------
+    float
+        The norm
+    """
+    with x.localForm() as x_local:
+        return dolfinx_mpc.cpp.mpc.norm(x_local.array_r, constraint._cpp_object, norm_type, condense)
+
+
+def assemble_residual(F: _fem.FormMetaClass, J: _fem.FormMetaClass, constraint: MultiPointConstraint,
+                      x: _PETSc.Vec, b: _PETSc.Vec, bcs: Sequence[_fem.DirichletBCMetaClass] = [],
+                      norm_type: _cpp.la.Norm = _cpp.la.Norm.l2) -> float:
+    """
+    Assemble the residual of a nonlinear problem with a multi point constraint into `b`, and compute
+    its norm on the constrained space.
+
+    The residual is assembled, lifted with the Jacobian and the Dirichlet conditions (relative to `x`),
+    accumulated on the owning processes and the Dirichlet dofs are set, as in the residual of a Newton
+    solver. The norm of the owned entries that are not slaves is then computed in one pass over the owned
+    entries, with a single reduction over the processes. Both `x` and `b` have to be ghosted.
+
+    Parameters
+    ----------
+    F
+        The residual form
+    J
+        The Jacobian form
+    constraint
+        The multi point constraint
+    x
+        The current solution
+    b
+        The vector to assemble the residual into (created on the space of the constraint)
+    bcs
+        The Dirichlet boundary conditions
+    norm_type
+        The norm type (l1, l2 or linf)
+
+    Returns
+    -------
+    float
+        The norm of the residual
+    """
+    t = Timer("~MPC: Assemble residual (C++)")
+    value = dolfinx_mpc.cpp.mpc.assemble_residual(b, F, J, bcs, x, constraint._cpp_object, norm_type)
+    t.stop()
+    return value
@@ -0,0 +1,70 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+from typing import Sequence
+
+import dolfinx.cpp as _cpp
+import dolfinx.fem as _fem
+
+import dolfinx_mpc.cpp
+
+
+class SlidingInterface():
+    """
+    A sliding (rotor-stator) interface between a rotating and a fixed part of a mesh with coinciding
+    cylindrical (or circular in 2D) interfaces. The master facets are parametrized once by their angle and
+    axial position with respect to the rotation axis, such that the constraint for a new rotation angle is
+    created without searching the mesh (see
+    :func:`dolfinx_mpc.MultiPointConstraint.create_sliding_interface_constraint`).
+    The parametrized master interface is replicated on every process, as a rotation can map a slave to any
+    master facet, so the memory per process grows with the size of the interface.
+    Only supported for first order Lagrange spaces (or blocked first order spaces, where each component of the
+    slave is tied to the same component of the masters) with interval (2D) or triangular (3D) facets.
+
+    Parameters
+    ----------
+    V
+        The function space
+    meshtags
+        The meshtags of the interface facets
+    slave_marker
+        The marker of the facets on the rotating side
+    master_marker
+        The marker of the facets on the fixed side
+    origin
+        A point on the rotation axis
+    axis
+        The direction of the rotation axis. The rotation angle is positive in the counter-clockwise
+        direction around the axis
+    tol
+        The tolerance on the barycentric coordinates (in the angle-axial parameter space) of a slave inside
+        a master facet
+    """
+
+    def __init__(self, V: _fem.FunctionSpace, meshtags: _cpp.mesh.MeshTags_int32, slave_marker: int,
+                 master_marker: int, origin: Sequence[float] = (0, 0, 0), axis: Sequence[float] = (0, 0, 1),
+                 tol: float = 1e-10):
+        self.V = V
+        self._cpp_object = dolfinx_mpc.cpp.mpc.SlidingInterface(
+            V._cpp_object, meshtags, slave_marker, master_marker, origin, axis, tol)
+
+    def create_constraint(self, angle: float) -> dolfinx_mpc.cpp.mpc.mpc_data:
+        """
+        Create the constraint data for a rotation of the slave side
+
+        Parameters
+        ----------
+        angle
+            The rotation angle (in radians)
+        """
+        return self._cpp_object.create_constraint(angle)
+
+    @property
+    def num_master_facets(self) -> int:
+        """
+        Returns the number of master facets (on all processes)
+        """
+        return self._cpp_object.num_master_facets
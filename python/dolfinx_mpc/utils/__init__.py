@@ -13,11 +13,12 @@ from .test import (compare_CSR, compare_mpc_lhs, compare_mpc_rhs,
 from .mpc_utils import (create_normal_approximation,
                         create_point_to_point_constraint, determine_closest_block,
                         facet_normal_approximation, log_info,
-                        rigid_motions_nullspace, rotation_matrix)
+                        rigid_motions_nullspace, rotation_matrix,
+                        write_constraint_equations)
 
 __all__ = ["get_assemblers", "gather_PETScVector", "gather_PETScMatrix", "compare_mpc_lhs",
            "compare_mpc_rhs", "gather_transformation_matrix", "compare_CSR", "gather_constants",
            "rotation_matrix", "facet_normal_approximation",
            "log_info", "rigid_motions_nullspace",
            "determine_closest_block", "create_normal_approximation",
-           "create_point_to_point_constraint"]
+           "create_point_to_point_constraint", "write_constraint_equations"]
@@ -20,7 +20,8 @@ from mpi4py import MPI
 from petsc4py import PETSc
 
 __all__ = ["rotation_matrix", "facet_normal_approximation", "log_info", "rigid_motions_nullspace",
-           "determine_closest_block", "create_normal_approximation", "create_point_to_point_constraint"]
+           "determine_closest_block", "create_normal_approximation", "create_point_to_point_constraint",
+           "write_constraint_equations"]
 
 
 def rotation_matrix(axis, angle):
@@ -427,3 +428,41 @@ def create_normal_approximation(V: _fem.FunctionSpace, mt: _cpp.mesh.MeshTags_in
     n_cpp = dolfinx_mpc.cpp.mpc.create_normal_approximation(V._cpp_object, mt.dim, mt.find(value))
     nh._cpp_object = n_cpp
     return nh
+
+
+def write_constraint_equations(filename: str, slave_nodes, slave_components, offsets, master_nodes,
+                               master_components, coefficients):
+    """
+    Write linear constraint equations u_s = sum_i c_i u_{m_i} to a binary file that can be read with
+    :func:`dolfinx_mpc.MultiPointConstraint.create_constraint_from_file`. Should only be called on a single process.
+
+    Parameters
+    ----------
+    filename
+        The name of the file
+    slave_nodes
+        The input index of the geometry node of each slave
+    slave_components
+        The component (in the block) of each slave
+    offsets
+        The masters of the ith slave are in [offsets[i], offsets[i+1])
+    master_nodes
+        The input index of the geometry node of each master
+    master_components
+        The component (in the block) of each master
+    coefficients
+        The coefficient of each master
+    """
+    offsets = np.asarray(offsets, dtype=np.int64)
+    num_equations = len(offsets) - 1
+    num_terms = offsets[-1]
+    assert len(slave_nodes) == num_equations and len(slave_components) == num_equations
+    assert len(master_nodes) == num_terms and len(master_components) == num_terms and len(coefficients) == num_terms
+    with open(filename, "wb") as f:
+        f.write(np.array([num_equations, num_terms], dtype=np.int64).tobytes())
+        f.write(offsets.tobytes())
+        f.write(np.asarray(slave_nodes, dtype=np.int64).tobytes())
+        f.write(np.asarray(slave_components, dtype=np.int32).tobytes())
+        f.write(np.asarray(master_nodes, dtype=np.int64).tobytes())
+        f.write(np.asarray(master_components, dtype=np.int32).tobytes())
+        f.write(np.asarray(coefficients, dtype=np.float64).tobytes())
@@ -0,0 +1,80 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+#
+# Shared fixtures for tests of periodic constraints on the unit square, where
+# the dofs on the right boundary (x=1) are tied to the left boundary (x=0).
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+from dolfinx import fem
+from dolfinx.mesh import create_unit_square, locate_entities_boundary, meshtags
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+def periodic_relation(x):
+    out_x = np.copy(x)
+    out_x[0] = 1 - x[0]
+    return out_x
+
+
+@pytest.fixture
+def periodic_constraint():
+    """
+    Factory creating a (finalized) topological periodic constraint of a function space on the unit square,
+    with the slaves on x=1 (marked with 2), and the master coordinates given by `relation`
+    """
+    def create(V, bcs=None, relation=periodic_relation, scale=1):
+        mesh = V.mesh
+        fdim = mesh.topology.dim - 1
+        facets = locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[0], 1))
+        mt = meshtags(mesh, fdim, np.sort(facets), np.full(len(facets), 2, dtype=np.int32))
+        mpc = dolfinx_mpc.MultiPointConstraint(V)
+        mpc.create_periodic_constraint_topological(V, mt, 2, relation, [] if bcs is None else bcs,
+                                                   PETSc.ScalarType(scale))
+        mpc.finalize()
+        return mpc
+    return create
+
+
+@pytest.fixture
+def bottom_bc():
+    """
+    Factory creating a Dirichlet condition on the bottom (y=0) of the unit square. The value is either a
+    constant (zero by default) or a function in the space
+    """
+    def create(V, value=None):
+        mesh = V.mesh
+        fdim = mesh.topology.dim - 1
+        facets = locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[1], 0))
+        dofs = fem.locate_dofs_topological(V, fdim, facets)
+        if isinstance(value, fem.Function):
+            return fem.dirichletbc(value, dofs)
+        if value is None:
+            bs = V.dofmap.index_map_bs
+            value = np.zeros(bs, dtype=PETSc.ScalarType) if bs > 1 else 0
+        return fem.dirichletbc(PETSc.ScalarType(value) if np.isscalar(value) else value, dofs, V)
+    return create
+
+
+@pytest.fixture
+def periodic_square(periodic_constraint, bottom_bc):
+    """
+    Factory creating a unit square with `nx` x `ny` cells, a Lagrange space of a given degree, a Dirichlet
+    condition on y=0 and the periodic constraint of x=1 onto x=0. Returns the space, the constraint and
+    the Dirichlet conditions
+    """
+    def create(nx, ny, degree=1, vector=False, bc_value=None, scale=1):
+        mesh = create_unit_square(MPI.COMM_WORLD, nx, ny)
+        if vector:
+            V = fem.VectorFunctionSpace(mesh, ("Lagrange", degree))
+        else:
+            V = fem.FunctionSpace(mesh, ("Lagrange", degree))
+        bc = bottom_bc(V, bc_value)
+        mpc = periodic_constraint(V, [bc], scale=scale)
+        return V, mpc, [bc]
+    return create
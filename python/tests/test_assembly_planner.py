@@ -0,0 +1,109 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import fem
+from dolfinx.mesh import create_unit_square
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+@pytest.fixture
+def periodic_problem(periodic_square):
+    def create(scale):
+        V, mpc, bcs = periodic_square(8, 6, degree=2, scale=scale)
+        u = ufl.TrialFunction(V)
+        v = ufl.TestFunction(V)
+        a = fem.form(ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx)
+        return a, mpc, bcs
+    return create
+
+
+@pytest.mark.parametrize("scale", [1, 2])
+def test_statistics(periodic_problem, scale):
+    a, mpc, bcs = periodic_problem(scale)
+    statistics = dolfinx_mpc.compute_constraint_statistics(mpc)
+    assert statistics.num_slaves > 0
+    assert statistics.masters_per_slave_min == 1
+    assert statistics.masters_per_slave_max == 1
+    assert statistics.masters_per_slave_histogram[1] == statistics.num_slaves
+    assert statistics.is_dof_identification == (scale == 1)
+    assert 0 < statistics.slave_cell_fraction < 1
+
+    plan = dolfinx_mpc.plan_assembly(a, mpc, bcs)
+    assert plan.strategy in ("cellwise", "transformation")
+
+
+def test_transformation_assembly(periodic_problem):
+    a, mpc, bcs = periodic_problem(2)
+    A = dolfinx_mpc.assemble_matrix(a, mpc, bcs=bcs)
+    A_KTAK = dolfinx_mpc.assemble_matrix_transformation(a, mpc, bcs=bcs)
+    A_KTAK.axpy(-1, A, structure=PETSc.Mat.Structure.DIFFERENT_NONZERO_PATTERN)
+    assert np.isclose(A_KTAK.norm(PETSc.NormType.FROBENIUS), 0, atol=1e-10)
+
+
+def test_transformation_assembly_master_bc():
+    # Dirichlet condition on part of the master boundary
+    mesh = create_unit_square(MPI.COMM_WORLD, 8, 6)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 2))
+
+    def periodic_relation(x):
+        out_x = np.copy(x)
+        out_x[0] = x[0] - 1
+        return out_x
+
+    bc_dofs = fem.locate_dofs_geometrical(V, lambda x: np.isclose(x[0], 0) & (x[1] < 0.5 + 1e-10))
+    bc = fem.dirichletbc(PETSc.ScalarType(0), bc_dofs, V)
+
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    mpc.create_periodic_constraint_geometrical(V, lambda x: np.isclose(x[0], 1), periodic_relation, [],
+                                               PETSc.ScalarType(2))
+    mpc.finalize()
+
+    # Check that some masters are Dirichlet dofs
+    masters = mpc.masters
+    num_owned = V.dofmap.index_map.size_local
+    owned_bc_dofs = bc.dof_indices()[0][:bc.dof_indices()[1]]
+    local_masters = np.hstack([masters.links(slave) for slave in mpc.slaves[:mpc.num_local_slaves]]
+                              + [np.empty(0, dtype=np.int32)])
+    num_bc_masters = np.count_nonzero(np.isin(local_masters[local_masters < num_owned], owned_bc_dofs))
+    assert MPI.COMM_WORLD.allreduce(num_bc_masters, op=MPI.SUM) > 0
+
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    a = fem.form(ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx)
+    A = dolfinx_mpc.assemble_matrix(a, mpc, bcs=[bc], diagval=3)
+    A_KTAK = dolfinx_mpc.assemble_matrix_transformation(a, mpc, bcs=[bc], diagval=3)
+    A_KTAK.axpy(-1, A, structure=PETSc.Mat.Structure.DIFFERENT_NONZERO_PATTERN)
+    assert np.isclose(A_KTAK.norm(PETSc.NormType.FROBENIUS), 0, atol=1e-10)
+
+
+def test_cached_plan(periodic_problem, tmp_path):
+    a, mpc, bcs = periodic_problem(2)
+    cache = MPI.COMM_WORLD.bcast(str(tmp_path / "plan.json"), root=0)
+    plan = dolfinx_mpc.plan_assembly(a, mpc, bcs, probe=True, num_probes=1, cache=cache)
+    assert plan.strategy in ("cellwise", "transformation")
+    assert set(plan.timings.keys()) == {"cellwise", "transformation"}
+
+    # Plan is reused without probing
+    cached_plan = dolfinx_mpc.plan_assembly(a, mpc, bcs, cache=cache)
+    assert cached_plan.strategy == plan.strategy
+    assert cached_plan.timings == plan.timings
+
+    A = dolfinx_mpc.assemble_matrix_from_plan(cached_plan, a, mpc, bcs)
+    assert A.getSize()[0] == mpc.function_space.dofmap.index_map.size_global
+
+    # A plan cached for another form on the same space is not reused
+    V = mpc.function_space
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    a_mass = fem.form(ufl.inner(u, v) * ufl.dx)
+    mass_plan = dolfinx_mpc.plan_assembly(a_mass, mpc, bcs, cache=cache)
+    assert mass_plan.signature != plan.signature
+    assert mass_plan.timings == {}
@@ -0,0 +1,77 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import fem
+from dolfinx.mesh import create_unit_square
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+def translation(x):
+    out_x = np.copy(x)
+    out_x[0] = x[0] - 1
+    return out_x
+
+
+def reflection(x):
+    out_x = np.copy(x)
+    out_x[0] = 1 - x[0]
+    out_x[1] = 1 - x[1]
+    return out_x
+
+
+def create_mesh(amplitude):
+    """Unit square where the vertical coordinate is shifted proportionally to the horizontal coordinate,
+    such that the mapped slave coordinates on x=1 are not vertices of the boundary x=0"""
+    mesh = create_unit_square(MPI.COMM_SELF, 7, 5)
+    x = mesh.geometry.x
+    x[:, 1] += amplitude * np.sin(np.pi * x[:, 1]) * x[:, 0]
+    return mesh
+
+
+@pytest.mark.parametrize("relation", [translation, reflection])
+@pytest.mark.parametrize("degree", [1, 2])
+def test_clone_constraint(periodic_constraint, degree, relation):
+    # Reference mesh and a mesh with the same topology and different coordinates. The mapped slave
+    # coordinates lie in the same master cells on both meshes, at different positions
+    mesh_ref = create_mesh(0.03)
+    mesh = create_mesh(0.06)
+    V_ref = fem.FunctionSpace(mesh_ref, ("Lagrange", degree))
+    mpc_ref = periodic_constraint(V_ref, relation=relation)
+
+    V = fem.FunctionSpace(mesh, ("Lagrange", degree))
+    mpc = mpc_ref.clone(V, relation)
+    mpc_exact = periodic_constraint(V, relation=relation)
+
+    # The coefficients depend on the coordinates
+    assert not np.allclose(mpc_ref.coefficients()[0], mpc_exact.coefficients()[0])
+
+    assert np.allclose(mpc.slaves, mpc_exact.slaves)
+    assert np.allclose(mpc.masters.array, mpc_exact.masters.array)
+    assert np.allclose(mpc.coefficients()[0], mpc_exact.coefficients()[0])
+
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    a = fem.form(ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx)
+    A = dolfinx_mpc.assemble_matrix(a, mpc)
+    A_exact = dolfinx_mpc.assemble_matrix(a, mpc_exact)
+    A.axpy(-1, A_exact)
+    assert np.isclose(A.norm(PETSc.NormType.FROBENIUS), 0, atol=1e-12)
+
+
+def test_clone_copy_coefficients(periodic_constraint):
+    # Without a relation, the coefficients are copied
+    mesh_ref = create_mesh(0.03)
+    mesh = create_mesh(0.06)
+    mpc_ref = periodic_constraint(fem.FunctionSpace(mesh_ref, ("Lagrange", 1)), relation=translation)
+    mpc = mpc_ref.clone(fem.FunctionSpace(mesh, ("Lagrange", 1)))
+    assert np.allclose(mpc.slaves, mpc_ref.slaves)
+    assert np.allclose(mpc.masters.array, mpc_ref.masters.array)
+    assert np.allclose(mpc.coefficients()[0], mpc_ref.coefficients()[0])
@@ -0,0 +1,106 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+#
+# Inelastic contact between two tetrahedral boxes with non-matching meshes at the interface,
+# with all master cell dofs and with only the vertex dofs as masters.
+
+import dolfinx.fem as fem
+import dolfinx_mpc
+import numpy as np
+import ufl
+from dolfinx.mesh import (CellType, compute_midpoints, create_box, create_mesh,
+                          locate_entities, meshtags)
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+def create_tet_boxes(comm):
+    """
+    Create the boxes [0,1]x[0,1]x[0,1] and [0,1]x[0,1]x[1,2] with different resolution in each box,
+    and mark the bottom (5) and top (3) boundary, and the bottom (4) and top (9) side of the interface z=1.
+    """
+    if comm.rank == 0:
+        cells, points = [], []
+        offset = 0
+        for z0, n in [(0, 4), (1, 3)]:
+            box = create_box(MPI.COMM_SELF, [np.array([0, 0, z0]), np.array([1, 1, z0 + 1])], [n, n, n],
+                             CellType.tetrahedron)
+            cells.append(box.geometry.dofmap.array.reshape(-1, 4) + offset)
+            points.append(box.geometry.x)
+            offset += box.geometry.x.shape[0]
+        cells = np.vstack(cells).astype(np.int64)
+        points = np.vstack(points)
+    else:
+        cells = np.empty((0, 4), dtype=np.int64)
+        points = np.empty((0, 3), dtype=np.float64)
+    domain = ufl.Mesh(ufl.VectorElement("Lagrange", ufl.tetrahedron, 1))
+    mesh = create_mesh(comm, cells, points, domain)
+
+    tdim = mesh.topology.dim
+    fdim = tdim - 1
+    mesh.topology.create_connectivity(fdim, tdim)
+    f_to_c = mesh.topology.connectivity(fdim, tdim)
+    interface = locate_entities(mesh, fdim, lambda x: np.isclose(x[2], 1))
+    adjacent_cells = np.array([f_to_c.links(f)[0] for f in interface], dtype=np.int32)
+    below = compute_midpoints(mesh, tdim, adjacent_cells)[:, 2] < 1
+    bottom = locate_entities(mesh, fdim, lambda x: np.isclose(x[2], 0))
+    top = locate_entities(mesh, fdim, lambda x: np.isclose(x[2], 2))
+
+    facets = np.hstack([bottom, top, interface])
+    values = np.hstack([np.full(len(bottom), 5, dtype=np.int32), np.full(len(top), 3, dtype=np.int32),
+                        np.where(below, 4, 9).astype(np.int32)])
+    arg_sort = np.argsort(facets)
+    return mesh, meshtags(mesh, fdim, facets[arg_sort], values[arg_sort])
+
+
+def num_global_masters(mpc):
+    masters = mpc.masters
+    num_masters = sum(len(masters.links(slave)) for slave in mpc.slaves[:mpc.num_local_slaves])
+    return mpc.function_space.mesh.comm.allreduce(num_masters, op=MPI.SUM)
+
+
+def test_vertex_masters_contact():
+    mesh, mt = create_tet_boxes(MPI.COMM_WORLD)
+    fdim = mesh.topology.dim - 1
+    V = fem.VectorFunctionSpace(mesh, ("Lagrange", 2))
+
+    # Fixed bottom, and prescribed displacement of the top. With nu=0 the solution is linear in z,
+    # and is represented exactly by both choices of masters
+    g = -0.1
+    u_bottom = fem.Function(V)
+    u_bottom.x.array[:] = 0
+    u_top = fem.Function(V)
+    u_top.interpolate(lambda x: np.vstack([np.zeros(x.shape[1]), np.zeros(x.shape[1]), np.full(x.shape[1], g)]))
+    bcs = [fem.dirichletbc(u_bottom, fem.locate_dofs_topological(V, fdim, mt.find(5))),
+           fem.dirichletbc(u_top, fem.locate_dofs_topological(V, fdim, mt.find(3)))]
+
+    mu = fem.Constant(mesh, PETSc.ScalarType(500))
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    a = fem.form(2 * mu * ufl.inner(ufl.sym(ufl.grad(u)), ufl.grad(v)) * ufl.dx)
+    L = fem.form(ufl.inner(fem.Constant(mesh, PETSc.ScalarType((0, 0, 0))), v) * ufl.dx)
+
+    solutions = []
+    num_masters = []
+    for vertex_masters in [False, True]:
+        mpc = dolfinx_mpc.MultiPointConstraint(V)
+        mpc.create_contact_inelastic_condition(mt, 4, 9, vertex_masters=vertex_masters)
+        mpc.finalize()
+        num_masters.append(num_global_masters(mpc))
+
+        problem = dolfinx_mpc.LinearProblem(a, L, mpc, bcs=bcs,
+                                            petsc_options={"ksp_type": "preonly", "pc_type": "lu"})
+        uh = problem.solve()
+        solutions.append(uh.vector.array.copy())
+
+        # Compare with the exact solution
+        u_ex = fem.Function(mpc.function_space)
+        u_ex.interpolate(lambda x: np.vstack([np.zeros(x.shape[1]), np.zeros(x.shape[1]), g * x[2] / 2]))
+        assert np.allclose(uh.vector.array, u_ex.vector.array, atol=1e-10)
+
+    # Same solution, with fewer masters
+    assert np.allclose(solutions[0], solutions[1], atol=1e-10)
+    assert num_masters[1] < num_masters[0]
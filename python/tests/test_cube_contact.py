@@ -163,7 +163,8 @@ def generate_hex_boxes():
 
 @pytest.mark.parametrize("get_assemblers", ["C++", "numba"], indirect=True)
 @pytest.mark.parametrize("nonslip", [True, False])
-def test_cube_contact(generate_hex_boxes, nonslip, get_assemblers):  # noqa: F811
+@pytest.mark.parametrize("shared_memory", [False, True])
+def test_cube_contact(generate_hex_boxes, nonslip, shared_memory, get_assemblers):  # noqa: F811
     assemble_matrix, assemble_vector = get_assemblers
     comm = MPI.COMM_WORLD
     root = 0
@@ -237,11 +238,11 @@ def test_cube_contact(generate_hex_boxes, nonslip, get_assemblers):  # noqa: F81
     mpc = dolfinx_mpc.MultiPointConstraint(V)
     if nonslip:
         with Timer("~Contact: Create non-elastic constraint"):
-            mpc.create_contact_inelastic_condition(mt, 4, 9)
+            mpc.create_contact_inelastic_condition(mt, 4, 9, shared_memory=shared_memory)
     else:
         with Timer("~Contact: Create contact constraint"):
             nh = dolfinx_mpc.utils.create_normal_approximation(V, mt, 4)
-            mpc.create_contact_slip_condition(mt, 4, 9, nh)
+            mpc.create_contact_slip_condition(mt, 4, 9, nh, shared_memory=shared_memory)
 
     mpc.finalize()
 
@@ -0,0 +1,57 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import fem
+from dolfinx.mesh import create_unit_square
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+@pytest.mark.parametrize("degree", [1, 2])
+def test_dof_classification(periodic_constraint, bottom_bc, degree):
+    mesh = create_unit_square(MPI.COMM_WORLD, 6, 8)
+    V = fem.FunctionSpace(mesh, ("Lagrange", degree))
+    g = fem.Function(V)
+    g.interpolate(lambda x: 1 + x[0])
+    bc = bottom_bc(V, g)
+    mpc = periodic_constraint(V, [bc])
+
+    classification = mpc.create_dof_classification(V, [bc])
+    num_owned = V.dofmap.index_map.size_local
+    assert np.all(np.diff(classification.bc_dofs) > 0)
+    assert np.allclose(np.sort(bc.dof_indices()[0]), classification.bc_dofs)
+    assert classification.num_owned_bc_dofs == np.sum(classification.bc_dofs < num_owned)
+
+    # Cells are flagged if and only if they contain Dirichlet or slave dofs
+    bc_marker = np.zeros(num_owned + V.dofmap.index_map.num_ghosts, dtype=bool)
+    bc_marker[classification.bc_dofs] = True
+    num_cells = mesh.topology.index_map(mesh.topology.dim).size_local
+    for cell in range(num_cells):
+        dofs = V.dofmap.cell_dofs(cell)
+        flag = classification.cell_flags[cell]
+        assert bool(flag & 1) == np.any(bc_marker[dofs])
+        assert bool(flag & 2) == (len(mpc.cell_to_slaves.links(cell)) > 0)
+
+    # Assembly with the classification equals assembly with the conditions
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    a = fem.form(ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx)
+    L = fem.form(ufl.inner(fem.Constant(mesh, PETSc.ScalarType(1)), v) * ufl.dx)
+    A = dolfinx_mpc.assemble_matrix(a, mpc, bcs=[bc])
+    A_c = dolfinx_mpc.assemble_matrix(a, mpc, classification=classification)
+    A_c.axpy(-1, A)
+    assert np.isclose(A_c.norm(PETSc.NormType.FROBENIUS), 0, atol=1e-12)
+
+    b = dolfinx_mpc.assemble_vector(L, mpc)
+    b_c = b.copy()
+    dolfinx_mpc.apply_lifting(b, [a], [[bc]], mpc)
+    dolfinx_mpc.apply_lifting(b_c, [a], [[bc]], mpc, classifications=[classification])
+    b_c.axpy(-1, b)
+    assert np.isclose(b_c.norm(), 0, atol=1e-12)
@@ -0,0 +1,81 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import fem
+from dolfinx.mesh import create_unit_square, locate_entities_boundary, meshtags
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+@pytest.mark.parametrize("degree", [1, 2])
+def test_periodic_identification(degree):
+    mesh = create_unit_square(MPI.COMM_WORLD, 7, 5)
+    V = fem.FunctionSpace(mesh, ("Lagrange", degree))
+
+    def periodic_relation(x):
+        out_x = np.copy(x)
+        out_x[0] = 1 - x[0]
+        return out_x
+
+    facets = locate_entities_boundary(mesh, mesh.topology.dim - 1, lambda x: np.isclose(x[0], 1))
+    arg_sort = np.argsort(facets)
+    mt = meshtags(mesh, mesh.topology.dim - 1, facets[arg_sort], np.full(len(facets), 2, dtype=np.int32))
+
+    def create_forms(W):
+        u = ufl.TrialFunction(W)
+        v = ufl.TestFunction(W)
+        x = ufl.SpatialCoordinate(mesh)
+        f = ufl.sin(2 * ufl.pi * x[0]) * ufl.sin(ufl.pi * x[1])
+        a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx
+        L = ufl.inner(f, v) * ufl.dx
+        return a, L
+
+    petsc_options = {"ksp_type": "preonly", "pc_type": "lu"}
+
+    # Solve problem with identified degrees of freedom
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    mpc.create_periodic_constraint_topological(V, mt, 2, periodic_relation, [], 1)
+    assert mpc.is_dof_identification()
+    W, block_map = mpc.create_identified_space()
+    assert W.dofmap.index_map.size_global < V.dofmap.index_map.size_global
+    a, L = create_forms(W)
+    problem = fem.petsc.LinearProblem(a, L, bcs=[], petsc_options=petsc_options)
+    wh = problem.solve()
+    uh_identified = fem.Function(V)
+    uh_identified.x.array[:] = wh.x.array[block_map]
+
+    # Solve problem with multi point constraint
+    mpc.finalize()
+    a, L = create_forms(V)
+    problem = dolfinx_mpc.LinearProblem(a, L, mpc, bcs=[], petsc_options=petsc_options)
+    uh = problem.solve()
+
+    num_dofs = V.dofmap.index_map.size_local + V.dofmap.index_map.num_ghosts
+    assert np.allclose(uh.x.array[:num_dofs], uh_identified.x.array, atol=1e-10)
+
+
+def test_non_unit_coefficient():
+    mesh = create_unit_square(MPI.COMM_WORLD, 4, 4)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 1))
+
+    def periodic_relation(x):
+        out_x = np.copy(x)
+        out_x[0] = 1 - x[0]
+        return out_x
+
+    facets = locate_entities_boundary(mesh, mesh.topology.dim - 1, lambda x: np.isclose(x[0], 1))
+    arg_sort = np.argsort(facets)
+    mt = meshtags(mesh, mesh.topology.dim - 1, facets[arg_sort], np.full(len(facets), 2, dtype=np.int32))
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    mpc.create_periodic_constraint_topological(V, mt, 2, periodic_relation, [], PETSc.ScalarType(2))
+    assert not mpc.is_dof_identification()
+    with pytest.raises(RuntimeError):
+        mpc.create_identified_space()
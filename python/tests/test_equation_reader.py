@@ -0,0 +1,70 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import dolfinx_mpc.utils
+import numpy as np
+import pytest
+import ufl
+from dolfinx import fem
+from dolfinx.mesh import create_unit_square
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+@pytest.mark.parametrize("file_format", ["csv", "binary"])
+def test_periodic_equations(tmp_path, file_format):
+    comm = MPI.COMM_WORLD
+    mesh = create_unit_square(comm, 5, 7)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 1))
+
+    # Tie each node at x=1 to the node at x=0 with the same y coordinate
+    num_nodes = mesh.geometry.index_map().size_local
+    nodes = np.asarray(mesh.geometry.input_global_indices[:num_nodes], dtype=np.int64)
+    x = mesh.geometry.x[:num_nodes]
+    all_nodes = np.hstack(comm.allgather(nodes))
+    all_x = np.vstack(comm.allgather(x))
+    slave_nodes, master_nodes = [], []
+    for node, coord in zip(all_nodes, all_x):
+        if np.isclose(coord[0], 1):
+            master = np.flatnonzero(np.isclose(all_x[:, 0], 0) & np.isclose(all_x[:, 1], coord[1]))
+            slave_nodes.append(node)
+            master_nodes.append(all_nodes[master[0]])
+
+    filename = comm.bcast(str(tmp_path / f"equations.{file_format}"), root=0)
+    if comm.rank == 0:
+        if file_format == "csv":
+            with open(filename, "w") as f:
+                f.write("# slave_node, slave_component, master_node, master_component, coefficient\n")
+                for slave, master in zip(slave_nodes, master_nodes):
+                    f.write(f"{slave}, 0, {master}, 0, 1.0\n")
+        else:
+            num_equations = len(slave_nodes)
+            dolfinx_mpc.utils.write_constraint_equations(
+                filename, slave_nodes, np.zeros(num_equations), np.arange(num_equations + 1), master_nodes,
+                np.zeros(num_equations), np.ones(num_equations))
+    comm.barrier()
+
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    mpc.create_constraint_from_file(filename, file_format)
+    mpc.finalize()
+
+    def periodic_relation(x):
+        out_x = np.copy(x)
+        out_x[0] = 1 - x[0]
+        return out_x
+    mpc_ref = dolfinx_mpc.MultiPointConstraint(V)
+    mpc_ref.create_periodic_constraint_geometrical(V, lambda x: np.isclose(x[0], 1), periodic_relation, [])
+    mpc_ref.finalize()
+    assert comm.allreduce(mpc.num_local_slaves) == len(slave_nodes)
+    assert comm.allreduce(mpc_ref.num_local_slaves) == len(slave_nodes)
+
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    a = fem.form(ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx)
+    A = dolfinx_mpc.assemble_matrix(a, mpc)
+    A_ref = dolfinx_mpc.assemble_matrix(a, mpc_ref)
+    A.axpy(-1, A_ref, structure=PETSc.Mat.Structure.DIFFERENT_NONZERO_PATTERN)
+    assert np.isclose(A.norm(PETSc.NormType.FROBENIUS), 0, atol=1e-12)
@@ -0,0 +1,71 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import fem
+from dolfinx.mesh import compute_midpoints, create_mesh, locate_entities_boundary
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+def create_hanging_node_mesh():
+    """
+    Create a quadrilateral mesh of [0, 2]x[0, 1] with one coarse cell in [0, 1]x[0, 1] and four fine cells
+    in [1, 2]x[0, 1], with a hanging node at (1, 0.5). Returns the mesh, the parent facet and the child
+    facets on the interface x = 1
+    """
+    points = np.array([[0, 0], [1, 0], [0, 1], [1, 1],
+                       [1, 0.5], [1.5, 0], [1.5, 0.5], [1.5, 1], [2, 0], [2, 0.5], [2, 1]])
+    cells = np.array([[0, 1, 2, 3], [1, 5, 4, 6], [4, 6, 3, 7], [5, 8, 6, 9], [6, 9, 7, 10]], dtype=np.int64)
+    cell = ufl.Cell("quadrilateral", geometric_dimension=2)
+    domain = ufl.Mesh(ufl.VectorElement("Lagrange", cell, 1))
+    mesh = create_mesh(MPI.COMM_SELF, cells, points, domain)
+
+    # The parent facet is the interface facet with a midpoint at (1, 0.5)
+    fdim = mesh.topology.dim - 1
+    facets = locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[0], 1))
+    midpoints = compute_midpoints(mesh, fdim, facets)
+    is_parent = np.isclose(midpoints[:, 1], 0.5)
+    assert np.sum(is_parent) == 1
+    parent = facets[is_parent][0]
+    children = facets[np.invert(is_parent)]
+    return mesh, parent, children
+
+
+@pytest.mark.parametrize("degree", [1, 2, 3])
+def test_hanging_nodes(degree):
+    mesh, parent, children = create_hanging_node_mesh()
+    V = fem.FunctionSpace(mesh, ("Lagrange", degree))
+
+    def u_ex(x):
+        return 1 + 2 * x[0] - 3 * x[1]
+
+    u_bc = fem.Function(V)
+    u_bc.interpolate(u_ex)
+    bc_dofs = fem.locate_dofs_geometrical(
+        V, lambda x: np.isclose(x[0], 0) | np.isclose(x[0], 2) | np.isclose(x[1], 0) | np.isclose(x[1], 1))
+    bc = fem.dirichletbc(u_bc, bc_dofs)
+
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    mpc.create_hanging_node_constraint(np.full(len(children), parent, dtype=np.int32), children, [bc])
+    mpc.finalize()
+    # The hanging vertex and the dofs on the interior of the child edges
+    assert mpc.num_local_slaves == 1 + 2 * (degree - 1)
+
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+    L = ufl.inner(fem.Constant(mesh, PETSc.ScalarType(0)), v) * ufl.dx
+    problem = dolfinx_mpc.LinearProblem(a, L, mpc, bcs=[bc], petsc_options={"ksp_type": "preonly", "pc_type": "lu"})
+    uh = problem.solve()
+
+    # Linear functions are in the constrained space, so the solution is exact
+    u_exact = fem.Function(mpc.function_space)
+    u_exact.interpolate(u_ex)
+    assert np.allclose(uh.x.array, u_exact.x.array, atol=1e-10)
@@ -89,3 +89,53 @@ def test_pipeline(u_from_mpc):
             problem = dolfinx_mpc.LinearProblem(bilinear_form, linear_form, mpc, bcs=[], u=uh,
                                                 petsc_options={"ksp_type": "preonly", "pc_type": "lu"})
             problem.solve()
+
+
+def test_cpp_linear_problem():
+    mesh = create_unit_square(MPI.COMM_WORLD, 6, 7)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 1))
+
+    # Periodic condition in x-direction and homogeneous Dirichlet condition at y=0 and y=1
+    def dirichlet_boundary(x):
+        return np.isclose(x[1], 0) | np.isclose(x[1], 1)
+    bc = fem.dirichletbc(PETSc.ScalarType(0), fem.locate_dofs_geometrical(V, dirichlet_boundary), V)
+
+    def periodic_relation(x):
+        out_x = np.copy(x)
+        out_x[0] = x[0] - 1
+        return out_x
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    mpc.create_periodic_constraint_geometrical(V, lambda x: np.isclose(x[0], 1), periodic_relation, [bc])
+    mpc.finalize()
+
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    x = ufl.SpatialCoordinate(mesh)
+    f = ufl.sin(2 * ufl.pi * x[0]) * x[1]
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+    rhs = ufl.inner(f, v) * ufl.dx
+    petsc_options = {"ksp_type": "preonly", "pc_type": "lu"}
+
+    mpc_problem = dolfinx_mpc.LinearProblem(a, rhs, mpc, bcs=[bc], petsc_options=petsc_options)
+    u_ref = mpc_problem.solve()
+
+    # The C++ problem, with a default (unique) and a user given options prefix
+    cpp_problems = [dolfinx_mpc.cpp.mpc.LinearProblem(fem.form(a), fem.form(rhs), mpc._cpp_object, [bc],
+                                                      petsc_options=petsc_options),
+                    dolfinx_mpc.cpp.mpc.LinearProblem(fem.form(a), fem.form(rhs), mpc._cpp_object, [bc],
+                                                      petsc_options=petsc_options, prefix="cpp_problem_")]
+    prefixes = [p.options_prefix for p in cpp_problems]
+    assert prefixes[0] != prefixes[1]
+    assert prefixes[1] == "cpp_problem_"
+    opts = PETSc.Options()
+    for problem, prefix in zip(cpp_problems, prefixes):
+        assert problem.ksp.getOptionsPrefix() == prefix
+        assert opts.getString(prefix + "ksp_type") == "preonly"
+        uh = problem.solve()
+        assert np.allclose(uh.x.array, u_ref.x.array)
+
+    # The options are removed with the problems
+    del problem, uh, cpp_problems
+    for prefix in prefixes:
+        assert not opts.hasName(prefix + "ksp_type")
+        assert not opts.hasName(prefix + "pc_type")
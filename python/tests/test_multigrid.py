@@ -0,0 +1,88 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import cpp as _cpp
+from dolfinx import fem
+from dolfinx.mesh import create_unit_square
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+def create_periodic_constraint(V):
+    def periodic_boundary(x):
+        return np.isclose(x[0], 1)
+
+    def periodic_relation(x):
+        out_x = np.copy(x)
+        out_x[0] = x[0] - 1
+        return out_x
+
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    mpc.create_periodic_constraint_geometrical(V, periodic_boundary, periodic_relation, [])
+    mpc.finalize()
+    return mpc
+
+
+def create_forms(V):
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    x = ufl.SpatialCoordinate(V.mesh)
+    f = ufl.sin(2 * ufl.pi * x[0]) * x[1]
+    a = fem.form(ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx)
+    L = fem.form(ufl.inner(f, v) * ufl.dx)
+    return a, L
+
+
+@pytest.mark.parametrize("galerkin", [True, False])
+def test_two_level_periodic(galerkin):
+    # Two level (P2 -> P1) multigrid on a single mesh
+    mesh = create_unit_square(MPI.COMM_WORLD, 12, 12)
+    V_c = fem.FunctionSpace(mesh, ("Lagrange", 1))
+    V_f = fem.FunctionSpace(mesh, ("Lagrange", 2))
+    mpc_c = create_periodic_constraint(V_c)
+    mpc_f = create_periodic_constraint(V_f)
+
+    a_f, L_f = create_forms(mpc_f.function_space)
+    A = dolfinx_mpc.assemble_matrix(a_f, mpc_f)
+    b = dolfinx_mpc.assemble_vector(L_f, mpc_f)
+    b.ghostUpdate(addv=PETSc.InsertMode.ADD_VALUES, mode=PETSc.ScatterMode.REVERSE)
+
+    P = _cpp.fem.petsc.interpolation_matrix(V_c._cpp_object, V_f._cpp_object)
+    P.assemble()
+    P_mpc = dolfinx_mpc.create_mpc_prolongation(P, mpc_c, mpc_f)
+
+    ksp = PETSc.KSP().create(mesh.comm)
+    ksp.setOperators(A)
+    ksp.setType(PETSc.KSP.Type.CG)
+    ksp.setTolerances(rtol=1e-10, max_it=50)
+    if galerkin:
+        with pytest.raises(ValueError):
+            dolfinx_mpc.setup_mpc_multigrid(ksp, [P_mpc])
+        dolfinx_mpc.setup_mpc_multigrid(ksp, [P_mpc], constraints=[mpc_c, mpc_f])
+    else:
+        a_c, _ = create_forms(mpc_c.function_space)
+        A_c = dolfinx_mpc.assemble_matrix(a_c, mpc_c)
+        dolfinx_mpc.setup_mpc_multigrid(ksp, [P_mpc], operators=[A_c, A])
+
+    uh = b.copy()
+    uh.set(0)
+    ksp.solve(b, uh)
+    assert ksp.getConvergedReason() > 0
+    assert ksp.getIterationNumber() < 25
+
+    # Compare with a direct solve
+    lu = PETSc.KSP().create(mesh.comm)
+    lu.setOperators(A)
+    lu.setType(PETSc.KSP.Type.PREONLY)
+    lu.getPC().setType(PETSc.PC.Type.LU)
+    u_ref = b.copy()
+    lu.solve(b, u_ref)
+    u_ref.axpy(-1, uh)
+    assert np.isclose(u_ref.norm(), 0, atol=1e-7)
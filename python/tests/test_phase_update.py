@@ -0,0 +1,80 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import fem
+from dolfinx.mesh import create_unit_square
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+def create_bloch_constraint(V, scales):
+    """Periodic constraint in x and y direction, where the corner (1, 1) is mapped to (0, 0) by a separate
+    constraint"""
+
+    def x_slaves(x):
+        return np.isclose(x[0], 1) & ~np.isclose(x[1], 1)
+
+    def x_relation(x):
+        out_x = np.copy(x)
+        out_x[0] = x[0] - 1
+        return out_x
+
+    def y_slaves(x):
+        return np.isclose(x[1], 1) & ~np.isclose(x[0], 0) & ~np.isclose(x[0], 1)
+
+    def y_relation(x):
+        out_x = np.copy(x)
+        out_x[1] = x[1] - 1
+        return out_x
+
+    def corner(x):
+        return np.isclose(x[0], 1) & np.isclose(x[1], 1)
+
+    def corner_relation(x):
+        out_x = np.copy(x)
+        out_x[0] = x[0] - 1
+        out_x[1] = x[1] - 1
+        return out_x
+
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    mpc.create_periodic_constraint_geometrical(V, x_slaves, x_relation, [], PETSc.ScalarType(scales[0]))
+    mpc.create_periodic_constraint_geometrical(V, y_slaves, y_relation, [], PETSc.ScalarType(scales[1]))
+    mpc.create_periodic_constraint_geometrical(V, corner, corner_relation, [], PETSc.ScalarType(scales[2]))
+    return mpc
+
+
+def test_update_phases():
+    mesh = create_unit_square(MPI.COMM_WORLD, 6, 5)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 1))
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    a = fem.form(ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx)
+
+    mpc = create_bloch_constraint(V, [1, 1, 1])
+    mpc.combine_phase_groups(2, [0, 1])
+    mpc.finalize()
+    with pytest.raises(ValueError):
+        mpc.update_phases([1, 1])
+
+    A = dolfinx_mpc.assemble_matrix(a, mpc)
+    for phase_x, phase_y in [(0.5, -2.0), (3.0, 0.25)]:
+        # Update the phases of the constraint and reuse the matrix
+        mpc.update_phases([phase_x, phase_y, 1])
+        A.zeroEntries()
+        dolfinx_mpc.assemble_matrix(a, mpc, A=A)
+        A.assemble()
+
+        # Constraint built from scratch with the phased coefficients, where the corner has the product phase
+        mpc_ref = create_bloch_constraint(V, [phase_x, phase_y, phase_x * phase_y])
+        mpc_ref.finalize()
+        assert np.allclose(mpc.coefficients()[0], mpc_ref.coefficients()[0])
+        A_ref = dolfinx_mpc.assemble_matrix(a, mpc_ref)
+        A_ref.axpy(-1, A)
+        assert np.isclose(A_ref.norm(PETSc.NormType.FROBENIUS), 0, atol=1e-12)
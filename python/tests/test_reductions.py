@@ -0,0 +1,77 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx.cpp
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import fem
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+@pytest.mark.parametrize("norm_type", [dolfinx.cpp.la.Norm.l1, dolfinx.cpp.la.Norm.l2, dolfinx.cpp.la.Norm.linf])
+def test_reductions(periodic_square, norm_type):
+    V, mpc, (bc, ) = periodic_square(7, 6, degree=2, bc_value=0.3)
+    mesh = V.mesh
+
+    # Nonlinear residual and its Jacobian
+    u = fem.Function(mpc.function_space)
+    u.interpolate(lambda x: x[0] * x[1] + x[1]**2)
+    v = ufl.TestFunction(V)
+    x = ufl.SpatialCoordinate(mesh)
+    F = fem.form(ufl.inner((1 + u**2) * ufl.grad(u), ufl.grad(v)) * ufl.dx - ufl.inner(ufl.sin(x[0]), v) * ufl.dx)
+    J = fem.form(ufl.derivative(ufl.inner((1 + u**2) * ufl.grad(u), ufl.grad(v)) * ufl.dx, u, ufl.TrialFunction(V)))
+
+    # Reference residual, assembled step by step
+    b_ref = dolfinx_mpc.assemble_vector(F, mpc)
+    dolfinx_mpc.apply_lifting(b_ref, [J], [[bc]], mpc, x0=[u.vector], scale=-1.0)
+    b_ref.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+    fem.petsc.set_bc(b_ref, [bc], u.vector, -1.0)
+
+    # Reference norm of the owned entries that are not slaves
+    num_owned = V.dofmap.index_map.size_local
+    mask = np.ones(num_owned, dtype=bool)
+    local_slaves = mpc.slaves[:mpc.num_local_slaves]
+    mask[local_slaves] = False
+    values = np.abs(b_ref.array[mask])
+    if norm_type == dolfinx.cpp.la.Norm.linf:
+        reference = mesh.comm.allreduce(values.max(initial=0), op=MPI.MAX)
+    elif norm_type == dolfinx.cpp.la.Norm.l1:
+        reference = mesh.comm.allreduce(values.sum(), op=MPI.SUM)
+    else:
+        reference = np.sqrt(mesh.comm.allreduce(np.sum(values**2), op=MPI.SUM))
+
+    b = b_ref.copy()
+    value = dolfinx_mpc.assemble_residual(F, J, mpc, u.vector, b, bcs=[bc], norm_type=norm_type)
+    assert np.isclose(value, reference)
+    assert np.allclose(b.array, b_ref.array)
+    assert np.isclose(dolfinx_mpc.norm(b, mpc, norm_type), reference)
+
+    # Vectors without ghosts are rejected
+    index_map = mpc.function_space.dofmap.index_map
+    b_no_ghosts = PETSc.Vec().createMPI((index_map.size_local, index_map.size_global), comm=mesh.comm)
+    with pytest.raises(RuntimeError):
+        dolfinx_mpc.assemble_residual(F, J, mpc, u.vector, b_no_ghosts, bcs=[bc], norm_type=norm_type)
+    with pytest.raises(RuntimeError):
+        dolfinx_mpc.assemble_residual(F, J, mpc, b_no_ghosts, b, bcs=[bc], norm_type=norm_type)
+    b_no_ghosts.destroy()
+
+    # Inner product with masked slaves
+    product = dolfinx_mpc.inner_product(b, u.vector, mpc)
+    reference = mesh.comm.allreduce(np.sum(np.conj(b.array[mask]) * u.vector.array[mask]), op=MPI.SUM)
+    assert np.isclose(product, reference)
+
+    # Condensing an unconstrained vector gives the vector assembled with the constraint
+    L = fem.form(ufl.inner(ufl.sin(x[0]) + x[1], v) * ufl.dx)
+    b_full = fem.petsc.assemble_vector(L)
+    b_full.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+    b_mpc = dolfinx_mpc.assemble_vector(L, mpc)
+    b_mpc.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+    assert np.isclose(dolfinx_mpc.norm(b_full, mpc, norm_type, condense=True), dolfinx_mpc.norm(b_mpc, mpc, norm_type))
+    assert np.isclose(dolfinx_mpc.inner_product(b_full, b_full, mpc, condense=True),
+                      dolfinx_mpc.inner_product(b_mpc, b_mpc, mpc))
@@ -0,0 +1,65 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import cpp as _cpp
+from dolfinx import fem
+from dolfinx.mesh import (Mesh, create_unit_square, locate_entities_boundary,
+                          meshtags)
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+def periodic_relation(x):
+    out_x = np.copy(x)
+    out_x[0] = x[0] - 1
+    return out_x
+
+
+@pytest.mark.parametrize("parent_extent", [1.0, 0.5])
+def test_refined_periodic(parent_extent):
+    mesh = create_unit_square(MPI.COMM_WORLD, 4, 4)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 1))
+
+    # Constraint on the parent mesh. If it only covers the lower part of the boundary, the slaves on the
+    # upper part have no candidate cells on the refined mesh and are found by the search over all cells
+    def parent_slaves(x):
+        return np.isclose(x[0], 1) & (x[1] < parent_extent + 1e-10)
+    parent_mpc = dolfinx_mpc.MultiPointConstraint(V)
+    parent_mpc.create_periodic_constraint_geometrical(V, parent_slaves, periodic_relation, [])
+    parent_mpc.finalize()
+
+    # Refine without redistribution, such that the parent cells are local to the process
+    refined, parent_cells, _ = _cpp.refinement.refine_plaza(mesh, False,
+                                                            _cpp.refinement.RefinementOption.parent_cell)
+    refined = Mesh.from_cpp(refined, ufl.Mesh(mesh.ufl_domain().ufl_coordinate_element()))
+    V_fine = fem.FunctionSpace(refined, ("Lagrange", 1))
+    fdim = refined.topology.dim - 1
+    facets = locate_entities_boundary(refined, fdim, lambda x: np.isclose(x[0], 1))
+    mt = meshtags(refined, fdim, facets, np.full(len(facets), 2, dtype=np.int32))
+
+    mpc = dolfinx_mpc.MultiPointConstraint(V_fine)
+    mpc.create_periodic_constraint_refined(V_fine, mt, 2, periodic_relation, [], parent_mpc, parent_cells)
+    mpc.finalize()
+
+    # Constraint built from scratch on the refined mesh
+    mpc_ref = dolfinx_mpc.MultiPointConstraint(V_fine)
+    mpc_ref.create_periodic_constraint_topological(V_fine, mt, 2, periodic_relation, [])
+    mpc_ref.finalize()
+    assert mpc.num_local_slaves == mpc_ref.num_local_slaves
+    num_local = mpc.num_local_slaves
+    assert np.allclose(np.sort(mpc.slaves[:num_local]), np.sort(mpc_ref.slaves[:num_local]))
+
+    u = ufl.TrialFunction(V_fine)
+    v = ufl.TestFunction(V_fine)
+    a = fem.form(ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx)
+    A = dolfinx_mpc.assemble_matrix(a, mpc)
+    A_ref = dolfinx_mpc.assemble_matrix(a, mpc_ref)
+    A_ref.axpy(-1, A)
+    assert np.isclose(A_ref.norm(PETSc.NormType.FROBENIUS), 0, atol=1e-12)
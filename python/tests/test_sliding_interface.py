@@ -0,0 +1,167 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import fem
+from dolfinx.mesh import (compute_midpoints, create_mesh, locate_entities_boundary,
+                          meshtags)
+from mpi4py import MPI
+
+
+def create_annuli(n_rotor: int, n_stator: int):
+    """
+    Create a mesh of a rotor (0.5 < r < 1) and a stator (1 < r < 1.5) with a different number of cells
+    in the angular direction, and duplicated vertices at the interface r = 1
+    """
+    points = []
+    cells = []
+    for (r0, r1, n) in [(0.5, 1, n_rotor), (1, 1.5, n_stator)]:
+        offset = len(points)
+        theta = np.linspace(0, 2 * np.pi, n, endpoint=False)
+        for r in (r0, r1):
+            points.extend(np.vstack([r * np.cos(theta), r * np.sin(theta)]).T)
+        for i in range(n):
+            j = (i + 1) % n
+            cells.append([offset + i, offset + j, offset + n + i])
+            cells.append([offset + j, offset + n + j, offset + n + i])
+    cell = ufl.Cell("triangle", geometric_dimension=2)
+    domain = ufl.Mesh(ufl.VectorElement("Lagrange", cell, 1))
+    mesh = create_mesh(MPI.COMM_SELF, np.array(cells, dtype=np.int64), np.array(points), domain)
+
+    # Tag the interface facets by the side of their cell
+    tdim = mesh.topology.dim
+    fdim = tdim - 1
+    facets = np.sort(locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[0]**2 + x[1]**2, 1)))
+    mesh.topology.create_connectivity(fdim, tdim)
+    f_to_c = mesh.topology.connectivity(fdim, tdim)
+    facet_cells = np.array([f_to_c.links(f)[0] for f in facets], dtype=np.int32)
+    midpoints = compute_midpoints(mesh, tdim, facet_cells)
+    values = np.where(np.linalg.norm(midpoints, axis=1) < 1, 1, 2).astype(np.int32)
+    return mesh, meshtags(mesh, fdim, facets, values)
+
+
+@pytest.mark.parametrize("angle", [0, 0.3, -2.1, 7])
+@pytest.mark.parametrize("element", [("Lagrange", 1), ufl.VectorElement("Lagrange", ufl.triangle, 1)])
+def test_sliding_interface(angle, element):
+    mesh, mt = create_annuli(12, 16)
+    V = fem.FunctionSpace(mesh, element)
+    bs = V.dofmap.index_map_bs
+    interface = dolfinx_mpc.SlidingInterface(V, mt, 1, 2)
+    assert interface.num_master_facets == 16
+
+    mpc_data = interface.create_constraint(angle)
+    x = V.tabulate_dof_coordinates()
+    theta = np.arctan2(x[:, 1], x[:, 0])
+    assert len(mpc_data.slaves) == 12 * bs
+    for i, slave in enumerate(mpc_data.slaves):
+        masters = mpc_data.masters[mpc_data.offsets[i]:mpc_data.offsets[i + 1]]
+        coeffs = mpc_data.coeffs[mpc_data.offsets[i]:mpc_data.offsets[i + 1]]
+        assert np.isclose(np.sum(coeffs), 1)
+        assert np.allclose(masters % bs, slave % bs)
+        assert np.allclose(np.linalg.norm(x[masters // bs], axis=1), 1)
+
+        # The coefficients interpolate the rotated angle of the slave
+        target = theta[slave // bs] + angle
+        diff = np.remainder(theta[masters // bs] - target + np.pi, 2 * np.pi) - np.pi
+        assert np.isclose(np.dot(coeffs, diff), 0, atol=1e-12)
+
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    mpc.create_sliding_interface_constraint(interface, angle)
+    mpc.finalize()
+    assert len(mpc.slaves) == 12 * bs
+
+
+def create_cylinders(comm, n_rotor: int, n_stator: int, nz: int):
+    """
+    Create a tetrahedral mesh of a rotor (0.5 < r < 1) and a stator (1 < r < 1.5) with 0 < z < 1, with a
+    different number of cells in the angular direction, and duplicated vertices at the interface r = 1
+    """
+    if comm.rank == 0:
+        points = []
+        cells = []
+        z = np.linspace(0, 1, nz + 1)
+        for (r0, r1, n) in [(0.5, 1, n_rotor), (1, 1.5, n_stator)]:
+            offset = len(points)
+            theta = np.linspace(0, 2 * np.pi, n, endpoint=False)
+
+            def index(ir, i, k):
+                return offset + k * 2 * n + ir * n + i % n
+            for k in range(nz + 1):
+                for r in (r0, r1):
+                    points.extend(np.vstack([r * np.cos(theta), r * np.sin(theta), np.full(n, z[k])]).T)
+            for k in range(nz):
+                for i in range(n):
+                    for triangle in [[index(0, i, k), index(0, i + 1, k), index(1, i, k)],
+                                     [index(0, i + 1, k), index(1, i + 1, k), index(1, i, k)]]:
+                        # Split the prism into tetrahedra, with the diagonal of each quadrilateral face from
+                        # the bottom of its largest vertex to the top of its smallest vertex
+                        v0, v1, v2 = sorted(triangle)
+                        top = 2 * n
+                        cells.append([v0, v1, v2, v0 + top])
+                        cells.append([v1, v2, v0 + top, v1 + top])
+                        cells.append([v2, v0 + top, v1 + top, v2 + top])
+        cells = np.array(cells, dtype=np.int64)
+        points = np.array(points)
+    else:
+        cells = np.empty((0, 4), dtype=np.int64)
+        points = np.empty((0, 3), dtype=np.float64)
+    domain = ufl.Mesh(ufl.VectorElement("Lagrange", ufl.tetrahedron, 1))
+    mesh = create_mesh(comm, cells, points, domain)
+
+    # Tag the interface facets by the side of their cell
+    tdim = mesh.topology.dim
+    fdim = tdim - 1
+    facets = np.sort(locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[0]**2 + x[1]**2, 1)))
+    mesh.topology.create_connectivity(fdim, tdim)
+    f_to_c = mesh.topology.connectivity(fdim, tdim)
+    facet_cells = np.array([f_to_c.links(f)[0] for f in facets], dtype=np.int32)
+    midpoints = compute_midpoints(mesh, tdim, facet_cells)
+    values = np.where(np.linalg.norm(midpoints[:, :2], axis=1) < 1, 1, 2).astype(np.int32)
+    return mesh, meshtags(mesh, fdim, facets, values)
+
+
+@pytest.mark.parametrize("angle", [0, 0.3, -2.1])
+def test_sliding_interface_3D(angle):
+    comm = MPI.COMM_WORLD
+    n_rotor, n_stator, nz = 12, 16, 3
+    mesh, mt = create_cylinders(comm, n_rotor, n_stator, nz)
+    V = fem.VectorFunctionSpace(mesh, ("Lagrange", 1))
+    bs = V.dofmap.index_map_bs
+    interface = dolfinx_mpc.SlidingInterface(V, mt, 1, 2, origin=(0, 0, 0), axis=(0, 0, 1))
+    assert interface.num_master_facets == 2 * n_stator * nz
+
+    # Coordinates of all blocks, by global index
+    index_map = V.dofmap.index_map
+    size_local = index_map.size_local
+    x = V.tabulate_dof_coordinates()
+    global_x = np.vstack(comm.allgather(x[:size_local]))
+    assert global_x.shape[0] == index_map.size_global
+
+    mpc_data = interface.create_constraint(angle)
+    slaves = np.asarray(mpc_data.slaves)
+    assert comm.allreduce(np.count_nonzero(slaves < bs * size_local), op=MPI.SUM) == n_rotor * (nz + 1) * bs
+    for i, slave in enumerate(slaves):
+        masters = np.asarray(mpc_data.masters[mpc_data.offsets[i]:mpc_data.offsets[i + 1]])
+        coeffs = mpc_data.coeffs[mpc_data.offsets[i]:mpc_data.offsets[i + 1]]
+        assert np.isclose(np.sum(coeffs), 1)
+        assert np.allclose(masters % bs, slave % bs)
+        x_masters = global_x[masters // bs]
+        assert np.allclose(np.linalg.norm(x_masters[:, :2], axis=1), 1)
+
+        # The coefficients interpolate the axial position and the rotated angle of the slave
+        x_slave = x[slave // bs]
+        assert np.isclose(np.dot(coeffs, x_masters[:, 2]), x_slave[2])
+        target = np.arctan2(x_slave[1], x_slave[0]) + angle
+        diff = np.remainder(np.arctan2(x_masters[:, 1], x_masters[:, 0]) - target + np.pi, 2 * np.pi) - np.pi
+        assert np.isclose(np.dot(coeffs, diff), 0, atol=1e-12)
+
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    mpc.create_sliding_interface_constraint(interface, angle)
+    mpc.finalize()
+    assert comm.allreduce(mpc.num_local_slaves, op=MPI.SUM) == n_rotor * (nz + 1) * bs
@@ -0,0 +1,68 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import dolfinx_mpc.utils
+import numpy as np
+import ufl
+from dolfinx import fem
+from dolfinx.mesh import create_unit_square, locate_entities_boundary, meshtags
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+def test_axis_aligned_slip():
+    N = 8
+    mesh = create_unit_square(MPI.COMM_WORLD, N, N)
+    V = fem.VectorFunctionSpace(mesh, ("Lagrange", 1))
+    fdim = mesh.topology.dim - 1
+
+    # Slip on the bottom and right boundary, inflow on the left boundary
+    slip_facets = locate_entities_boundary(mesh, fdim, lambda x: np.isclose(x[1], 0) | np.isclose(x[0], 1))
+    mt = meshtags(mesh, fdim, np.sort(slip_facets), np.full(len(slip_facets), 1, dtype=np.int32))
+    inlet_dofs = fem.locate_dofs_geometrical(V, lambda x: np.isclose(x[0], 0))
+    inlet = fem.Function(V)
+    inlet.interpolate(lambda x: np.vstack((np.ones_like(x[0]), np.zeros_like(x[0]))))
+    bc = fem.dirichletbc(inlet, inlet_dofs)
+    n = dolfinx_mpc.utils.create_normal_approximation(V, mt, 1)
+
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    x = ufl.SpatialCoordinate(mesh)
+    a = ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx
+    L = ufl.inner(ufl.as_vector((x[1], x[0])), v) * ufl.dx
+    petsc_options = {"ksp_type": "preonly", "pc_type": "lu"}
+
+    # Slip condition imposed by constraints only
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    assert mpc.create_slip_constraint(V, (mt, 1), n, bcs=[bc]) == []
+    mpc.finalize()
+    uh = dolfinx_mpc.LinearProblem(a, L, mpc, bcs=[bc], petsc_options=petsc_options).solve()
+
+    # Axis-aligned blocks degenerate to component-wise Dirichlet conditions
+    mpc_d = dolfinx_mpc.MultiPointConstraint(V)
+    slip_bcs = mpc_d.create_slip_constraint(V, (mt, 1), n, bcs=[bc], dirichlet_tol=1e-10)
+    mpc_d.finalize()
+    assert len(slip_bcs) == mesh.geometry.dim
+    uh_d = dolfinx_mpc.LinearProblem(a, L, mpc_d, bcs=[bc] + slip_bcs, petsc_options=petsc_options).solve()
+
+    # The left boundary is in the inflow condition. The right boundary (except the corner (1, 0), which has an
+    # oblique normal) is aligned with the x-axis, the bottom boundary with the y-axis
+    num_owned = V.dofmap.index_map.size_local * V.dofmap.index_map_bs
+    num_dirichlet = [mesh.comm.allreduce(np.count_nonzero(slip_bc.dof_indices()[0] < num_owned), op=MPI.SUM)
+                     for slip_bc in slip_bcs]
+    assert num_dirichlet == [N, N - 1]
+    num_slaves = mesh.comm.allreduce(mpc.num_local_slaves, op=MPI.SUM)
+    num_slaves_d = mesh.comm.allreduce(mpc_d.num_local_slaves, op=MPI.SUM)
+    assert num_slaves == 2 * N
+    assert num_slaves_d == 1
+
+    # Both formulations give the same solution
+    assert np.allclose(uh.x.array, uh_d.x.array, atol=1e-10)
+    with uh_d.vector.localForm() as u_local:
+        for slip_bc in slip_bcs:
+            dofs = slip_bc.dof_indices()[0]
+            assert np.allclose(u_local.array[dofs], PETSc.ScalarType(0))
@@ -0,0 +1,61 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import pytest
+import ufl
+from dolfinx import fem
+from dolfinx.mesh import create_unit_square
+from mpi4py import MPI
+from petsc4py import PETSc
+
+
+@pytest.mark.parametrize("degree", [1, 2])
+def test_sparsity_estimate(periodic_constraint, degree):
+    mesh = create_unit_square(MPI.COMM_WORLD, 5, 7)
+    V = fem.FunctionSpace(mesh, ("Lagrange", degree))
+    mpc = periodic_constraint(V)
+
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    a = fem.form(ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx)
+    estimate = dolfinx_mpc.estimate_sparsity(a, mpc)
+    assert estimate.num_rows == mpc.function_space.dofmap.index_map.size_global
+    assert estimate.master_nonzeros > 0
+    assert estimate.nonzeros_per_row_min <= estimate.nonzeros_per_row_mean <= estimate.nonzeros_per_row_max
+    assert estimate.memory > 0
+
+    # The estimate is exact in serial, and an upper bound in parallel
+    A = dolfinx_mpc.assemble_matrix(a, mpc)
+    nonzeros = A.getInfo(PETSc.Mat.InfoType.GLOBAL_SUM)["nz_allocated"]
+    if MPI.COMM_WORLD.size == 1:
+        assert estimate.nonzeros == nonzeros
+    else:
+        assert estimate.nonzeros >= nonzeros
+
+
+def test_sparsity_estimate_interior_facets(periodic_constraint):
+    mesh = create_unit_square(MPI.COMM_WORLD, 6, 4)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 1))
+    mpc = periodic_constraint(V)
+
+    # Interior facet integrals couple the dofs of neighbouring cells
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    a_dx = fem.form(ufl.inner(u, v) * ufl.dx)
+    a_dS = fem.form(ufl.inner(u, v) * ufl.dx + ufl.inner(ufl.avg(u), ufl.avg(v)) * ufl.dS)
+    estimate_dx = dolfinx_mpc.estimate_sparsity(a_dx, mpc)
+    estimate = dolfinx_mpc.estimate_sparsity(a_dS, mpc)
+    assert estimate.nonzeros > estimate_dx.nonzeros
+
+    # The estimate is exact in serial, and an upper bound in parallel
+    pattern = dolfinx_mpc.create_sparsity_pattern(a_dS, mpc)
+    pattern.assemble()
+    nonzeros = MPI.COMM_WORLD.allreduce(pattern.num_nonzeros, op=MPI.SUM)
+    if MPI.COMM_WORLD.size == 1:
+        assert estimate.nonzeros == nonzeros
+    else:
+        assert estimate.nonzeros >= nonzeros
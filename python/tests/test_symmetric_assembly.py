@@ -0,0 +1,31 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import fem
+from petsc4py import PETSc
+
+
+@pytest.mark.parametrize("vector", [False, True])
+@pytest.mark.parametrize("degree", [1, 2])
+def test_symmetric_periodic(periodic_square, vector, degree):
+    V, mpc, (bc, ) = periodic_square(7, 5, degree, vector=vector, scale=0.5)
+
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    a = fem.form(ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx + ufl.inner(u, v) * ufl.dx)
+    A = dolfinx_mpc.assemble_matrix(a, mpc, bcs=[bc])
+    A_sym = dolfinx_mpc.assemble_matrix(a, mpc, bcs=[bc], symmetric=True)
+    assert A_sym.getType().endswith("sbaij")
+    assert A_sym.isSymmetric()
+    assert A_sym.getInfo()["nz_used"] < A.getInfo()["nz_used"]
+
+    A_full = A_sym.convert("aij")
+    A_full.axpy(-1, A, structure=PETSc.Mat.Structure.DIFFERENT_NONZERO_PATTERN)
+    assert np.isclose(A_full.norm(PETSc.NormType.FROBENIUS), 0, atol=1e-12)
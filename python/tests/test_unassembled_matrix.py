@@ -0,0 +1,52 @@
+# Copyright (C) 2022 Jørgen S. Dokken
+#
+# This file is part of DOLFINX_MPC
+#
+# SPDX-License-Identifier:    MIT
+
+import dolfinx_mpc
+import numpy as np
+import pytest
+import ufl
+from dolfinx import fem
+from petsc4py import PETSc
+
+
+@pytest.mark.parametrize("degree", [1, 2])
+def test_matis_periodic(periodic_square, degree):
+    V, mpc, (bc, ) = periodic_square(9, 6, degree)
+    mesh = V.mesh
+
+    u = ufl.TrialFunction(V)
+    v = ufl.TestFunction(V)
+    x = ufl.SpatialCoordinate(mesh)
+    a = fem.form(ufl.inner(ufl.grad(u), ufl.grad(v)) * ufl.dx)
+    L = fem.form(ufl.inner(ufl.sin(2 * ufl.pi * x[0]) * x[1], v) * ufl.dx)
+
+    A = dolfinx_mpc.assemble_matrix(a, mpc, bcs=[bc])
+    A_is = dolfinx_mpc.create_unassembled_matrix(a, mpc)
+    assert A_is.getType() == "is"
+    dolfinx_mpc.assemble_matrix(a, mpc, bcs=[bc], A=A_is)
+
+    A_aij = A_is.convert("aij")
+    A_aij.axpy(-1, A, structure=PETSc.Mat.Structure.DIFFERENT_NONZERO_PATTERN)
+    assert np.isclose(A_aij.norm(PETSc.NormType.FROBENIUS), 0, atol=1e-12)
+
+    # Solve with BDDC and compare with a direct solver
+    b = dolfinx_mpc.assemble_vector(L, mpc)
+    dolfinx_mpc.apply_lifting(b, [a], [[bc]], mpc)
+    b.ghostUpdate(addv=PETSc.InsertMode.ADD_VALUES, mode=PETSc.ScatterMode.REVERSE)
+    fem.petsc.set_bc(b, [bc])
+    solutions = []
+    for matrix, pc_type in [(A, "lu"), (A_is, "bddc")]:
+        ksp = PETSc.KSP().create(mesh.comm)
+        ksp.setOperators(matrix)
+        ksp.setType("preonly" if pc_type == "lu" else "cg")
+        ksp.getPC().setType(pc_type)
+        ksp.setTolerances(rtol=1e-12)
+        uh = b.copy()
+        ksp.solve(b, uh)
+        solutions.append(uh)
+        ksp.destroy()
+    solutions[1].axpy(-1, solutions[0])
+    assert np.isclose(solutions[1].norm(), 0, atol=1e-8)
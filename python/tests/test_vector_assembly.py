@@ -57,3 +57,33 @@ def test_mpc_assembly(master_point, degree, celltype, get_assemblers):  # noqa:
         dolfinx_mpc.utils.compare_mpc_rhs(L_org, b, mpc, root=root)
 
     list_timings(comm, [TimingType.wall])
+
+
+@pytest.mark.parametrize("degree", range(1, 3))
+def test_accumulate_ghosts(degree):
+    mesh = create_unit_square(MPI.COMM_WORLD, 6, 5)
+    V = fem.FunctionSpace(mesh, ("Lagrange", degree))
+    v = ufl.TestFunction(V)
+    x = ufl.SpatialCoordinate(mesh)
+    linear_form = fem.form(ufl.inner(ufl.sin(x[0]) * x[1], v) * ufl.dx + ufl.inner(x[0], v) * ufl.ds)
+
+    def l2b(li):
+        return np.array(li, dtype=np.float64).tobytes()
+    s_m_c = {l2b([1, 0]): {l2b([0, 1]): 0.43, l2b([1, 1]): 0.11},
+             l2b([0, 0]): {l2b([1, 1]): 0.69}}
+    mpc = dolfinx_mpc.MultiPointConstraint(V)
+    mpc.create_general_constraint(s_m_c)
+    mpc.finalize()
+
+    # Overlapped ghost accumulation gives the same owned entries as a separate reverse update
+    b = dolfinx_mpc.assemble_vector(linear_form, mpc)
+    b.ghostUpdate(addv=PETSc.InsertMode.ADD_VALUES, mode=PETSc.ScatterMode.REVERSE)
+    b_overlap = dolfinx_mpc.assemble_vector(linear_form, mpc, accumulate_ghosts=True)
+    assert np.allclose(b_overlap.array, b.array)
+
+    # A vector without ghosts is rejected
+    index_map = mpc.function_space.dofmap.index_map
+    b_no_ghosts = PETSc.Vec().createMPI((index_map.size_local, index_map.size_global), comm=mesh.comm)
+    with pytest.raises(RuntimeError):
+        dolfinx_mpc.cpp.mpc.assemble_vector_ghosted(b_no_ghosts, linear_form, mpc._cpp_object)
+    b_no_ghosts.destroy()